@@ -0,0 +1,260 @@
+#include "allocator.h"
+#include "../dep/imgui/imgui.h"
+#include <cstdlib>
+#include <algorithm>
+#include <new>
+
+static void* heap_alloc(size_t size) {
+    return std::malloc(size);
+}
+
+static void heap_free(void* ptr) {
+    std::free(ptr);
+}
+
+namespace {
+    thread_local bool t_tracking = false;
+    thread_local uint64_t t_allocation_count = 0;
+    thread_local uint64_t t_allocated_bytes = 0;
+}
+
+void c_allocation_tracker::attach_current_thread() {
+    t_tracking = true;
+}
+
+void c_allocation_tracker::detach_current_thread() {
+    t_tracking = false;
+}
+
+bool c_allocation_tracker::current_thread_attached() {
+    return t_tracking;
+}
+
+void c_allocation_tracker::note_allocation(size_t size) {
+    if (!t_tracking) {
+        return;
+    }
+    t_allocation_count++;
+    t_allocated_bytes += size;
+}
+
+uint64_t c_allocation_tracker::allocation_count() {
+    return t_allocation_count;
+}
+
+uint64_t c_allocation_tracker::allocated_bytes() {
+    return t_allocated_bytes;
+}
+
+#ifdef LOADER_UI_TRACK_ALLOCATIONS
+void* operator new(size_t size) {
+    c_allocation_tracker::note_allocation(size);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    c_allocation_tracker::note_allocation(size);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    c_allocation_tracker::note_allocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    c_allocation_tracker::note_allocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+#endif
+
+c_size_class_pool::~c_size_class_pool() {
+    release();
+}
+
+size_t c_size_class_pool::class_index(size_t size) {
+    size_t index = 0;
+    size_t block = kMinClassSize;
+    while (block < size) {
+        block <<= 1;
+        ++index;
+    }
+    return index;
+}
+
+bool c_size_class_pool::refill(size_t index) {
+    const size_t stride = sizeof(block_header) + class_size(index);
+    const size_t count = std::max<size_t>(1, kChunkSize / stride);
+    const size_t chunk_bytes = stride * count;
+
+    auto* chunk = static_cast<unsigned char*>(heap_alloc(chunk_bytes));
+    if (!chunk) {
+        return false;
+    }
+    chunks_.push_back(chunk);
+    reserved_bytes_ += chunk_bytes;
+    if (owner_) {
+        owner_->note_heap(chunk_bytes);
+    }
+
+    for (size_t i = count; i-- > 0;) {
+        auto* header = reinterpret_cast<block_header*>(chunk + i * stride);
+        header->size_class = static_cast<uint32_t>(index);
+        header->reserved = 0;
+        header->size = 0;
+        auto* node = reinterpret_cast<free_node*>(header + 1);
+        node->next = free_lists_[index];
+        free_lists_[index] = node;
+    }
+    return true;
+}
+
+void* c_size_class_pool::allocate(size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+
+    if (size > class_size(kClassCount - 1)) {
+        auto* header = static_cast<block_header*>(heap_alloc(sizeof(block_header) + size));
+        if (!header) {
+            return nullptr;
+        }
+        header->size_class = kLargeClass;
+        header->reserved = 0;
+        header->size = size;
+        live_bytes_ += size;
+        if (owner_) {
+            owner_->note_heap(size);
+        }
+        return header + 1;
+    }
+
+    const size_t index = class_index(size);
+    if (!free_lists_[index] && !refill(index)) {
+        return nullptr;
+    }
+
+    free_node* node = free_lists_[index];
+    free_lists_[index] = node->next;
+
+    auto* header = reinterpret_cast<block_header*>(node) - 1;
+    header->size = size;
+    live_bytes_ += size;
+    if (owner_) {
+        owner_->current_.pool_allocations++;
+    }
+    return node;
+}
+
+void c_size_class_pool::deallocate(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    auto* header = static_cast<block_header*>(ptr) - 1;
+    live_bytes_ -= header->size;
+
+    if (header->size_class == kLargeClass) {
+        heap_free(header);
+        return;
+    }
+
+    auto* node = static_cast<free_node*>(ptr);
+    node->next = free_lists_[header->size_class];
+    free_lists_[header->size_class] = node;
+}
+
+void c_size_class_pool::release() {
+    for (unsigned char* chunk : chunks_) {
+        heap_free(chunk);
+    }
+    chunks_.clear();
+    free_lists_.fill(nullptr);
+    reserved_bytes_ = 0;
+    live_bytes_ = 0;
+}
+
+c_ui_allocator::c_ui_allocator() {
+    pool_.owner_ = this;
+}
+
+c_ui_allocator::~c_ui_allocator() {
+    uninstall();
+}
+
+void c_ui_allocator::install() {
+    if (installed_) {
+        return;
+    }
+
+    // Must run before ImGui::CreateContext so every block ImGui frees came from us.
+    ImGui::SetAllocatorFunctions(&c_ui_allocator::imgui_alloc, &c_ui_allocator::imgui_free, this);
+    installed_ = true;
+}
+
+void c_ui_allocator::uninstall() {
+    if (!installed_) {
+        return;
+    }
+
+    ImGuiMemAllocFunc alloc_func = nullptr;
+    ImGuiMemFreeFunc free_func = nullptr;
+    void* user_data = nullptr;
+    ImGui::GetAllocatorFunctions(&alloc_func, &free_func, &user_data);
+    if (user_data == this) {
+        ImGui::SetAllocatorFunctions(
+            [](size_t size, void*) { return heap_alloc(size); },
+            [](void* ptr, void*) { heap_free(ptr); });
+    }
+
+    pool_.release();
+    installed_ = false;
+}
+
+void c_ui_allocator::begin_frame() {
+    const uint64_t tracked_count = c_allocation_tracker::allocation_count();
+    const uint64_t tracked_bytes = c_allocation_tracker::allocated_bytes();
+    current_.operator_new_count = static_cast<size_t>(tracked_count - tracked_count_at_frame_start_);
+    current_.operator_new_bytes = static_cast<size_t>(tracked_bytes - tracked_bytes_at_frame_start_);
+    tracked_count_at_frame_start_ = tracked_count;
+    tracked_bytes_at_frame_start_ = tracked_bytes;
+
+    last_frame_ = current_;
+    current_ = allocator_frame_stats{};
+    current_.frame = last_frame_.frame + 1;
+}
+
+void c_ui_allocator::note_heap(size_t bytes) {
+    current_.heap_allocations++;
+    current_.heap_bytes += bytes;
+}
+
+void* c_ui_allocator::imgui_alloc(size_t size, void* user_data) {
+    auto* self = static_cast<c_ui_allocator*>(user_data);
+    self->current_.allocation_count++;
+    self->current_.bytes_allocated += size;
+    return self->pool_.allocate(size);
+}
+
+void c_ui_allocator::imgui_free(void* ptr, void* user_data) {
+    if (!ptr) {
+        return;
+    }
+
+    auto* self = static_cast<c_ui_allocator*>(user_data);
+    self->current_.free_count++;
+    self->pool_.deallocate(ptr);
+}
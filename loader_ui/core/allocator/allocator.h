@@ -0,0 +1,132 @@
+#ifndef ALLOCATOR_HPP
+#define ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+
+class c_ui_allocator;
+
+struct allocator_frame_stats {
+    uint64_t frame = 0;
+    size_t allocation_count = 0;
+    size_t free_count = 0;
+    size_t bytes_allocated = 0;
+    size_t pool_allocations = 0;
+    // Requests that reached the general heap: pool refills and oversized blocks.
+    size_t heap_allocations = 0;
+    size_t heap_bytes = 0;
+    // Global operator new calls made by the tracked thread (LOADER_UI_TRACK_ALLOCATIONS builds).
+    size_t operator_new_count = 0;
+    size_t operator_new_bytes = 0;
+};
+
+// Counts global operator new calls made by threads that attached themselves. The
+// replacement operators are only compiled with LOADER_UI_TRACK_ALLOCATIONS; otherwise
+// the counters stay at zero and compiled() reports false.
+class c_allocation_tracker {
+public:
+    static constexpr bool compiled() {
+#ifdef LOADER_UI_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static void attach_current_thread();
+    static void detach_current_thread();
+    static bool current_thread_attached();
+
+    static void note_allocation(size_t size);
+    static uint64_t allocation_count();
+    static uint64_t allocated_bytes();
+};
+
+// Size-class free lists for long-lived ImGui buffers (ImVector storage, draw lists,
+// window state). Blocks carry a small header recording their class so that
+// ImGui::MemFree, which does not pass a size, can route them back.
+class c_size_class_pool {
+public:
+    static constexpr size_t kMinClassSize = 16;
+    static constexpr size_t kClassCount = 9;          // 16 B .. 4 KiB
+    static constexpr size_t kChunkSize = 64 * 1024;
+    static constexpr uint32_t kLargeClass = 0xFFFFFFFFu;
+
+    c_size_class_pool() = default;
+    ~c_size_class_pool();
+
+    c_size_class_pool(const c_size_class_pool&) = delete;
+    c_size_class_pool& operator=(const c_size_class_pool&) = delete;
+
+    void* allocate(size_t size);
+    void deallocate(void* ptr);
+    void release();
+
+    size_t reserved_bytes() const { return reserved_bytes_; }
+    size_t live_bytes() const { return live_bytes_; }
+
+private:
+    struct free_node {
+        free_node* next;
+    };
+
+    struct alignas(16) block_header {
+        uint32_t size_class;
+        uint32_t reserved;
+        size_t size;
+    };
+
+    static size_t class_index(size_t size);
+    static size_t class_size(size_t index) { return kMinClassSize << index; }
+    bool refill(size_t index);
+
+    std::array<free_node*, kClassCount> free_lists_{};
+    std::vector<unsigned char*> chunks_;
+    size_t reserved_bytes_ = 0;
+    size_t live_bytes_ = 0;
+
+    friend class c_ui_allocator;
+    c_ui_allocator* owner_ = nullptr;
+};
+
+// Allocator subsystem installed into Dear ImGui through ImGui::SetAllocatorFunctions.
+// Not thread-safe: ImGui only allocates from the thread that owns the context.
+class c_ui_allocator {
+public:
+    c_ui_allocator();
+    ~c_ui_allocator();
+
+    c_ui_allocator(const c_ui_allocator&) = delete;
+    c_ui_allocator& operator=(const c_ui_allocator&) = delete;
+
+    void install();
+    void uninstall();
+    bool installed() const { return installed_; }
+
+    // Closes the statistics of the previous frame.
+    void begin_frame();
+
+    const allocator_frame_stats& last_frame_stats() const { return last_frame_; }
+    const allocator_frame_stats& current_frame_stats() const { return current_; }
+    size_t pool_reserved_bytes() const { return pool_.reserved_bytes(); }
+    size_t pool_live_bytes() const { return pool_.live_bytes(); }
+
+private:
+    static void* imgui_alloc(size_t size, void* user_data);
+    static void imgui_free(void* ptr, void* user_data);
+
+    void note_heap(size_t bytes);
+
+    c_size_class_pool pool_;
+    uint64_t tracked_count_at_frame_start_ = 0;
+    uint64_t tracked_bytes_at_frame_start_ = 0;
+    allocator_frame_stats current_{};
+    allocator_frame_stats last_frame_{};
+    bool installed_ = false;
+
+    friend class c_size_class_pool;
+};
+
+#endif // ALLOCATOR_HPP
@@ -0,0 +1,212 @@
+#include "damage_tracker.h"
+#include "../frame_hash/frame_hash.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+    bool is_empty(const damage_rect& r) {
+        return r.x0 >= r.x1 || r.y0 >= r.y1;
+    }
+
+    int64_t area(const damage_rect& r) {
+        return is_empty(r) ? 0 : static_cast<int64_t>(r.x1 - r.x0) * (r.y1 - r.y0);
+    }
+
+    damage_rect united(const damage_rect& a, const damage_rect& b) {
+        return { std::min(a.x0, b.x0), std::min(a.y0, b.y0), std::max(a.x1, b.x1), std::max(a.y1, b.y1) };
+    }
+
+    bool overlaps(const damage_rect& a, const damage_rect& b) {
+        return a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+    }
+
+    bool same_rect(const damage_rect& a, const damage_rect& b) {
+        return a.x0 == b.x0 && a.y0 == b.y0 && a.x1 == b.x1 && a.y1 == b.y1;
+    }
+
+    // Pixels whose centers the list can touch: vertex bounds limited to its clip rects.
+    damage_rect list_bounds(const ImDrawList* list, const ImVec2& offset, const ImVec2& scale, int width, int height) {
+        if (list->VtxBuffer.Size == 0) {
+            return {};
+        }
+
+        ImVec2 vmin(FLT_MAX, FLT_MAX);
+        ImVec2 vmax(-FLT_MAX, -FLT_MAX);
+        for (const ImDrawVert& v : list->VtxBuffer) {
+            vmin.x = std::min(vmin.x, v.pos.x);
+            vmin.y = std::min(vmin.y, v.pos.y);
+            vmax.x = std::max(vmax.x, v.pos.x);
+            vmax.y = std::max(vmax.y, v.pos.y);
+        }
+
+        ImVec2 cmin(FLT_MAX, FLT_MAX);
+        ImVec2 cmax(-FLT_MAX, -FLT_MAX);
+        for (const ImDrawCmd& cmd : list->CmdBuffer) {
+            if (cmd.ElemCount == 0) {
+                continue;
+            }
+            cmin.x = std::min(cmin.x, cmd.ClipRect.x);
+            cmin.y = std::min(cmin.y, cmd.ClipRect.y);
+            cmax.x = std::max(cmax.x, cmd.ClipRect.z);
+            cmax.y = std::max(cmax.y, cmd.ClipRect.w);
+        }
+
+        const float x0 = (std::max(vmin.x, cmin.x) - offset.x) * scale.x;
+        const float y0 = (std::max(vmin.y, cmin.y) - offset.y) * scale.y;
+        const float x1 = (std::min(vmax.x, cmax.x) - offset.x) * scale.x;
+        const float y1 = (std::min(vmax.y, cmax.y) - offset.y) * scale.y;
+        if (!(x0 < x1 && y0 < y1)) {
+            return {};
+        }
+
+        damage_rect r;
+        r.x0 = std::max(0, static_cast<int>(std::floor(x0)));
+        r.y0 = std::max(0, static_cast<int>(std::floor(y0)));
+        r.x1 = std::min(width, static_cast<int>(std::ceil(x1)) + 1);
+        r.y1 = std::min(height, static_cast<int>(std::ceil(y1)) + 1);
+        return r;
+    }
+}
+
+void c_damage_tracker::add_damage(const damage_rect& rect) {
+    if (!is_empty(rect)) {
+        rects_.push_back(rect);
+    }
+}
+
+void c_damage_tracker::update(const ImDrawData* draw_data) {
+    rects_.clear();
+    current_.clear();
+
+    const ImVec2 scale = draw_data ? draw_data->FramebufferScale : ImVec2(1.0f, 1.0f);
+    const int width = draw_data ? static_cast<int>(draw_data->DisplaySize.x * scale.x) : 0;
+    const int height = draw_data ? static_cast<int>(draw_data->DisplaySize.y * scale.y) : 0;
+    if (width <= 0 || height <= 0) {
+        previous_.clear();
+        valid_ = false;
+        full_ = true;
+        stats_ = damage_stats{};
+        return;
+    }
+
+    bool full = !valid_ || width != width_ || height != height_
+        || display_pos_.x != draw_data->DisplayPos.x || display_pos_.y != draw_data->DisplayPos.y;
+
+    c_frame_hasher hasher;
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        const ImDrawList* list = draw_data->CmdLists[n];
+        // The index is the z-order: a list drawn at another position no longer matches.
+        hasher.begin(static_cast<uint64_t>(n));
+        hasher.add_draw_list(list);
+        if (!hasher.reliable()) {
+            full = true;
+        }
+        current_.push_back({ list, hasher.value(), list_bounds(list, draw_data->DisplayPos, scale, width, height) });
+    }
+
+    if (!full) {
+        for (const list_state& now : current_) {
+            auto before = std::find_if(previous_.begin(), previous_.end(),
+                [&](const list_state& s) { return s.list == now.list; });
+            if (before == previous_.end()) {
+                add_damage(now.bounds);
+                continue;
+            }
+            if (before->hash != now.hash || !same_rect(before->bounds, now.bounds)) {
+                add_damage(before->bounds);
+                add_damage(now.bounds);
+            }
+        }
+        for (const list_state& before : previous_) {
+            auto now = std::find_if(current_.begin(), current_.end(),
+                [&](const list_state& s) { return s.list == before.list; });
+            if (now == current_.end()) {
+                add_damage(before.bounds);
+            }
+        }
+
+        merge_rects();
+
+        int64_t dirty = 0;
+        for (const damage_rect& r : rects_) {
+            dirty += area(r);
+        }
+        if (dirty > static_cast<int64_t>(kFullRedrawThreshold * static_cast<float>(width) * static_cast<float>(height))) {
+            full = true;
+        }
+    }
+
+    if (full) {
+        rects_.clear();
+    }
+
+    std::swap(previous_, current_);
+    width_ = width;
+    height_ = height;
+    display_pos_ = draw_data->DisplayPos;
+    valid_ = true;
+    full_ = full;
+
+    stats_.full = full;
+    stats_.rect_count = full ? 1 : static_cast<int>(rects_.size());
+    stats_.total_pixels = static_cast<int64_t>(width) * height;
+    stats_.dirty_pixels = 0;
+    if (full) {
+        stats_.dirty_pixels = stats_.total_pixels;
+    }
+    else {
+        for (const damage_rect& r : rects_) {
+            stats_.dirty_pixels += area(r);
+        }
+    }
+}
+
+void c_damage_tracker::merge_rects() {
+    // Overlapping rects would be drawn twice; fold them together first.
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < rects_.size() && !merged; i++) {
+            for (size_t j = i + 1; j < rects_.size(); j++) {
+                if (overlaps(rects_[i], rects_[j])) {
+                    rects_[i] = united(rects_[i], rects_[j]);
+                    rects_.erase(rects_.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Then merge the pair that grows the covered area least until the budget fits.
+    while (rects_.size() > static_cast<size_t>(kMaxRects)) {
+        size_t best_i = 0;
+        size_t best_j = 1;
+        int64_t best_growth = INT64_MAX;
+        for (size_t i = 0; i < rects_.size(); i++) {
+            for (size_t j = i + 1; j < rects_.size(); j++) {
+                const int64_t growth = area(united(rects_[i], rects_[j])) - area(rects_[i]) - area(rects_[j]);
+                if (growth < best_growth) {
+                    best_growth = growth;
+                    best_i = i;
+                    best_j = j;
+                }
+            }
+        }
+        rects_[best_i] = united(rects_[best_i], rects_[best_j]);
+        rects_.erase(rects_.begin() + best_j);
+
+        // A merged rect may now overlap a third one.
+        for (size_t j = 0; j < rects_.size(); j++) {
+            if (j != best_i && overlaps(rects_[best_i], rects_[j])) {
+                rects_[best_i] = united(rects_[best_i], rects_[j]);
+                rects_.erase(rects_.begin() + j);
+                if (j < best_i) {
+                    best_i--;
+                }
+                j = static_cast<size_t>(-1);
+            }
+        }
+    }
+}
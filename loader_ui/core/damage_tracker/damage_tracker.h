@@ -0,0 +1,67 @@
+#ifndef DAMAGE_TRACKER_HPP
+#define DAMAGE_TRACKER_HPP
+
+#include <cstdint>
+#include <vector>
+#include "../dep/imgui/imgui.h"
+
+// Framebuffer pixels, max exclusive.
+struct damage_rect {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+};
+
+struct damage_stats {
+    int rect_count = 0;
+    bool full = false;
+    int64_t dirty_pixels = 0;
+    int64_t total_pixels = 0;
+};
+
+// Computes what changed on one render target between consecutive frames. Each draw
+// list is summarized by its screen bounds and a hash of its content seeded with its
+// position in the draw order, so a list that moved in z-order hashes differently. A
+// list that appeared, disappeared, moved in z-order or changed content damages both its
+// old and new bounds. The result is merged down to at most kMaxRects rects, or reported
+// as a full redraw when that would cover most of the target anyway.
+//
+// Must see the draw data as ImGui::Render produced it, before the lists are merged.
+class c_damage_tracker {
+public:
+    static constexpr int kMaxRects = 4;
+    // Above this share of the target a full redraw is cheaper than scissored passes.
+    static constexpr float kFullRedrawThreshold = 0.6f;
+
+    void update(const ImDrawData* draw_data);
+    // Forces a full redraw next update, e.g. after the target lost its contents.
+    void invalidate() { valid_ = false; }
+
+    bool full() const { return full_; }
+    // Empty and !full() means nothing changed.
+    const std::vector<damage_rect>& rects() const { return rects_; }
+    const damage_stats& stats() const { return stats_; }
+
+private:
+    struct list_state {
+        const ImDrawList* list;
+        uint64_t hash;
+        damage_rect bounds;
+    };
+
+    void add_damage(const damage_rect& rect);
+    void merge_rects();
+
+    std::vector<list_state> previous_;
+    std::vector<list_state> current_;
+    std::vector<damage_rect> rects_;
+    bool full_ = true;
+    bool valid_ = false;
+    int width_ = 0;
+    int height_ = 0;
+    ImVec2 display_pos_{};
+    damage_stats stats_{};
+};
+
+#endif // DAMAGE_TRACKER_HPP
@@ -16,6 +16,12 @@
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2026-10-19: DirectX11: Added ImGui_ImplDX11_RenderViewport()/ImGui_ImplDX11_PresentViewport()/ImGui_ImplDX11_SetViewportDataDamage() taking the viewport's RendererUserData, for submitting from a render thread.
+//  2026-10-19: DirectX11: Added ImGui_ImplDX11_SetViewportDamage(): secondary viewports render into a retained canvas, redraw only the damaged rects (ClearView + scissor) and present them with Present1 dirty rects.
+//  2026-10-19: DirectX11: Upload rings start their frame lazily on the rendering thread (ImGui_ImplDX11_BeginUploadFrame() only bumps a counter), and damage rects live in a fixed array, so another thread can render without racing the UI thread or allocating.
+//  2026-10-19: DirectX11: Secondary viewports use a single-buffer sequential swap chain, whose back buffer keeps the last frame, so a damaged frame copies only its rects from the canvas.
+//  2026-10-19: DirectX11: Skip RSSetScissorRects/PSSetShaderResources when the value matches what the previous command bound.
+//  2026-10-19: DirectX11: Stream vertex/index data through persistent per-viewport rings (NO_OVERWRITE appends, geometric growth with shrink hysteresis) instead of discarding and regrowing by fixed slack.
 //  2024-XX-XX: Platform: Added support for multiple windows via the ImGuiPlatformIO interface.
 //  2022-10-11: Using 'nullptr' instead of 'NULL' as per our switch to C++11.
 //  2021-06-29: Reorganized backend to pull data from a single structure to facilitate usage with multiple-contexts (all g_XXXX access changed to bd->XXXX).
@@ -42,10 +48,35 @@
 // DirectX
 #include <stdio.h>
 #include <d3d11.h>
+#include <d3d11_1.h>
+#include <dxgi1_2.h>
 #include <d3dcompiler.h>
 #ifdef _MSC_VER
 #pragma comment(lib, "d3dcompiler") // Automatically link with d3dcompiler.lib as we are using D3DCompile() below.
 #endif
+#include "../../upload_ring/upload_ring.h"
+
+// Streaming vertex/index storage. The main viewport uses the one owned by ImGui_ImplDX11_Data,
+// every secondary viewport owns its own so their rings grow and wrap independently.
+struct ImGui_ImplDX11_UploadBuffers
+{
+    ID3D11Buffer*               pVB;
+    ID3D11Buffer*               pIB;
+    c_upload_ring               VtxRing;
+    c_upload_ring               IdxRing;
+    unsigned int                Frame;          // upload frame the rings last began
+
+    ImGui_ImplDX11_UploadBuffers() : pVB(nullptr), pIB(nullptr), VtxRing(5000), IdxRing(10000), Frame(0) {}
+    ~ImGui_ImplDX11_UploadBuffers() { IM_ASSERT(pVB == nullptr && pIB == nullptr); }
+
+    void Release()
+    {
+        if (pVB) { pVB->Release(); pVB = nullptr; }
+        if (pIB) { pIB->Release(); pIB = nullptr; }
+        VtxRing.invalidate();
+        IdxRing.invalidate();
+    }
+};
 
 // DirectX11 data
 struct ImGui_ImplDX11_Data
@@ -53,8 +84,7 @@ struct ImGui_ImplDX11_Data
     ID3D11Device*               pd3dDevice;
     ID3D11DeviceContext*        pd3dDeviceContext;
     IDXGIFactory*               pFactory;
-    ID3D11Buffer*               pVB;
-    ID3D11Buffer*               pIB;
+    ImGui_ImplDX11_UploadBuffers* pMainBuffers;
     ID3D11VertexShader*         pVertexShader;
     ID3D11InputLayout*          pInputLayout;
     ID3D11Buffer*               pVertexConstantBuffer;
@@ -64,10 +94,12 @@ struct ImGui_ImplDX11_Data
     ID3D11RasterizerState*      pRasterizerState;
     ID3D11BlendState*           pBlendState;
     ID3D11DepthStencilState*    pDepthStencilState;
-    int                         VertexBufferSize;
-    int                         IndexBufferSize;
+    ID3D11DeviceContext1*       pd3dDeviceContext1;     // D3D 11.1 for ClearView(); partial redraws are disabled without it
+    const D3D11_RECT*           pDamageRects;           // while set, every draw is additionally scissored to each of these
+    int                         DamageRectCount;
+    unsigned int                UploadFrame;            // bumped by ImGui_ImplDX11_BeginUploadFrame() on the rendering thread
 
-    ImGui_ImplDX11_Data()       { memset((void*)this, 0, sizeof(*this)); VertexBufferSize = 5000; IndexBufferSize = 10000; }
+    ImGui_ImplDX11_Data()       { memset((void*)this, 0, sizeof(*this)); }
 };
 
 struct VERTEX_CONSTANT_BUFFER_DX11
@@ -85,9 +117,11 @@ static ImGui_ImplDX11_Data* ImGui_ImplDX11_GetBackendData()
 // Forward Declarations
 static void ImGui_ImplDX11_InitPlatformInterface();
 static void ImGui_ImplDX11_ShutdownPlatformInterface();
+static ImGui_ImplDX11_UploadBuffers* ImGui_ImplDX11_GetUploadBuffers(ImDrawData* draw_data);
+static void ImGui_ImplDX11_RenderDrawDataInto(ImDrawData* draw_data, ImGui_ImplDX11_UploadBuffers* buffers);
 
 // Functions
-static void ImGui_ImplDX11_SetupRenderState(ImDrawData* draw_data, ID3D11DeviceContext* ctx)
+static void ImGui_ImplDX11_SetupRenderState(ImDrawData* draw_data, ID3D11DeviceContext* ctx, ImGui_ImplDX11_UploadBuffers* buffers)
 {
     ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
 
@@ -105,8 +139,8 @@ static void ImGui_ImplDX11_SetupRenderState(ImDrawData* draw_data, ID3D11DeviceC
     unsigned int stride = sizeof(ImDrawVert);
     unsigned int offset = 0;
     ctx->IASetInputLayout(bd->pInputLayout);
-    ctx->IASetVertexBuffers(0, 1, &bd->pVB, &stride, &offset);
-    ctx->IASetIndexBuffer(bd->pIB, sizeof(ImDrawIdx) == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0);
+    ctx->IASetVertexBuffers(0, 1, &buffers->pVB, &stride, &offset);
+    ctx->IASetIndexBuffer(buffers->pIB, sizeof(ImDrawIdx) == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0);
     ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     ctx->VSSetShader(bd->pVertexShader, nullptr, 0);
     ctx->VSSetConstantBuffers(0, 1, &bd->pVertexConstantBuffer);
@@ -126,6 +160,12 @@ static void ImGui_ImplDX11_SetupRenderState(ImDrawData* draw_data, ID3D11DeviceC
 
 // Render function
 void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
+{
+    ImGui_ImplDX11_RenderDrawDataInto(draw_data, ImGui_ImplDX11_GetUploadBuffers(draw_data));
+}
+
+// Renders through the given upload rings, so callers that know the viewport need not keep draw_data->OwnerViewport valid
+static void ImGui_ImplDX11_RenderDrawDataInto(ImDrawData* draw_data, ImGui_ImplDX11_UploadBuffers* buffers)
 {
     // Avoid rendering when minimized
     if (draw_data->DisplaySize.x <= 0.0f || draw_data->DisplaySize.y <= 0.0f)
@@ -134,43 +174,69 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
     ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
     ID3D11DeviceContext* ctx = bd->pd3dDeviceContext;
 
-    // Create and grow vertex/index buffers if needed
-    if (!bd->pVB || bd->VertexBufferSize < draw_data->TotalVtxCount)
+    // Place this frame's geometry in the upload rings, (re)creating the buffers when a ring grew or shrank
+    if (buffers->Frame != bd->UploadFrame)
     {
-        if (bd->pVB) { bd->pVB->Release(); bd->pVB = nullptr; }
-        bd->VertexBufferSize = draw_data->TotalVtxCount + 5000;
+        // First draw into these buffers this frame (drives the rings' shrink hysteresis)
+        buffers->VtxRing.begin_frame();
+        buffers->IdxRing.begin_frame();
+        buffers->Frame = bd->UploadFrame;
+    }
+    if (!buffers->pVB)
+        buffers->VtxRing.invalidate();
+    if (!buffers->pIB)
+        buffers->IdxRing.invalidate();
+    const upload_reservation vtx_place = buffers->VtxRing.reserve((size_t)draw_data->TotalVtxCount);
+    const upload_reservation idx_place = buffers->IdxRing.reserve((size_t)draw_data->TotalIdxCount);
+    if (!buffers->pVB || vtx_place.reallocate)
+    {
+        if (buffers->pVB) { buffers->pVB->Release(); buffers->pVB = nullptr; }
         D3D11_BUFFER_DESC desc;
         memset(&desc, 0, sizeof(D3D11_BUFFER_DESC));
         desc.Usage = D3D11_USAGE_DYNAMIC;
-        desc.ByteWidth = bd->VertexBufferSize * sizeof(ImDrawVert);
+        desc.ByteWidth = (UINT)(buffers->VtxRing.capacity() * sizeof(ImDrawVert));
         desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
         desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
         desc.MiscFlags = 0;
-        if (bd->pd3dDevice->CreateBuffer(&desc, nullptr, &bd->pVB) < 0)
+        if (bd->pd3dDevice->CreateBuffer(&desc, nullptr, &buffers->pVB) < 0)
+        {
+            buffers->VtxRing.invalidate();
             return;
+        }
     }
-    if (!bd->pIB || bd->IndexBufferSize < draw_data->TotalIdxCount)
+    if (!buffers->pIB || idx_place.reallocate)
     {
-        if (bd->pIB) { bd->pIB->Release(); bd->pIB = nullptr; }
-        bd->IndexBufferSize = draw_data->TotalIdxCount + 10000;
+        if (buffers->pIB) { buffers->pIB->Release(); buffers->pIB = nullptr; }
         D3D11_BUFFER_DESC desc;
         memset(&desc, 0, sizeof(D3D11_BUFFER_DESC));
         desc.Usage = D3D11_USAGE_DYNAMIC;
-        desc.ByteWidth = bd->IndexBufferSize * sizeof(ImDrawIdx);
+        desc.ByteWidth = (UINT)(buffers->IdxRing.capacity() * sizeof(ImDrawIdx));
         desc.BindFlags = D3D11_BIND_INDEX_BUFFER;
         desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-        if (bd->pd3dDevice->CreateBuffer(&desc, nullptr, &bd->pIB) < 0)
+        if (bd->pd3dDevice->CreateBuffer(&desc, nullptr, &buffers->pIB) < 0)
+        {
+            buffers->IdxRing.invalidate();
             return;
+        }
     }
 
-    // Upload vertex/index data into a single contiguous GPU buffer
+    // Upload vertex/index data behind the previous upload (NO_OVERWRITE), or from the start of a renamed buffer (DISCARD) when the ring wrapped
     D3D11_MAPPED_SUBRESOURCE vtx_resource, idx_resource;
-    if (ctx->Map(bd->pVB, 0, D3D11_MAP_WRITE_DISCARD, 0, &vtx_resource) != S_OK)
+    const D3D11_MAP vtx_map = vtx_place.mode == upload_map_mode::no_overwrite ? D3D11_MAP_WRITE_NO_OVERWRITE : D3D11_MAP_WRITE_DISCARD;
+    const D3D11_MAP idx_map = idx_place.mode == upload_map_mode::no_overwrite ? D3D11_MAP_WRITE_NO_OVERWRITE : D3D11_MAP_WRITE_DISCARD;
+    if (ctx->Map(buffers->pVB, 0, vtx_map, 0, &vtx_resource) != S_OK)
+    {
+        buffers->VtxRing.invalidate();
         return;
-    if (ctx->Map(bd->pIB, 0, D3D11_MAP_WRITE_DISCARD, 0, &idx_resource) != S_OK)
+    }
+    if (ctx->Map(buffers->pIB, 0, idx_map, 0, &idx_resource) != S_OK)
+    {
+        ctx->Unmap(buffers->pVB, 0);
+        buffers->IdxRing.invalidate();
         return;
-    ImDrawVert* vtx_dst = (ImDrawVert*)vtx_resource.pData;
-    ImDrawIdx* idx_dst = (ImDrawIdx*)idx_resource.pData;
+    }
+    ImDrawVert* vtx_dst = (ImDrawVert*)vtx_resource.pData + vtx_place.offset;
+    ImDrawIdx* idx_dst = (ImDrawIdx*)idx_resource.pData + idx_place.offset;
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
@@ -179,8 +245,8 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
         vtx_dst += cmd_list->VtxBuffer.Size;
         idx_dst += cmd_list->IdxBuffer.Size;
     }
-    ctx->Unmap(bd->pVB, 0);
-    ctx->Unmap(bd->pIB, 0);
+    ctx->Unmap(buffers->pVB, 0);
+    ctx->Unmap(buffers->pIB, 0);
 
     // Setup orthographic projection matrix into our constant buffer
     // Our visible imgui space lies from draw_data->DisplayPos (top left) to draw_data->DisplayPos+data_data->DisplaySize (bottom right). DisplayPos is (0,0) for single viewport apps.
@@ -250,13 +316,17 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
     ctx->IAGetInputLayout(&old.InputLayout);
 
     // Setup desired DX state
-    ImGui_ImplDX11_SetupRenderState(draw_data, ctx);
+    ImGui_ImplDX11_SetupRenderState(draw_data, ctx, buffers);
 
     // Render command lists
-    // (Because we merged all buffers into a single one, we maintain our own offset into them)
-    int global_idx_offset = 0;
-    int global_vtx_offset = 0;
+    // (Because we merged all buffers into a single one, we maintain our own offset into them, starting where the rings placed this frame)
+    int global_idx_offset = (int)idx_place.offset;
+    int global_vtx_offset = (int)vtx_place.offset;
     ImVec2 clip_off = draw_data->DisplayPos;
+    // Scissor/texture already bound, so consecutive commands sharing them skip the redundant state calls (reset after any callback)
+    D3D11_RECT bound_rect = { -1, -1, -1, -1 };
+    ID3D11ShaderResourceView* bound_srv = nullptr;
+    bool bound_valid = false;
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
@@ -268,9 +338,10 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
                 // User callback, registered via ImDrawList::AddCallback()
                 // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
                 if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
-                    ImGui_ImplDX11_SetupRenderState(draw_data, ctx);
+                    ImGui_ImplDX11_SetupRenderState(draw_data, ctx, buffers);
                 else
                     pcmd->UserCallback(cmd_list, pcmd);
+                bound_valid = false;
             }
             else
             {
@@ -282,12 +353,38 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
 
                 // Apply scissor/clipping rectangle
                 const D3D11_RECT r = { (LONG)clip_min.x, (LONG)clip_min.y, (LONG)clip_max.x, (LONG)clip_max.y };
-                ctx->RSSetScissorRects(1, &r);
 
-                // Bind texture, Draw
-                ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)pcmd->GetTexID();
-                ctx->PSSetShaderResources(0, 1, &texture_srv);
-                ctx->DrawIndexed(pcmd->ElemCount, pcmd->IdxOffset + global_idx_offset, pcmd->VtxOffset + global_vtx_offset);
+                // When redrawing damaged rects only, issue the command once per rect it overlaps
+                const int pass_count = bd->DamageRectCount > 0 ? bd->DamageRectCount : 1;
+                for (int pass = 0; pass < pass_count; pass++)
+                {
+                    D3D11_RECT pass_rect = r;
+                    if (bd->DamageRectCount > 0)
+                    {
+                        const D3D11_RECT& damage = bd->pDamageRects[pass];
+                        if (pass_rect.left < damage.left) pass_rect.left = damage.left;
+                        if (pass_rect.top < damage.top) pass_rect.top = damage.top;
+                        if (pass_rect.right > damage.right) pass_rect.right = damage.right;
+                        if (pass_rect.bottom > damage.bottom) pass_rect.bottom = damage.bottom;
+                        if (pass_rect.right <= pass_rect.left || pass_rect.bottom <= pass_rect.top)
+                            continue;
+                    }
+                    if (!bound_valid || pass_rect.left != bound_rect.left || pass_rect.top != bound_rect.top || pass_rect.right != bound_rect.right || pass_rect.bottom != bound_rect.bottom)
+                    {
+                        ctx->RSSetScissorRects(1, &pass_rect);
+                        bound_rect = pass_rect;
+                    }
+
+                    // Bind texture, Draw
+                    ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)pcmd->GetTexID();
+                    if (!bound_valid || texture_srv != bound_srv)
+                    {
+                        ctx->PSSetShaderResources(0, 1, &texture_srv);
+                        bound_srv = texture_srv;
+                    }
+                    bound_valid = true;
+                    ctx->DrawIndexed(pcmd->ElemCount, pcmd->IdxOffset + global_idx_offset, pcmd->VtxOffset + global_vtx_offset);
+                }
             }
         }
         global_idx_offset += cmd_list->IdxBuffer.Size;
@@ -538,8 +635,7 @@ void    ImGui_ImplDX11_InvalidateDeviceObjects()
 
     if (bd->pFontSampler)           { bd->pFontSampler->Release(); bd->pFontSampler = nullptr; }
     if (bd->pFontTextureView)       { bd->pFontTextureView->Release(); bd->pFontTextureView = nullptr; ImGui::GetIO().Fonts->SetTexID(0); } // We copied data->pFontTextureView to io.Fonts->TexID so let's clear that as well.
-    if (bd->pIB)                    { bd->pIB->Release(); bd->pIB = nullptr; }
-    if (bd->pVB)                    { bd->pVB->Release(); bd->pVB = nullptr; }
+    if (bd->pMainBuffers)           { bd->pMainBuffers->Release(); }
     if (bd->pBlendState)            { bd->pBlendState->Release(); bd->pBlendState = nullptr; }
     if (bd->pDepthStencilState)     { bd->pDepthStencilState->Release(); bd->pDepthStencilState = nullptr; }
     if (bd->pRasterizerState)       { bd->pRasterizerState->Release(); bd->pRasterizerState = nullptr; }
@@ -560,6 +656,7 @@ bool    ImGui_ImplDX11_Init(ID3D11Device* device, ID3D11DeviceContext* device_co
     io.BackendRendererName = "imgui_impl_dx11";
     io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;  // We can honor the ImDrawCmd::VtxOffset field, allowing for large meshes.
     io.BackendFlags |= ImGuiBackendFlags_RendererHasViewports;  // We can create multi-viewports on the Renderer side (optional)
+    bd->pMainBuffers = IM_NEW(ImGui_ImplDX11_UploadBuffers)();
 
     // Get factory from device
     IDXGIDevice* pDXGIDevice = nullptr;
@@ -578,6 +675,8 @@ bool    ImGui_ImplDX11_Init(ID3D11Device* device, ID3D11DeviceContext* device_co
     if (pDXGIAdapter) pDXGIAdapter->Release();
     bd->pd3dDevice->AddRef();
     bd->pd3dDeviceContext->AddRef();
+    if (device_context->QueryInterface(IID_PPV_ARGS(&bd->pd3dDeviceContext1)) != S_OK)
+        bd->pd3dDeviceContext1 = nullptr;
 
     if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
         ImGui_ImplDX11_InitPlatformInterface();
@@ -593,9 +692,11 @@ void ImGui_ImplDX11_Shutdown()
 
     ImGui_ImplDX11_ShutdownPlatformInterface();
     ImGui_ImplDX11_InvalidateDeviceObjects();
+    if (bd->pMainBuffers)         { bd->pMainBuffers->Release(); IM_DELETE(bd->pMainBuffers); }
     if (bd->pFactory)             { bd->pFactory->Release(); }
     if (bd->pd3dDevice)           { bd->pd3dDevice->Release(); }
     if (bd->pd3dDeviceContext)    { bd->pd3dDeviceContext->Release(); }
+    if (bd->pd3dDeviceContext1)   { bd->pd3dDeviceContext1->Release(); }
     io.BackendRendererName = nullptr;
     io.BackendRendererUserData = nullptr;
     io.BackendFlags &= ~(ImGuiBackendFlags_RendererHasVtxOffset | ImGuiBackendFlags_RendererHasViewports);
@@ -622,9 +723,28 @@ struct ImGui_ImplDX11_ViewportData
 {
     IDXGISwapChain*                 SwapChain;
     ID3D11RenderTargetView*         RTView;
-
-    ImGui_ImplDX11_ViewportData()   { SwapChain = nullptr; RTView = nullptr; }
-    ~ImGui_ImplDX11_ViewportData()  { IM_ASSERT(SwapChain == nullptr && RTView == nullptr); }
+    ImGui_ImplDX11_UploadBuffers    Buffers;
+    IDXGISwapChain1*                SwapChain1;     // for Present1() dirty rects, nullptr when unsupported
+    ID3D11Texture2D*                Canvas;         // retained copy of the last frame, the back buffer is undefined after Present
+    ID3D11RenderTargetView*         CanvasRTView;
+    bool                            CanvasValid;
+    bool                            BackBufferRetained; // single-buffer sequential swap chain: the back buffer still holds the last frame after Present
+    bool                            BackBufferValid;    // the back buffer matches the canvas as of the last frame
+    D3D11_RECT                      DamageRects[IMGUI_IMPL_DX11_MAX_DAMAGE_RECTS];  // set by ImGui_ImplDX11_SetViewportDamage() for the coming frame; not ImVector, the render thread must not allocate
+    int                             DamageRectCount;
+    bool                            DamageFull;
+    bool                            PresentPartial;
+
+    ImGui_ImplDX11_ViewportData()   { SwapChain = nullptr; RTView = nullptr; SwapChain1 = nullptr; Canvas = nullptr; CanvasRTView = nullptr; CanvasValid = false; BackBufferRetained = false; BackBufferValid = false; DamageRectCount = 0; DamageFull = true; PresentPartial = false; }
+    ~ImGui_ImplDX11_ViewportData()  { IM_ASSERT(SwapChain == nullptr && RTView == nullptr && SwapChain1 == nullptr && Canvas == nullptr); }
+
+    void ReleaseCanvas()
+    {
+        if (CanvasRTView) { CanvasRTView->Release(); CanvasRTView = nullptr; }
+        if (Canvas) { Canvas->Release(); Canvas = nullptr; }
+        CanvasValid = false;
+        BackBufferValid = false;
+    }
 };
 
 static void ImGui_ImplDX11_CreateWindow(ImGuiViewport* viewport)
@@ -650,7 +770,7 @@ static void ImGui_ImplDX11_CreateWindow(ImGuiViewport* viewport)
     sd.BufferCount = 1;
     sd.OutputWindow = hwnd;
     sd.Windowed = TRUE;
-    sd.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+    sd.SwapEffect = DXGI_SWAP_EFFECT_SEQUENTIAL;
     sd.Flags = 0;
 
     IM_ASSERT(vd->SwapChain == nullptr && vd->RTView == nullptr);
@@ -663,6 +783,8 @@ static void ImGui_ImplDX11_CreateWindow(ImGuiViewport* viewport)
         vd->SwapChain->GetBuffer(0, IID_PPV_ARGS(&pBackBuffer));
         bd->pd3dDevice->CreateRenderTargetView(pBackBuffer, nullptr, &vd->RTView);
         pBackBuffer->Release();
+        if (vd->SwapChain->QueryInterface(IID_PPV_ARGS(&vd->SwapChain1)) != S_OK)
+            vd->SwapChain1 = nullptr;
     }
 }
 
@@ -677,6 +799,11 @@ static void ImGui_ImplDX11_DestroyWindow(ImGuiViewport* viewport)
         if (vd->RTView)
             vd->RTView->Release();
         vd->RTView = nullptr;
+        if (vd->SwapChain1)
+            vd->SwapChain1->Release();
+        vd->SwapChain1 = nullptr;
+        vd->ReleaseCanvas();
+        vd->Buffers.Release();
         IM_DELETE(vd);
     }
     viewport->RendererUserData = nullptr;
@@ -686,6 +813,7 @@ static void ImGui_ImplDX11_SetWindowSize(ImGuiViewport* viewport, ImVec2 size)
 {
     ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
     ImGui_ImplDX11_ViewportData* vd = (ImGui_ImplDX11_ViewportData*)viewport->RendererUserData;
+    vd->ReleaseCanvas();
     if (vd->RTView)
     {
         vd->RTView->Release();
@@ -702,21 +830,208 @@ static void ImGui_ImplDX11_SetWindowSize(ImGuiViewport* viewport, ImVec2 size)
     }
 }
 
-static void ImGui_ImplDX11_RenderWindow(ImGuiViewport* viewport, void*)
+static bool ImGui_ImplDX11_CreateCanvas(ImGui_ImplDX11_ViewportData* vd, ID3D11Texture2D* back_buffer)
+{
+    ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
+    D3D11_TEXTURE2D_DESC desc;
+    back_buffer->GetDesc(&desc);
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_RENDER_TARGET;
+    desc.CPUAccessFlags = 0;
+    desc.MiscFlags = 0;
+    if (bd->pd3dDevice->CreateTexture2D(&desc, nullptr, &vd->Canvas) < 0)
+    {
+        vd->Canvas = nullptr;
+        return false;
+    }
+    if (bd->pd3dDevice->CreateRenderTargetView(vd->Canvas, nullptr, &vd->CanvasRTView) < 0)
+    {
+        vd->CanvasRTView = nullptr;
+        vd->ReleaseCanvas();
+        return false;
+    }
+    DXGI_SWAP_CHAIN_DESC sd;
+    vd->BackBufferRetained = vd->SwapChain->GetDesc(&sd) >= 0 && sd.SwapEffect == DXGI_SWAP_EFFECT_SEQUENTIAL && sd.BufferCount == 1;
+    vd->BackBufferValid = false;
+    vd->CanvasValid = false;
+    return true;
+}
+
+static void ImGui_ImplDX11_RenderViewportData(ImGui_ImplDX11_ViewportData* vd, ImDrawData* draw_data, bool clear)
 {
     ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
-    ImGui_ImplDX11_ViewportData* vd = (ImGui_ImplDX11_ViewportData*)viewport->RendererUserData;
     ImVec4 clear_color = ImVec4(0.0f, 0.0f, 0.0f, 1.0f);
+    vd->PresentPartial = false;
+
+    // Damage-aware path: draw into the retained canvas, touching only the damaged rects when the canvas still holds last frame, then copy it to the back buffer
+    ID3D11Texture2D* back_buffer = nullptr;
+    if (bd->pd3dDeviceContext1 && vd->SwapChain)
+        vd->SwapChain->GetBuffer(0, IID_PPV_ARGS(&back_buffer));
+    if (back_buffer && (vd->Canvas || ImGui_ImplDX11_CreateCanvas(vd, back_buffer)))
+    {
+        ID3D11DeviceContext* ctx = bd->pd3dDeviceContext;
+        ctx->OMSetRenderTargets(1, &vd->CanvasRTView, nullptr);
+        if (vd->CanvasValid && !vd->DamageFull)
+        {
+            if (vd->DamageRectCount > 0)
+            {
+                if (clear)
+                    bd->pd3dDeviceContext1->ClearView(vd->CanvasRTView, (float*)&clear_color, vd->DamageRects, (UINT)vd->DamageRectCount);
+                bd->pDamageRects = vd->DamageRects;
+                bd->DamageRectCount = vd->DamageRectCount;
+                ImGui_ImplDX11_RenderDrawDataInto(draw_data, &vd->Buffers);
+                bd->pDamageRects = nullptr;
+                bd->DamageRectCount = 0;
+            }
+            vd->PresentPartial = true;
+        }
+        else
+        {
+            if (clear)
+                ctx->ClearRenderTargetView(vd->CanvasRTView, (float*)&clear_color);
+            ImGui_ImplDX11_RenderDrawDataInto(draw_data, &vd->Buffers);
+        }
+        vd->CanvasValid = true;
+        if (vd->PresentPartial && vd->BackBufferRetained && vd->BackBufferValid)
+        {
+            for (int i = 0; i < vd->DamageRectCount; i++)
+            {
+                const D3D11_RECT& r = vd->DamageRects[i];
+                const D3D11_BOX box = { (UINT)r.left, (UINT)r.top, 0, (UINT)r.right, (UINT)r.bottom, 1 };
+                ctx->CopySubresourceRegion(back_buffer, 0, (UINT)r.left, (UINT)r.top, 0, vd->Canvas, 0, &box);
+            }
+        }
+        else
+        {
+            ctx->CopyResource(back_buffer, vd->Canvas);
+        }
+        vd->BackBufferValid = vd->BackBufferRetained;
+        back_buffer->Release();
+        return;
+    }
+    if (back_buffer)
+        back_buffer->Release();
+
     bd->pd3dDeviceContext->OMSetRenderTargets(1, &vd->RTView, nullptr);
-    if (!(viewport->Flags & ImGuiViewportFlags_NoRendererClear))
+    if (clear)
         bd->pd3dDeviceContext->ClearRenderTargetView(vd->RTView, (float*)&clear_color);
-    ImGui_ImplDX11_RenderDrawData(viewport->DrawData);
+    ImGui_ImplDX11_RenderDrawDataInto(draw_data, &vd->Buffers);
+}
+
+static void ImGui_ImplDX11_RenderWindow(ImGuiViewport* viewport, void*)
+{
+    ImGui_ImplDX11_RenderViewportData((ImGui_ImplDX11_ViewportData*)viewport->RendererUserData, viewport->DrawData, !(viewport->Flags & ImGuiViewportFlags_NoRendererClear));
+}
+
+static void ImGui_ImplDX11_PresentViewportData(ImGui_ImplDX11_ViewportData* vd)
+{
+    bool presented = false;
+    if (vd->PresentPartial && vd->SwapChain1 && vd->DamageRectCount > 0)
+    {
+        DXGI_PRESENT_PARAMETERS params = {};
+        params.DirtyRectsCount = (UINT)vd->DamageRectCount;
+        params.pDirtyRects = vd->DamageRects;
+        if (vd->SwapChain1->Present1(0, 0, &params) >= 0) // Present without vsync
+            presented = true;
+        else
+        {
+            // Dirty rects rejected for this swap chain; keep presenting it in full
+            vd->SwapChain1->Release();
+            vd->SwapChain1 = nullptr;
+        }
+    }
+    if (!presented)
+        vd->SwapChain->Present(0, 0); // Present without vsync
+
+    // Damage is per frame; without a new call the next frame redraws everything
+    vd->DamageRectCount = 0;
+    vd->DamageFull = true;
 }
 
 static void ImGui_ImplDX11_SwapBuffers(ImGuiViewport* viewport, void*)
 {
-    ImGui_ImplDX11_ViewportData* vd = (ImGui_ImplDX11_ViewportData*)viewport->RendererUserData;
-    vd->SwapChain->Present(0, 0); // Present without vsync
+    ImGui_ImplDX11_PresentViewportData((ImGui_ImplDX11_ViewportData*)viewport->RendererUserData);
+}
+
+void ImGui_ImplDX11_SetViewportDamage(ImGuiViewport* viewport, const ImVec4* rects, int rect_count)
+{
+    if (viewport)
+        ImGui_ImplDX11_SetViewportDataDamage(viewport->RendererUserData, rects, rect_count);
+}
+
+void ImGui_ImplDX11_SetViewportDataDamage(void* renderer_user_data, const ImVec4* rects, int rect_count)
+{
+    ImGui_ImplDX11_ViewportData* vd = (ImGui_ImplDX11_ViewportData*)renderer_user_data;
+    if (vd == nullptr)
+        return;
+    vd->DamageRectCount = 0;
+    vd->DamageFull = rect_count < 0 || rect_count > IMGUI_IMPL_DX11_MAX_DAMAGE_RECTS;
+    for (int i = 0; i < rect_count && rects != nullptr && !vd->DamageFull; i++)
+    {
+        const D3D11_RECT r = { (LONG)rects[i].x, (LONG)rects[i].y, (LONG)rects[i].z, (LONG)rects[i].w };
+        if (r.right > r.left && r.bottom > r.top)
+            vd->DamageRects[vd->DamageRectCount++] = r;
+    }
+}
+
+void ImGui_ImplDX11_RenderViewport(void* renderer_user_data, ImDrawData* draw_data, bool clear)
+{
+    if (renderer_user_data)
+        ImGui_ImplDX11_RenderViewportData((ImGui_ImplDX11_ViewportData*)renderer_user_data, draw_data, clear);
+}
+
+void ImGui_ImplDX11_PresentViewport(void* renderer_user_data)
+{
+    if (renderer_user_data)
+        ImGui_ImplDX11_PresentViewportData((ImGui_ImplDX11_ViewportData*)renderer_user_data);
+}
+
+static ImGui_ImplDX11_UploadBuffers* ImGui_ImplDX11_GetUploadBuffers(ImDrawData* draw_data)
+{
+    if (draw_data && draw_data->OwnerViewport)
+        if (ImGui_ImplDX11_ViewportData* vd = (ImGui_ImplDX11_ViewportData*)draw_data->OwnerViewport->RendererUserData)
+            return &vd->Buffers;
+    ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
+    return bd ? bd->pMainBuffers : nullptr;
+}
+
+// Each ring begins its frame at its first draw after this, on whichever thread draws
+void ImGui_ImplDX11_BeginUploadFrame()
+{
+    ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
+    bd->UploadFrame++;
+}
+
+static void ImGui_ImplDX11_AccumulateUploadStats(upload_ring_stats* out, const upload_ring_stats& in)
+{
+    out->reservations += in.reservations;
+    out->appends += in.appends;
+    out->wraps += in.wraps;
+    out->grows += in.grows;
+    out->shrinks += in.shrinks;
+    out->capacity += in.capacity;
+    out->frame_peak += in.frame_peak;
+}
+
+void ImGui_ImplDX11_GetUploadStats(upload_ring_stats* out_vtx, upload_ring_stats* out_idx)
+{
+    ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
+    if (!bd || !bd->pMainBuffers)
+        return;
+    upload_ring_stats vtx, idx;
+    ImGui_ImplDX11_AccumulateUploadStats(&vtx, bd->pMainBuffers->VtxRing.stats());
+    ImGui_ImplDX11_AccumulateUploadStats(&idx, bd->pMainBuffers->IdxRing.stats());
+    ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+    for (int i = 0; i < platform_io.Viewports.Size; i++)
+        if (ImGui_ImplDX11_ViewportData* vd = (ImGui_ImplDX11_ViewportData*)platform_io.Viewports[i]->RendererUserData)
+        {
+            ImGui_ImplDX11_AccumulateUploadStats(&vtx, vd->Buffers.VtxRing.stats());
+            ImGui_ImplDX11_AccumulateUploadStats(&idx, vd->Buffers.IdxRing.stats());
+        }
+    if (out_vtx)
+        *out_vtx = vtx;
+    if (out_idx)
+        *out_idx = idx;
 }
 
 static void ImGui_ImplDX11_InitPlatformInterface()
@@ -20,12 +20,34 @@
 
 struct ID3D11Device;
 struct ID3D11DeviceContext;
+struct upload_ring_stats;
 
 IMGUI_IMPL_API bool     ImGui_ImplDX11_Init(ID3D11Device* device, ID3D11DeviceContext* device_context);
 IMGUI_IMPL_API void     ImGui_ImplDX11_Shutdown();
 IMGUI_IMPL_API void     ImGui_ImplDX11_NewFrame();
 IMGUI_IMPL_API void     ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data);
 
+// Starts a frame for the upload rings; each ring begins it at its first draw, on the thread that draws.
+// Call once per frame on the rendering thread, before its first RenderDrawData(). NewFrame() does not.
+IMGUI_IMPL_API void     ImGui_ImplDX11_BeginUploadFrame();
+
+// Growth/wrap counters of the vertex and index upload rings, summed over all viewports.
+IMGUI_IMPL_API void     ImGui_ImplDX11_GetUploadStats(upload_ring_stats* out_vtx, upload_ring_stats* out_idx);
+
+// Damaged area of a secondary viewport for the coming frame, in framebuffer pixels (x0, y0, x1, y1).
+// rect_count < 0 redraws everything; 0 means nothing changed. Only the damaged rects are redrawn and presented.
+// More than IMGUI_IMPL_DX11_MAX_DAMAGE_RECTS rects redraw everything.
+#ifndef IMGUI_IMPL_DX11_MAX_DAMAGE_RECTS
+#define IMGUI_IMPL_DX11_MAX_DAMAGE_RECTS 8
+#endif
+IMGUI_IMPL_API void     ImGui_ImplDX11_SetViewportDamage(ImGuiViewport* viewport, const ImVec4* rects, int rect_count);
+
+// Same as Renderer_RenderWindow/Renderer_SwapBuffers/SetViewportDamage, but keyed by the viewport's RendererUserData so
+// another thread can submit a copied ImDrawData. The handle stays valid until the next UpdatePlatformWindows()/DestroyPlatformWindows().
+IMGUI_IMPL_API void     ImGui_ImplDX11_RenderViewport(void* renderer_user_data, ImDrawData* draw_data, bool clear);
+IMGUI_IMPL_API void     ImGui_ImplDX11_PresentViewport(void* renderer_user_data);
+IMGUI_IMPL_API void     ImGui_ImplDX11_SetViewportDataDamage(void* renderer_user_data, const ImVec4* rects, int rect_count);
+
 // Use if you want to reset your rendering device without losing Dear ImGui state.
 IMGUI_IMPL_API void     ImGui_ImplDX11_InvalidateDeviceObjects();
 IMGUI_IMPL_API bool     ImGui_ImplDX11_CreateDeviceObjects();
@@ -40,6 +40,7 @@ typedef DWORD (WINAPI *PFN_XInputGetState)(DWORD, XINPUT_STATE*);
 
 // CHANGELOG
 // (minor and older changes stripped away, please see git history for details)
+//  2026-10-19: Inputs: Added ImGui_ImplWin32_SetInputObserver() to bracket every WndProcHandler call, for input latency measurements.
 //  2024-XX-XX: Platform: Added support for multiple windows via the ImGuiPlatformIO interface.
 //  2023-10-05: Inputs: Added support for extra ImGuiKey values: F13 to F24 function keys, app back/forward keys.
 //  2023-09-25: Inputs: Synthesize key-down event on key-up for VK_SNAPSHOT / ImGuiKey_PrintScreen as Windows doesn't emit it (same behavior as GLFW/SDL).
@@ -109,6 +110,8 @@ struct ImGui_ImplWin32_Data
     ImGuiMouseCursor            LastMouseCursor;
     UINT32                      KeyboardCodePage;
     bool                        WantUpdateMonitors;
+    ImGui_ImplWin32_InputObserver InputObserver;
+    void*                       InputObserverUserData;
 
 #ifndef IMGUI_IMPL_WIN32_DISABLE_GAMEPAD
     bool                        HasGamepad;
@@ -640,7 +643,31 @@ static ImGuiMouseSource GetMouseSourceFromMessageExtraInfo()
     return ImGuiMouseSource_Mouse;
 }
 
+static LRESULT ImGui_ImplWin32_WndProcHandlerEx(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+
 IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+    ImGui_ImplWin32_Data* bd = ImGui_ImplWin32_GetBackendData();
+    if (bd == nullptr || bd->InputObserver == nullptr)
+        return ImGui_ImplWin32_WndProcHandlerEx(hwnd, msg, wParam, lParam);
+
+    ImGui_ImplWin32_InputObserver observer = bd->InputObserver;
+    void* user_data = bd->InputObserverUserData;
+    observer(msg, false, user_data);
+    LRESULT result = ImGui_ImplWin32_WndProcHandlerEx(hwnd, msg, wParam, lParam);
+    observer(msg, true, user_data);
+    return result;
+}
+
+void ImGui_ImplWin32_SetInputObserver(ImGui_ImplWin32_InputObserver observer, void* user_data)
+{
+    ImGui_ImplWin32_Data* bd = ImGui_ImplWin32_GetBackendData();
+    IM_ASSERT(bd != nullptr && "Did you call ImGui_ImplWin32_Init()?");
+    bd->InputObserver = observer;
+    bd->InputObserverUserData = user_data;
+}
+
+static LRESULT ImGui_ImplWin32_WndProcHandlerEx(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
     if (ImGui::GetCurrentContext() == nullptr)
         return 0;
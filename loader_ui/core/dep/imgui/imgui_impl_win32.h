@@ -35,6 +35,12 @@ IMGUI_IMPL_API void     ImGui_ImplWin32_NewFrame();
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 #endif
 
+// Input observer (optional)
+// - Called around every ImGui_ImplWin32_WndProcHandler() call, before (after == false) and after it queued its input events.
+// - Lets the application correlate queued events with the time their message arrived, e.g. for input latency measurements.
+typedef void (*ImGui_ImplWin32_InputObserver)(unsigned int msg, bool after, void* user_data);
+IMGUI_IMPL_API void     ImGui_ImplWin32_SetInputObserver(ImGui_ImplWin32_InputObserver observer, void* user_data);
+
 // DPI-related helpers (optional)
 // - Use to enable DPI awareness without having to create an application manifest.
 // - Your own app may already do this via a manifest or explicit calls. This is mostly useful for our examples/ apps.
@@ -0,0 +1,258 @@
+#include "download_scheduler.h"
+#include <algorithm>
+
+float download_item::progress() const {
+    if (total_bytes)
+        return (std::min)(static_cast<float>(static_cast<double>(done_bytes) / static_cast<double>(total_bytes)), 1.f);
+    return fraction >= 0.f ? fraction : 0.f;
+}
+
+void c_callback_transport::start(download_item& item) {
+    if (start_fn_)
+        start_fn_(item.file_id);
+    if (finish_on_return_ && item.state == download_state::running) {
+        item.total_bytes = item.total_bytes ? item.total_bytes : 1;
+        item.done_bytes = item.total_bytes;
+    }
+}
+
+void c_local_transport::start(download_item& item) {
+    auto it = sizes_.find(item.file_id);
+    item.total_bytes = it != sizes_.end() ? it->second : file_bytes_;
+    allowance_[item.id] = link_rate_ ? 0 : kUnlimited;
+}
+
+void c_local_transport::advance(uint64_t elapsed_us) {
+    if (!link_rate_)
+        return;
+    // A link idle for a while bursts at most one second's worth.
+    const uint64_t added = static_cast<uint64_t>(static_cast<double>(link_rate_) * static_cast<double>(elapsed_us) / 1e6);
+    for (auto& [id, allowance] : allowance_)
+        allowance = (std::min)(allowance + added, link_rate_);
+}
+
+uint64_t c_local_transport::pump(download_item& item, uint64_t budget) {
+    auto it = allowance_.find(item.id);
+    if (it == allowance_.end() || item.done_bytes >= item.total_bytes)
+        return 0;
+    const uint64_t moved = (std::min)({ budget, it->second, item.total_bytes - item.done_bytes });
+    item.done_bytes += moved;
+    if (it->second != kUnlimited)
+        it->second -= moved;
+    return moved;
+}
+
+c_download_scheduler::c_download_scheduler(c_download_transport* transport, int max_sessions)
+    : transport_(transport), max_sessions_(max_sessions > 0 ? max_sessions : 1) {
+}
+
+uint64_t c_download_scheduler::enqueue(const std::string& file_id, const std::string& name, int priority) {
+    if (file_id.empty())
+        return 0;
+    for (const download_item& item : items_) {
+        if (item.file_id == file_id && (item.state == download_state::queued || item.state == download_state::running))
+            return 0;
+    }
+
+    download_item& item = items_.emplace_back();
+    item.id = next_id_++;
+    item.file_id = file_id;
+    item.name = name;
+    item.priority = priority;
+    item.sequence = next_sequence_++;
+    order_dirty_ = true;
+    return item.id;
+}
+
+bool c_download_scheduler::cancel(uint64_t id) {
+    for (size_t i = 0; i < items_.size(); i++) {
+        if (items_[i].id != id)
+            continue;
+        if (items_[i].state == download_state::running) {
+            if (transport_)
+                transport_->stop(items_[i]);
+            running_--;
+        }
+        items_.erase(items_.begin() + i);
+        return true;
+    }
+    return false;
+}
+
+bool c_download_scheduler::set_priority(uint64_t id, int priority) {
+    for (download_item& item : items_) {
+        if (item.id == id) {
+            item.priority = priority;
+            order_dirty_ = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void c_download_scheduler::clear() {
+    for (const download_item& item : items_) {
+        if (item.state == download_state::running && transport_)
+            transport_->stop(item);
+    }
+    items_.clear();
+    active_.clear();
+    running_ = 0;
+    last_tick_us_ = 0;
+    order_dirty_ = false;
+}
+
+download_item* c_download_scheduler::find_running(std::string_view file_id) {
+    for (download_item& item : items_) {
+        if (item.state == download_state::running && item.file_id == file_id)
+            return &item;
+    }
+    return nullptr;
+}
+
+bool c_download_scheduler::report(std::string_view file_id, uint64_t done_bytes, uint64_t total_bytes) {
+    download_item* item = find_running(file_id);
+    if (!item)
+        return false;
+    if (total_bytes)
+        item->total_bytes = total_bytes;
+    item->done_bytes = item->total_bytes ? (std::min)(done_bytes, item->total_bytes) : done_bytes;
+    if (item->total_bytes && item->done_bytes >= item->total_bytes)
+        item->state = download_state::done;
+    return true;
+}
+
+bool c_download_scheduler::report_fraction(std::string_view file_id, float fraction) {
+    download_item* item = find_running(file_id);
+    if (!item)
+        return false;
+    item->fraction = (std::clamp)(fraction, 0.f, 1.f);
+    return true;
+}
+
+bool c_download_scheduler::finish(std::string_view file_id, bool ok) {
+    download_item* item = find_running(file_id);
+    if (!item)
+        return false;
+    item->state = ok ? download_state::done : download_state::failed;
+    if (ok) {
+        item->done_bytes = item->total_bytes;
+        item->fraction = 1.f;
+    }
+    return true;
+}
+
+const download_item* c_download_scheduler::oldest_running() const {
+    const download_item* oldest = nullptr;
+    for (const download_item& item : items_) {
+        if (item.state == download_state::running && (!oldest || item.sequence < oldest->sequence))
+            oldest = &item;
+    }
+    return oldest;
+}
+
+const download_item* c_download_scheduler::find(uint64_t id) const {
+    for (const download_item& item : items_) {
+        if (item.id == id)
+            return &item;
+    }
+    return nullptr;
+}
+
+void c_download_scheduler::order() {
+    std::stable_sort(items_.begin(), items_.end(), [](const download_item& a, const download_item& b) {
+        const bool a_queued = a.state == download_state::queued;
+        const bool b_queued = b.state == download_state::queued;
+        if (a_queued != b_queued)
+            return !a_queued;
+        if (a_queued && a.priority != b.priority)
+            return a.priority > b.priority;
+        return a.sequence < b.sequence;
+    });
+    order_dirty_ = false;
+}
+
+void c_download_scheduler::admit() {
+    if (order_dirty_)
+        order();
+    for (size_t i = 0; i < items_.size() && running_ < static_cast<size_t>(max_sessions_); i++) {
+        if (items_[i].state != download_state::queued)
+            continue;
+        items_[i].state = download_state::running;
+        running_++;
+        if (transport_)
+            transport_->start(items_[i]);
+    }
+}
+
+void c_download_scheduler::tick(uint64_t now_us) {
+    const uint64_t elapsed_us = last_tick_us_ && now_us > last_tick_us_ ? now_us - last_tick_us_ : 0;
+    last_tick_us_ = now_us;
+
+    auto complete = [](download_item& item) {
+        if (item.state == download_state::running && item.total_bytes && item.done_bytes >= item.total_bytes)
+            item.state = download_state::done;
+        return item.state != download_state::running;
+    };
+
+    auto retire = [&] {
+        bool retired = false;
+        for (size_t i = 0; i < items_.size();) {
+            download_item& item = items_[i];
+            if (item.state != download_state::done && item.state != download_state::failed) {
+                i++;
+                continue;
+            }
+            if (transport_)
+                transport_->stop(item);
+            running_--;
+            if (on_finished_)
+                on_finished_(item);
+            items_.erase(items_.begin() + i);
+            retired = true;
+        }
+        return retired;
+    };
+
+    retire();
+    admit();
+    if (!transport_ || !running_)
+        return;
+
+    transport_->advance(elapsed_us);
+    uint64_t remaining = bandwidth_
+        ? static_cast<uint64_t>(static_cast<double>(bandwidth_) * static_cast<double>(elapsed_us) / 1e6)
+        : c_download_transport::kUnlimited;
+
+    active_.clear();
+    for (size_t i = 0; i < items_.size(); i++) {
+        if (items_[i].state == download_state::running)
+            active_.push_back(i);
+    }
+
+    // Water-filling: equal shares; a session that moves less than its share leaves the
+    // round and the rest split what it left until the budget or the sessions run out.
+    while (!active_.empty() && remaining) {
+        const bool unlimited = remaining == c_download_transport::kUnlimited;
+        const uint64_t share = unlimited ? remaining : (std::max)(remaining / active_.size(), uint64_t{ 1 });
+        size_t kept = 0;
+        for (size_t index : active_) {
+            if (!remaining)
+                break;
+            const uint64_t grant = (std::min)(share, remaining);
+            const uint64_t moved = (std::min)(transport_->pump(items_[index], grant), grant);
+            if (!unlimited)
+                remaining -= moved;
+            if (moved == grant && !complete(items_[index]))
+                active_[kept++] = index;
+        }
+        active_.resize(kept);
+        if (unlimited)
+            break;
+    }
+
+    for (download_item& item : items_)
+        complete(item);
+    if (retire())
+        admit();
+}
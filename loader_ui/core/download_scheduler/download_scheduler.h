@@ -0,0 +1,148 @@
+#ifndef DOWNLOAD_SCHEDULER_HPP
+#define DOWNLOAD_SCHEDULER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class download_state : uint8_t {
+    queued,
+    running,
+    done,
+    failed
+};
+
+struct download_item {
+    uint64_t id = 0;
+    std::string file_id;
+    std::string name;
+    int priority = 0;                   // higher starts first; FIFO among equals
+    uint64_t sequence = 0;
+    download_state state = download_state::queued;
+    uint64_t done_bytes = 0;
+    uint64_t total_bytes = 0;           // 0 until the transport knows it
+    float fraction = -1.f;              // set by hosts that only report a fraction
+
+    float progress() const;
+};
+
+// Moves the bytes of one session. The scheduler calls start() when an item gets a session,
+// pump() every tick with its fair share of the bandwidth, and stop() when the item leaves
+// its session (finished, failed or cancelled). pump() adds to item.done_bytes and returns
+// the bytes it moved; an item is done once done_bytes reaches a non-zero total_bytes.
+class c_download_transport {
+public:
+    static constexpr uint64_t kUnlimited = UINT64_MAX;
+
+    virtual ~c_download_transport() = default;
+    virtual void start(download_item& item) = 0;
+    // Once per tick, before any pump().
+    virtual void advance(uint64_t elapsed_us) { (void)elapsed_us; }
+    virtual uint64_t pump(download_item& item, uint64_t budget) = 0;
+    virtual void stop(const download_item& item) = 0;
+};
+
+// The host's filestream callback. The host moves the bytes itself, so its sessions take no
+// part in the budget. Unless set_finish_on_return(false) says the host reports each file
+// through c_download_scheduler::report()/finish(), an item the callback did not fail is
+// done once the callback returns.
+class c_callback_transport : public c_download_transport {
+public:
+    explicit c_callback_transport(std::function<void(const std::string&)> start_fn) : start_fn_(std::move(start_fn)) {}
+
+    void set_finish_on_return(bool finish) { finish_on_return_ = finish; }
+
+    void start(download_item& item) override;
+    uint64_t pump(download_item&, uint64_t) override { return 0; }
+    void stop(const download_item&) override {}
+
+private:
+    std::function<void(const std::string&)> start_fn_;
+    bool finish_on_return_ = true;
+};
+
+// Stand-in for a remote file server: every file is `file_bytes` long and each session's
+// link carries at most `link_rate` bytes per second.
+class c_local_transport : public c_download_transport {
+public:
+    c_local_transport(uint64_t file_bytes, uint64_t link_rate) : file_bytes_(file_bytes), link_rate_(link_rate) {}
+
+    // Overrides the size of one file id.
+    void set_file_bytes(const std::string& file_id, uint64_t bytes) { sizes_[file_id] = bytes; }
+
+    void start(download_item& item) override;
+    void advance(uint64_t elapsed_us) override;
+    uint64_t pump(download_item& item, uint64_t budget) override;
+    void stop(const download_item& item) override { allowance_.erase(item.id); }
+
+private:
+    uint64_t file_bytes_;
+    uint64_t link_rate_;
+    std::unordered_map<std::string, uint64_t> sizes_;
+    std::unordered_map<uint64_t, uint64_t> allowance_;     // bytes each session's link can still carry
+};
+
+// Launch queue for several products. Up to max_sessions items run at once, admitted by
+// priority; the bandwidth budget of a tick is split max-min fairly between them: every
+// session gets an equal share, and what a session cannot use is shared among the rest.
+// Single-threaded; the transport is borrowed.
+class c_download_scheduler {
+public:
+    using finished_callback = std::function<void(const download_item&)>;
+
+    explicit c_download_scheduler(c_download_transport* transport, int max_sessions = 1);
+
+    void set_transport(c_download_transport* transport) { transport_ = transport; }
+    void set_max_sessions(int sessions) { max_sessions_ = sessions > 0 ? sessions : 1; }
+    int max_sessions() const { return max_sessions_; }
+    // Bytes per second shared by all sessions; 0 is unlimited.
+    void set_bandwidth(uint64_t bytes_per_second) { bandwidth_ = bytes_per_second; }
+    // Called from tick() for every item that completed or failed, before it is removed.
+    void set_finished_callback(finished_callback fn) { on_finished_ = std::move(fn); }
+
+    // Returns the new item's id, or 0 if file_id is empty or already queued or running.
+    uint64_t enqueue(const std::string& file_id, const std::string& name, int priority);
+    bool cancel(uint64_t id);
+    bool set_priority(uint64_t id, int priority);
+    // Cancels everything; running items are stopped.
+    void clear();
+
+    // Host progress for a running file id. A zero total keeps the last known total.
+    bool report(std::string_view file_id, uint64_t done_bytes, uint64_t total_bytes);
+    bool report_fraction(std::string_view file_id, float fraction);
+    bool finish(std::string_view file_id, bool ok);
+    // The longest-running item, for hosts that report without a file id.
+    const download_item* oldest_running() const;
+
+    // Starts queued items in free sessions, pumps the running ones and retires finished ones.
+    void tick(uint64_t now_us);
+
+    // Running items first, then queued items in the order they will start.
+    const std::vector<download_item>& items() const { return items_; }
+    const download_item* find(uint64_t id) const;
+    size_t running() const { return running_; }
+    bool empty() const { return items_.empty(); }
+
+private:
+    download_item* find_running(std::string_view file_id);
+    void admit();
+    void order();
+
+    c_download_transport* transport_;
+    int max_sessions_;
+    uint64_t bandwidth_ = 0;
+    finished_callback on_finished_;
+    std::vector<download_item> items_;
+    std::vector<size_t> active_;
+    size_t running_ = 0;
+    uint64_t next_id_ = 1;
+    uint64_t next_sequence_ = 0;
+    uint64_t last_tick_us_ = 0;
+    bool order_dirty_ = false;
+};
+
+#endif // DOWNLOAD_SCHEDULER_HPP
@@ -0,0 +1,193 @@
+#include "draw_cache.h"
+#include "../frame_hash/frame_hash.h"
+#include "../dep/imgui/imgui_internal.h"
+#include <climits>
+#include <cstring>
+
+namespace {
+    uint64_t float_bits(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    uint64_t point_bits(const ImVec2& p) {
+        return (float_bits(p.x) << 32) | float_bits(p.y);
+    }
+
+    // Hover, a held widget or a visible nav cursor anywhere inside the window changes
+    // what its widgets draw this frame.
+    bool is_interacting(ImGuiWindow* window) {
+        const ImGuiContext& g = *GImGui;
+        if (ImGui::IsWindowHovered(ImGuiHoveredFlags_ChildWindows | ImGuiHoveredFlags_AllowWhenBlockedByActiveItem))
+            return true;
+        if (g.ActiveId != 0 && g.ActiveIdWindow && ImGui::IsWindowChildOf(g.ActiveIdWindow, window, false, false))
+            return true;
+        if (g.NavId != 0 && !g.NavDisableHighlight && g.NavWindow && ImGui::IsWindowChildOf(g.NavWindow, window, false, false))
+            return true;
+        return false;
+    }
+}
+
+void c_draw_cache::begin_frame() {
+    last_frame_stats_ = frame_stats_;
+    frame_stats_ = draw_cache_stats{};
+    for (const entry& e : entries_) {
+        if (e.valid)
+            frame_stats_.cached_vertices += static_cast<int>(e.vertices.size());
+    }
+
+    // Anything but pointer motion may have changed widget state (text, toggles, focus).
+    const ImGuiContext& g = *GImGui;
+    for (const ImGuiInputEvent& event : g.InputEventsTrail) {
+        if (event.Type != ImGuiInputEventType_MousePos && event.Type != ImGuiInputEventType_MouseViewport) {
+            generation_++;
+            break;
+        }
+    }
+}
+
+void c_draw_cache::clear() {
+    IM_ASSERT(!open_);
+    entries_.clear();
+    capturing_ = nullptr;
+    generation_++;
+}
+
+c_draw_cache::entry& c_draw_cache::find_entry(ImGuiID window_id) {
+    for (entry& e : entries_) {
+        if (e.window_id == window_id)
+            return e;
+    }
+    entries_.emplace_back();
+    entries_.back().window_id = window_id;
+    return entries_.back();
+}
+
+bool c_draw_cache::begin(uint64_t inputs) {
+    IM_ASSERT(!open_ && "c_draw_cache regions cannot nest");
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    entry& e = find_entry(window->ID);
+
+    if (window->SkipItems || is_interacting(window)) {
+        e.valid = false;
+        capturing_ = nullptr;
+        open_ = true;
+        frame_stats_.live++;
+        return false;
+    }
+
+    const ImGuiContext& g = *GImGui;
+    c_frame_hasher hasher;
+    hasher.begin(generation_);
+    hasher.mix(inputs);
+    hasher.mix(point_bits(window->Pos));
+    hasher.mix(point_bits(window->Size));
+    hasher.mix(reinterpret_cast<uintptr_t>(g.Font));
+    hasher.mix(float_bits(g.FontSize));
+    hasher.mix(reinterpret_cast<uintptr_t>(g.IO.Fonts->TexID));
+    // Every color and style variable, including pushed ones; about 1 KB per cached window.
+    hasher.mix(frame_hash_bytes(&g.Style, sizeof(g.Style), 0));
+    const uint64_t key = hasher.value();
+
+    if (e.valid && e.key == key) {
+        replay(e, window->DrawList);
+        window->DC.CursorPos = e.cursor_pos;
+        window->DC.CursorMaxPos = ImMax(window->DC.CursorMaxPos, e.cursor_max_pos);
+        window->DC.IdealMaxPos = ImMax(window->DC.IdealMaxPos, e.ideal_max_pos);
+        frame_stats_.hits++;
+        return true;
+    }
+
+    capturing_ = &e;
+    capture_key_ = key;
+    capture_vtx_start_ = window->DrawList->VtxBuffer.Size;
+    capture_idx_start_ = window->DrawList->IdxBuffer.Size;
+    open_ = true;
+    frame_stats_.captures++;
+    return false;
+}
+
+void c_draw_cache::end() {
+    IM_ASSERT(open_ && "c_draw_cache::end() without a begin() returning false");
+    open_ = false;
+    if (!capturing_)
+        return;
+
+    entry& e = *capturing_;
+    capturing_ = nullptr;
+    ImGuiWindow* window = ImGui::GetCurrentWindow();
+    IM_ASSERT(window->ID == e.window_id && "c_draw_cache::end() called in a different window");
+
+    e.valid = capture(e, window->DrawList);
+    if (e.valid) {
+        e.key = capture_key_;
+        e.cursor_pos = window->DC.CursorPos;
+        e.cursor_max_pos = window->DC.CursorMaxPos;
+        e.ideal_max_pos = window->DC.IdealMaxPos;
+    }
+}
+
+bool c_draw_cache::capture(entry& e, const ImDrawList* list) {
+    e.segments.clear();
+    e.vertices.clear();
+    e.indices.clear();
+
+    const int vtx_end = list->VtxBuffer.Size;
+    for (const ImDrawCmd& cmd : list->CmdBuffer) {
+        const int cmd_end = static_cast<int>(cmd.IdxOffset + cmd.ElemCount);
+        if (cmd_end <= capture_idx_start_)
+            continue;
+        // Callbacks have effects we cannot replay.
+        if (cmd.UserCallback != nullptr)
+            return false;
+
+        const int first = ImMax(static_cast<int>(cmd.IdxOffset), capture_idx_start_);
+        if (first >= cmd_end)
+            continue;
+
+        int vtx_min = INT_MAX;
+        int vtx_max = -1;
+        for (int i = first; i < cmd_end; i++) {
+            const int v = static_cast<int>(cmd.VtxOffset) + list->IdxBuffer[i];
+            if (v < capture_vtx_start_ || v >= vtx_end)
+                return false;
+            vtx_min = ImMin(vtx_min, v);
+            vtx_max = ImMax(vtx_max, v);
+        }
+
+        segment seg;
+        seg.clip_rect = cmd.ClipRect;
+        seg.texture = cmd.TextureId;
+        seg.vtx_start = static_cast<int>(e.vertices.size());
+        seg.vtx_count = vtx_max - vtx_min + 1;
+        seg.idx_start = static_cast<int>(e.indices.size());
+        seg.idx_count = cmd_end - first;
+        e.vertices.insert(e.vertices.end(), list->VtxBuffer.Data + vtx_min, list->VtxBuffer.Data + vtx_max + 1);
+        for (int i = first; i < cmd_end; i++)
+            e.indices.push_back(static_cast<ImDrawIdx>(cmd.VtxOffset + list->IdxBuffer[i] - vtx_min));
+        e.segments.push_back(seg);
+    }
+    return true;
+}
+
+void c_draw_cache::replay(const entry& e, ImDrawList* list) {
+    for (const segment& seg : e.segments) {
+        list->PushClipRect(ImVec2(seg.clip_rect.x, seg.clip_rect.y), ImVec2(seg.clip_rect.z, seg.clip_rect.w), false);
+        list->PushTextureID(seg.texture);
+
+        // PrimReserve may start a new VtxOffset, so the base index is read after it.
+        list->PrimReserve(seg.idx_count, seg.vtx_count);
+        memcpy(list->_VtxWritePtr, e.vertices.data() + seg.vtx_start, seg.vtx_count * sizeof(ImDrawVert));
+        const unsigned int base = list->_VtxCurrentIdx;
+        const ImDrawIdx* src = e.indices.data() + seg.idx_start;
+        for (int i = 0; i < seg.idx_count; i++)
+            list->_IdxWritePtr[i] = static_cast<ImDrawIdx>(base + src[i]);
+        list->_VtxWritePtr += seg.vtx_count;
+        list->_IdxWritePtr += seg.idx_count;
+        list->_VtxCurrentIdx += seg.vtx_count;
+
+        list->PopTextureID();
+        list->PopClipRect();
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef DRAW_CACHE_HPP
+#define DRAW_CACHE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "../dep/imgui/imgui.h"
+
+struct draw_cache_stats {
+    int hits = 0;           // windows replayed from cache
+    int captures = 0;       // windows submitted and (re)captured
+    int live = 0;           // windows submitted uncached because the user interacts with them
+    int cached_vertices = 0;
+};
+
+// Retained geometry for windows whose content rarely changes. Inside a Begin/End or
+// BeginChild/EndChild pair:
+//
+//     if (!cache.begin()) {
+//         ...widgets...
+//         cache.end();
+//     }
+//
+// begin() replays the draw commands captured the last time the window was submitted
+// and returns true when nothing that could change them moved: same generation, window
+// rect, font, style (colors and variables, pushed ones included) and `inputs`, and the
+// window is neither hovered nor holding the active or keyboard-nav item. Otherwise the
+// caller submits its widgets and end() captures the result for the next frame.
+//
+// invalidate() bumps the generation; call it whenever state drawn inside cached
+// windows changes. Keyboard, text and mouse button input bump it automatically.
+class c_draw_cache {
+public:
+    void begin_frame();
+    bool begin(uint64_t inputs = 0);
+    void end();
+
+    void invalidate() { generation_++; }
+    uint64_t generation() const { return generation_; }
+    void clear();
+
+    const draw_cache_stats& frame_stats() const { return frame_stats_; }
+    const draw_cache_stats& last_frame_stats() const { return last_frame_stats_; }
+
+private:
+    // One command's worth of geometry, indices local to its own vertices.
+    struct segment {
+        ImVec4 clip_rect;
+        ImTextureID texture;
+        int vtx_start;
+        int vtx_count;
+        int idx_start;
+        int idx_count;
+    };
+
+    struct entry {
+        ImGuiID window_id = 0;
+        uint64_t key = 0;
+        bool valid = false;
+        ImVec2 cursor_pos{};
+        ImVec2 cursor_max_pos{};
+        ImVec2 ideal_max_pos{};
+        std::vector<segment> segments;
+        std::vector<ImDrawVert> vertices;
+        std::vector<ImDrawIdx> indices;
+    };
+
+    entry& find_entry(ImGuiID window_id);
+    bool capture(entry& e, const ImDrawList* list);
+    void replay(const entry& e, ImDrawList* list);
+
+    std::vector<entry> entries_;
+    uint64_t generation_ = 0;
+
+    // Open capture between begin() and end().
+    entry* capturing_ = nullptr;
+    uint64_t capture_key_ = 0;
+    int capture_vtx_start_ = 0;
+    int capture_idx_start_ = 0;
+    bool open_ = false;
+
+    draw_cache_stats frame_stats_{};
+    draw_cache_stats last_frame_stats_{};
+};
+
+#endif // DRAW_CACHE_HPP
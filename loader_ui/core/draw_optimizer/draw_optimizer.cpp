@@ -0,0 +1,141 @@
+#include "draw_optimizer.h"
+#include <cstring>
+
+static bool is_clipped_out(const ImVec4& clip, const ImVec4& display) {
+    if (clip.z <= clip.x || clip.w <= clip.y)
+        return true;
+    return clip.x >= display.z || clip.z <= display.x || clip.y >= display.w || clip.w <= display.y;
+}
+
+static bool same_render_state(const ImDrawCmd& a, const ImDrawCmd& b) {
+    return a.TextureId == b.TextureId
+        && a.VtxOffset == b.VtxOffset
+        && a.ClipRect.x == b.ClipRect.x && a.ClipRect.y == b.ClipRect.y
+        && a.ClipRect.z == b.ClipRect.z && a.ClipRect.w == b.ClipRect.w;
+}
+
+c_draw_optimizer::~c_draw_optimizer() {
+    // Lists still alive here belong to a context that is already gone; their memory went
+    // with the allocator, so only forget them.
+    pool_.clear();
+}
+
+void c_draw_optimizer::begin_frame() {
+    last_frame_stats_ = frame_stats_;
+    frame_stats_ = draw_optimizer_stats{};
+    pool_used_ = 0;
+}
+
+void c_draw_optimizer::release() {
+    for (ImDrawList* list : pool_) {
+        IM_DELETE(list);
+    }
+    pool_.clear();
+    pool_used_ = 0;
+}
+
+ImDrawList* c_draw_optimizer::acquire_list() {
+    if (pool_used_ == pool_.size()) {
+        pool_.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+    }
+
+    ImDrawList* list = pool_[pool_used_++];
+    list->CmdBuffer.resize(0);
+    list->VtxBuffer.resize(0);
+    list->IdxBuffer.resize(0);
+    return list;
+}
+
+void c_draw_optimizer::optimize(ImDrawData* draw_data) {
+    if (!draw_data || !draw_data->Valid || draw_data->CmdListsCount == 0)
+        return;
+
+    const ImVec4 display(draw_data->DisplayPos.x, draw_data->DisplayPos.y,
+        draw_data->DisplayPos.x + draw_data->DisplaySize.x, draw_data->DisplayPos.y + draw_data->DisplaySize.y);
+
+    // With 16-bit indices a rebased index must stay below 64K; past that a new VtxOffset segment starts.
+    constexpr unsigned int kSegmentLimit = sizeof(ImDrawIdx) == 2 ? 0x10000u : 0xFFFFFFFFu;
+
+    ImDrawList* out = acquire_list();
+    out->Flags = draw_data->CmdLists[0]->Flags;
+    out->VtxBuffer.reserve(draw_data->TotalVtxCount);
+    out->IdxBuffer.reserve(draw_data->TotalIdxCount);
+
+    frame_stats_.lists_before += draw_data->CmdListsCount;
+
+    unsigned int segment_start = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        const ImDrawList* src = draw_data->CmdLists[n];
+        const unsigned int vtx_base = static_cast<unsigned int>(out->VtxBuffer.Size);
+
+        if (src->VtxBuffer.Size > 0) {
+            out->VtxBuffer.resize(out->VtxBuffer.Size + src->VtxBuffer.Size);
+            memcpy(out->VtxBuffer.Data + vtx_base, src->VtxBuffer.Data, src->VtxBuffer.Size * sizeof(ImDrawVert));
+        }
+
+        for (int cmd_i = 0; cmd_i < src->CmdBuffer.Size; cmd_i++) {
+            const ImDrawCmd& cmd = src->CmdBuffer[cmd_i];
+            const bool is_callback = cmd.UserCallback != nullptr;
+
+            if (!is_callback) {
+                if (cmd.ClipRect.z > cmd.ClipRect.x && cmd.ClipRect.w > cmd.ClipRect.y)
+                    frame_stats_.draw_calls_before++;
+                if (cmd.ElemCount == 0) {
+                    frame_stats_.dropped_empty++;
+                    continue;
+                }
+                if (is_clipped_out(cmd.ClipRect, display)) {
+                    frame_stats_.dropped_clipped++;
+                    continue;
+                }
+            }
+
+            // Keep every index this command can reach within the current segment.
+            const unsigned int cmd_vtx_start = vtx_base + cmd.VtxOffset;
+            const unsigned int src_vtx_end = vtx_base + static_cast<unsigned int>(src->VtxBuffer.Size);
+            if (src_vtx_end - segment_start > kSegmentLimit)
+                segment_start = cmd_vtx_start;
+            const unsigned int delta = cmd_vtx_start - segment_start;
+
+            ImDrawCmd placed = cmd;
+            placed.VtxOffset = segment_start;
+            placed.IdxOffset = static_cast<unsigned int>(out->IdxBuffer.Size);
+
+            if (cmd.ElemCount > 0) {
+                out->IdxBuffer.resize(out->IdxBuffer.Size + static_cast<int>(cmd.ElemCount));
+                const ImDrawIdx* idx_src = src->IdxBuffer.Data + cmd.IdxOffset;
+                ImDrawIdx* idx_dst = out->IdxBuffer.Data + placed.IdxOffset;
+                if (delta == 0) {
+                    memcpy(idx_dst, idx_src, cmd.ElemCount * sizeof(ImDrawIdx));
+                }
+                else {
+                    for (unsigned int i = 0; i < cmd.ElemCount; i++)
+                        idx_dst[i] = static_cast<ImDrawIdx>(idx_src[i] + delta);
+                }
+            }
+
+            if (!is_callback && out->CmdBuffer.Size > 0) {
+                ImDrawCmd& last = out->CmdBuffer.back();
+                if (last.UserCallback == nullptr && same_render_state(last, placed)
+                    && last.IdxOffset + last.ElemCount == placed.IdxOffset) {
+                    last.ElemCount += placed.ElemCount;
+                    frame_stats_.merged++;
+                    continue;
+                }
+            }
+
+            out->CmdBuffer.push_back(placed);
+        }
+    }
+
+    for (const ImDrawCmd& cmd : out->CmdBuffer)
+        if (cmd.UserCallback == nullptr)
+            frame_stats_.draw_calls_after++;
+
+    draw_data->CmdLists.resize(0);
+    draw_data->CmdLists.push_back(out);
+    draw_data->CmdListsCount = 1;
+    draw_data->TotalVtxCount = out->VtxBuffer.Size;
+    draw_data->TotalIdxCount = out->IdxBuffer.Size;
+    frame_stats_.lists_after += 1;
+}
@@ -0,0 +1,51 @@
+#ifndef DRAW_OPTIMIZER_HPP
+#define DRAW_OPTIMIZER_HPP
+
+#include <vector>
+#include "../dep/imgui/imgui.h"
+
+struct draw_optimizer_stats {
+    int lists_before = 0;
+    int lists_after = 0;
+    int draw_calls_before = 0;
+    int draw_calls_after = 0;
+    int dropped_empty = 0;
+    int dropped_clipped = 0;
+    int merged = 0;
+};
+
+// Post-ImGui::Render pass. Every ImDrawData handed to optimize() is rewritten to point
+// at a single combined ImDrawList owned by the optimizer: vertices are concatenated,
+// indices are rebased so that commands from different source lists share a VtxOffset
+// (a new one starts only past the 16-bit index range), empty and fully clipped commands are
+// dropped, and adjacent commands with the same texture and clip rect are merged into
+// one draw call. User callbacks are kept in place and never merged across.
+//
+// The combined lists stay valid until the next begin_frame().
+class c_draw_optimizer {
+public:
+    c_draw_optimizer() = default;
+    ~c_draw_optimizer();
+
+    c_draw_optimizer(const c_draw_optimizer&) = delete;
+    c_draw_optimizer& operator=(const c_draw_optimizer&) = delete;
+
+    void begin_frame();
+    void optimize(ImDrawData* draw_data);
+    // Must run while the ImGui context that created the lists is still alive.
+    void release();
+
+    // Accumulated over every optimize() call since begin_frame().
+    const draw_optimizer_stats& frame_stats() const { return frame_stats_; }
+    const draw_optimizer_stats& last_frame_stats() const { return last_frame_stats_; }
+
+private:
+    ImDrawList* acquire_list();
+
+    std::vector<ImDrawList*> pool_;
+    size_t pool_used_ = 0;
+    draw_optimizer_stats frame_stats_{};
+    draw_optimizer_stats last_frame_stats_{};
+};
+
+#endif // DRAW_OPTIMIZER_HPP
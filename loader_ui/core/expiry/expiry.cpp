@@ -0,0 +1,173 @@
+#include "expiry.h"
+#include <charconv>
+#include <chrono>
+#include <cstring>
+
+namespace {
+    constexpr int64_t kUsPerSecond = 1000000;
+
+    // Reads exactly `count` digits.
+    bool read_digits(const char* p, int count, int& out) {
+        int value = 0;
+        for (int i = 0; i < count; i++) {
+            const unsigned digit = static_cast<unsigned>(p[i] - '0');
+            if (digit > 9)
+                return false;
+            value = value * 10 + static_cast<int>(digit);
+        }
+        out = value;
+        return true;
+    }
+
+    bool is_leap_year(int year) {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    int days_in_month(int year, int month) {
+        static constexpr int kDays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+        return month == 2 && is_leap_year(year) ? 29 : kDays[month - 1];
+    }
+
+    // Days since 1970-01-01 of a proleptic Gregorian date.
+    int64_t days_from_civil(int year, int month, int day) {
+        year -= month <= 2;
+        const int era = (year >= 0 ? year : year - 399) / 400;
+        const int year_of_era = year - era * 400;
+        const int day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return static_cast<int64_t>(era) * 146097 + day_of_era - 719468;
+    }
+
+    char* put_two_digits(char* out, int64_t value) {
+        out[0] = static_cast<char>('0' + value / 10);
+        out[1] = static_cast<char>('0' + value % 10);
+        return out + 2;
+    }
+}
+
+bool parse_expiry_us(std::string_view text, int64_t& out_us) {
+    // 0123456789012345678
+    // YYYY-MM-DD HH:MM:SS
+    if (text.size() < 19)
+        return false;
+    const char* p = text.data();
+    if (p[4] != '-' || p[7] != '-' || (p[10] != ' ' && p[10] != 'T') || p[13] != ':' || p[16] != ':')
+        return false;
+
+    int year, month, day, hour, minute, second;
+    if (!read_digits(p, 4, year) || !read_digits(p + 5, 2, month) || !read_digits(p + 8, 2, day) ||
+        !read_digits(p + 11, 2, hour) || !read_digits(p + 14, 2, minute) || !read_digits(p + 17, 2, second))
+        return false;
+    if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month) ||
+        hour > 23 || minute > 59 || second > 60)
+        return false;
+
+    int64_t micros = 0;
+    size_t pos = 19;
+    if (pos < text.size() && text[pos] == '.') {
+        pos++;
+        int digits = 0;
+        for (; pos < text.size() && digits < 6; pos++, digits++) {
+            const unsigned digit = static_cast<unsigned>(text[pos] - '0');
+            if (digit > 9)
+                break;
+            micros = micros * 10 + digit;
+        }
+        if (digits == 0)
+            return false;
+        for (; digits < 6; digits++)
+            micros *= 10;
+        // Finer fractions are truncated.
+        while (pos < text.size() && static_cast<unsigned>(text[pos] - '0') <= 9)
+            pos++;
+    }
+    if (pos < text.size() && text[pos] == 'Z')
+        pos++;
+    if (pos != text.size())
+        return false;
+
+    const int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    out_us = seconds * kUsPerSecond + micros;
+    return true;
+}
+
+int64_t wall_clock_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+size_t format_countdown(int64_t remaining_seconds, char* out) {
+    const int64_t days = remaining_seconds / 86400;
+    const int64_t hours = remaining_seconds / 3600 % 24;
+    const int64_t minutes = remaining_seconds / 60 % 60;
+    const int64_t seconds = remaining_seconds % 60;
+
+    char* p = std::to_chars(out, out + 20, days).ptr;
+    *p++ = 'd';
+    *p++ = ' ';
+    p = put_two_digits(p, hours);
+    *p++ = 'h';
+    *p++ = ' ';
+    p = put_two_digits(p, minutes);
+    *p++ = 'm';
+    *p++ = ' ';
+    p = put_two_digits(p, seconds);
+    *p++ = 's';
+    return static_cast<size_t>(p - out);
+}
+
+void c_expiry_countdown::set(std::string_view expires_at) {
+    raw_.clear();
+    shown_seconds_ = -2;
+    expires_us_ = 0;
+    if (expires_at.empty()) {
+        state_ = state::empty;
+        set_text("-");
+    }
+    else if (parse_expiry_us(expires_at, expires_us_)) {
+        state_ = state::counting;
+    }
+    else {
+        state_ = state::invalid;
+        raw_.assign(expires_at.data(), expires_at.size());
+    }
+}
+
+const char* c_expiry_countdown::text(int64_t now_us) {
+    if (state_ == state::invalid)
+        return raw_.c_str();
+    if (state_ == state::empty)
+        return text_;
+
+    const int64_t remaining_us = expires_us_ - now_us;
+    const int64_t seconds = remaining_us > 0 ? remaining_us / kUsPerSecond : -1;
+    if (seconds != shown_seconds_) {
+        shown_seconds_ = seconds;
+        if (seconds < 0) {
+            set_text("Expired");
+        }
+        else {
+            text_[format_countdown(seconds, text_)] = '\0';
+            renders_++;
+        }
+    }
+    return text_;
+}
+
+int64_t c_expiry_countdown::next_change_us(int64_t now_us) const {
+    if (state_ != state::counting)
+        return kNever;
+    const int64_t remaining_us = expires_us_ - now_us;
+    if (remaining_us <= 0)
+        return kNever;
+    // The shown value is floor(remaining / 1 s); it drops when remaining falls below
+    // that many whole seconds, or to "Expired" at the deadline itself.
+    const int64_t seconds = remaining_us / kUsPerSecond;
+    return seconds == 0 ? expires_us_ : expires_us_ - seconds * kUsPerSecond + 1;
+}
+
+void c_expiry_countdown::set_text(std::string_view text) {
+    const size_t length = text.size() < kMaxCountdownChars ? text.size() : kMaxCountdownChars;
+    memcpy(text_, text.data(), length);
+    text_[length] = '\0';
+    renders_++;
+}
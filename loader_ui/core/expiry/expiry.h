@@ -0,0 +1,51 @@
+#ifndef EXPIRY_HPP
+#define EXPIRY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Parses "YYYY-MM-DD HH:MM:SS[.f]" (UTC, up to six fraction digits, 'T' also accepted
+// as the separator) into microseconds since the Unix epoch. Fields must be in range.
+bool parse_expiry_us(std::string_view text, int64_t& out_us);
+
+// Wall clock in microseconds since the Unix epoch.
+int64_t wall_clock_us();
+
+// "Nd HHh MMm SSs" without a terminator; out must hold kMaxCountdownChars.
+constexpr size_t kMaxCountdownChars = 32;
+size_t format_countdown(int64_t remaining_seconds, char* out);
+
+// Countdown text of one expiry timestamp. The timestamp is parsed once by set(); text()
+// only reformats when the displayed second changes, into an inline buffer.
+class c_expiry_countdown {
+public:
+    static constexpr int64_t kNever = INT64_MAX;
+
+    void set(std::string_view expires_at);
+
+    // "-" without a timestamp, the timestamp itself if it does not parse, "Expired" once
+    // it has passed, else the time left.
+    const char* text(int64_t now_us);
+    // Wall-clock time at which text() next changes; kNever once it is final.
+    int64_t next_change_us(int64_t now_us) const;
+
+    bool valid() const { return state_ == state::counting; }
+    int64_t expires_us() const { return expires_us_; }
+    uint32_t renders() const { return renders_; }
+
+private:
+    enum class state : uint8_t { empty, invalid, counting };
+
+    void set_text(std::string_view text);
+
+    state state_ = state::empty;
+    int64_t expires_us_ = 0;
+    int64_t shown_seconds_ = -2;        // -1 once "Expired" is shown
+    uint32_t renders_ = 0;
+    char text_[kMaxCountdownChars + 1] = "-";
+    std::string raw_;                   // unparsable timestamps only
+};
+
+#endif // EXPIRY_HPP
@@ -0,0 +1,296 @@
+#include "filestream_session.h"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace {
+    constexpr char kMagic[4] = { 'L', 'U', 'C', 'K' };
+
+    // Adds [start, end) to sorted, disjoint spans and returns the bytes it newly covered.
+    uint64_t add_span(std::vector<byte_range>& spans, uint64_t start, uint64_t end) {
+        size_t first = 0;
+        while (first < spans.size() && spans[first].offset + spans[first].length < start)
+            first++;
+        uint64_t low = start;
+        uint64_t high = end;
+        uint64_t covered = 0;
+        size_t last = first;
+        for (; last < spans.size() && spans[last].offset <= high; last++) {
+            low = (std::min)(low, spans[last].offset);
+            high = (std::max)(high, spans[last].offset + spans[last].length);
+            covered += spans[last].length;
+        }
+        spans.erase(spans.begin() + first, spans.begin() + last);
+        spans.insert(spans.begin() + first, byte_range{ low, high - low });
+        return high - low - covered;
+    }
+}
+
+void c_chunk_checkpoint::reset(uint64_t file_bytes, uint32_t chunk_bytes) {
+    file_bytes_ = file_bytes;
+    chunk_bytes_ = chunk_bytes ? chunk_bytes : 1;
+    chunk_count_ = static_cast<size_t>((file_bytes + chunk_bytes_ - 1) / chunk_bytes_);
+    marked_ = 0;
+    done_bytes_ = 0;
+    bits_.assign((chunk_count_ + 63) / 64, 0);
+    partial_.clear();
+}
+
+uint64_t c_chunk_checkpoint::chunk_size(size_t chunk) const {
+    return (std::min)(static_cast<uint64_t>(chunk_bytes_), file_bytes_ - static_cast<uint64_t>(chunk) * chunk_bytes_);
+}
+
+bool c_chunk_checkpoint::load(const std::filesystem::path& path, std::string_view file_id) {
+    reset(0, 1);
+
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    const std::streamoff size = in.tellg();
+    if (size < static_cast<std::streamoff>(sizeof(header)))
+        return false;
+    std::vector<char> bytes(static_cast<size_t>(size));
+    in.seekg(0);
+    if (!in.read(bytes.data(), size))
+        return false;
+
+    header head;
+    memcpy(&head, bytes.data(), sizeof(head));
+    if (memcmp(head.magic, kMagic, sizeof(kMagic)) != 0 || head.version != kVersion ||
+        !head.file_bytes || !head.chunk_bytes || head.id_length != file_id.size())
+        return false;
+    const uint64_t chunks = (head.file_bytes + head.chunk_bytes - 1) / head.chunk_bytes;
+    const uint64_t words = (chunks + 63) / 64;
+    if (static_cast<uint64_t>(size) != sizeof(header) + head.id_length + words * sizeof(uint64_t) ||
+        memcmp(bytes.data() + sizeof(header), file_id.data(), file_id.size()) != 0)
+        return false;
+
+    reset(head.file_bytes, head.chunk_bytes);
+    memcpy(bits_.data(), bytes.data() + sizeof(header) + head.id_length, bits_.size() * sizeof(uint64_t));
+    // Bits past the last chunk mean the file is not ours.
+    if ((chunk_count_ & 63) && bits_.back() >> (chunk_count_ & 63)) {
+        reset(0, 1);
+        return false;
+    }
+    for (uint64_t word : bits_)
+        marked_ += static_cast<size_t>(std::popcount(word));
+    done_bytes_ = static_cast<uint64_t>(marked_) * chunk_bytes_;
+    if (has(chunk_count_ - 1))
+        done_bytes_ -= chunk_bytes_ - chunk_size(chunk_count_ - 1);
+    return true;
+}
+
+bool c_chunk_checkpoint::save(const std::filesystem::path& path, std::string_view file_id) const {
+    header head{};
+    memcpy(head.magic, kMagic, sizeof(kMagic));
+    head.version = kVersion;
+    head.file_bytes = file_bytes_;
+    head.chunk_bytes = chunk_bytes_;
+    head.id_length = static_cast<uint32_t>(file_id.size());
+
+    std::filesystem::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        out.write(reinterpret_cast<const char*>(&head), sizeof(head));
+        out.write(file_id.data(), static_cast<std::streamsize>(file_id.size()));
+        out.write(reinterpret_cast<const char*>(bits_.data()), static_cast<std::streamsize>(bits_.size() * sizeof(uint64_t)));
+        if (!out)
+            return false;
+    }
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    return !error;
+}
+
+uint32_t c_chunk_checkpoint::mark(uint64_t offset, uint64_t length) {
+    if (!known() || !length || offset >= file_bytes_)
+        return 0;
+    const uint64_t end = length > file_bytes_ - offset ? file_bytes_ : offset + length;
+
+    uint32_t completed = 0;
+    const size_t last = static_cast<size_t>((end - 1) / chunk_bytes_);
+    for (size_t chunk = static_cast<size_t>(offset / chunk_bytes_); chunk <= last; chunk++) {
+        if (has(chunk))
+            continue;
+        const uint64_t chunk_start = static_cast<uint64_t>(chunk) * chunk_bytes_;
+        const uint64_t size = chunk_size(chunk);
+        const uint64_t piece_start = (std::max)(offset, chunk_start) - chunk_start;
+        const uint64_t piece_end = (std::min)(end, chunk_start + size) - chunk_start;
+
+        // Whole chunks skip the span list; pieces of one are merged in whatever order.
+        auto it = partial_.find(chunk);
+        if (it == partial_.end() && piece_start == 0 && piece_end == size) {
+            done_bytes_ += size;
+        }
+        else {
+            std::vector<byte_range>& spans = it != partial_.end() ? it->second : partial_[chunk];
+            done_bytes_ += add_span(spans, piece_start, piece_end);
+            if (spans.size() != 1 || spans[0].offset != 0 || spans[0].length != size)
+                continue;
+            partial_.erase(chunk);
+        }
+        bits_[chunk >> 6] |= uint64_t{ 1 } << (chunk & 63);
+        marked_++;
+        completed++;
+    }
+    return completed;
+}
+
+void c_chunk_checkpoint::missing(std::vector<byte_range>& out) const {
+    out.clear();
+    if (!known()) {
+        out.push_back({ 0, 0 });
+        return;
+    }
+
+    size_t chunk = 0;
+    while (chunk < chunk_count_) {
+        while (chunk < chunk_count_ && has(chunk))
+            chunk += (chunk & 63) == 0 && bits_[chunk >> 6] == ~uint64_t{ 0 } ? 64 : 1;
+        if (chunk >= chunk_count_)
+            break;
+        const size_t first = chunk;
+        while (chunk < chunk_count_ && !has(chunk))
+            chunk += (chunk & 63) == 0 && bits_[chunk >> 6] == 0 ? 64 : 1;
+        chunk = (std::min)(chunk, chunk_count_);
+
+        // A partial first chunk resumes after its received prefix.
+        uint64_t begin = static_cast<uint64_t>(first) * chunk_bytes_;
+        auto it = partial_.find(first);
+        if (it != partial_.end() && !it->second.empty() && it->second[0].offset == 0)
+            begin += it->second[0].length;
+        const uint64_t end = (std::min)(static_cast<uint64_t>(chunk) * chunk_bytes_, file_bytes_);
+        out.push_back({ begin, end - begin });
+    }
+}
+
+std::filesystem::path c_filestream_transport::checkpoint_path(std::string_view file_id) const {
+    // FNV-1a keeps arbitrary ids out of the file name.
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : file_id) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.ckpt", static_cast<unsigned long long>(hash));
+    return directory_ / name;
+}
+
+c_filestream_transport::session* c_filestream_transport::find_running(std::string_view file_id) {
+    auto it = sessions_.find(std::string(file_id));
+    return it != sessions_.end() && it->second.running ? &it->second : nullptr;
+}
+
+const c_chunk_checkpoint* c_filestream_transport::checkpoint(std::string_view file_id) const {
+    auto it = sessions_.find(std::string(file_id));
+    return it != sessions_.end() ? &it->second.checkpoint : nullptr;
+}
+
+void c_filestream_transport::request(session& s) {
+    // Local: the host may answer, and even re-request, from inside the callback.
+    std::vector<byte_range> ranges;
+    s.checkpoint.missing(ranges);
+    s.request_delivered = false;
+    s.request_end = 0;
+    if (!ranges.empty()) {
+        const byte_range& tail = ranges.back();
+        s.request_end = tail.length ? tail.offset + tail.length : s.checkpoint.known() ? s.checkpoint.file_bytes() : UINT64_MAX;
+    }
+    if (request_)
+        request_(s.file_id, ranges);
+}
+
+void c_filestream_transport::save(session& s) {
+    s.unsaved_chunks = 0;
+    if (directory_.empty() || !s.checkpoint.known())
+        return;
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    if (s.checkpoint.save(checkpoint_path(s.file_id), s.file_id) && saved_)
+        saved_(s.file_id, s.checkpoint);
+}
+
+void c_filestream_transport::start(download_item& item) {
+    session& s = sessions_[item.file_id];
+    if (s.file_id.empty()) {
+        s.file_id = item.file_id;
+        if (!directory_.empty())
+            s.checkpoint.load(checkpoint_path(item.file_id), item.file_id);
+    }
+    s.running = true;
+    s.failures = 0;
+    item.total_bytes = s.checkpoint.file_bytes();
+    item.done_bytes = s.checkpoint.done_bytes();
+    // Sent even when nothing is missing, so the host still hears about the launch.
+    request(s);
+}
+
+void c_filestream_transport::stop(const download_item& item) {
+    auto it = sessions_.find(item.file_id);
+    if (it == sessions_.end())
+        return;
+    if (it->second.checkpoint.complete()) {
+        if (!directory_.empty()) {
+            std::error_code error;
+            std::filesystem::remove(checkpoint_path(item.file_id), error);
+        }
+        sessions_.erase(it);
+        return;
+    }
+    save(it->second);
+    it->second.running = false;
+}
+
+const c_chunk_checkpoint* c_filestream_transport::on_chunk(std::string_view file_id, uint64_t offset, uint64_t length, uint64_t total_bytes) {
+    session* s = find_running(file_id);
+    if (!s)
+        return nullptr;
+
+    if (total_bytes && total_bytes != s->checkpoint.file_bytes()) {
+        const bool changed = s->checkpoint.known();
+        s->checkpoint.reset(total_bytes, chunk_bytes_);
+        if (changed)
+            request(*s);
+        else if (s->request_end == UINT64_MAX)
+            s->request_end = total_bytes;
+    }
+    if (length && offset + length >= s->request_end)
+        s->request_delivered = true;
+    const uint32_t completed = s->checkpoint.mark(offset, length);
+    if (completed) {
+        s->failures = 0;
+        s->unsaved_chunks += completed;
+        if (s->unsaved_chunks >= kSaveEveryChunks)
+            save(*s);
+    }
+    return &s->checkpoint;
+}
+
+int c_filestream_transport::on_failure(std::string_view file_id) {
+    session* s = find_running(file_id);
+    if (!s)
+        return 0;
+    s->failures++;
+    s->request_delivered = false;
+    save(*s);
+    return s->failures;
+}
+
+bool c_filestream_transport::drained(std::string_view file_id) const {
+    auto it = sessions_.find(std::string(file_id));
+    return it != sessions_.end() && it->second.running && it->second.request_delivered && !it->second.checkpoint.complete();
+}
+
+bool c_filestream_transport::resume(std::string_view file_id) {
+    session* s = find_running(file_id);
+    if (!s)
+        return false;
+    request(*s);
+    return true;
+}
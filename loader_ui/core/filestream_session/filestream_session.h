@@ -0,0 +1,130 @@
+#ifndef FILESTREAM_SESSION_HPP
+#define FILESTREAM_SESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../download_scheduler/download_scheduler.h"
+
+// A zero length runs to the end of the file.
+struct byte_range {
+    uint64_t offset;
+    uint64_t length;
+};
+
+// Which fixed-size chunks of one file have arrived. Saved as a header, the file id and a
+// bitmap, so a relaunch asks only for what is missing.
+class c_chunk_checkpoint {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    void reset(uint64_t file_bytes, uint32_t chunk_bytes);
+    // False, leaving the checkpoint empty, if the file is missing, corrupt or for another id.
+    bool load(const std::filesystem::path& path, std::string_view file_id);
+    // Writes to a temporary file and renames it over `path`.
+    bool save(const std::filesystem::path& path, std::string_view file_id) const;
+
+    // Records the bytes [offset, offset + length). A chunk counts once all of it arrived,
+    // in any order. Returns the chunks it completed.
+    uint32_t mark(uint64_t offset, uint64_t length);
+    bool has(size_t chunk) const { return (bits_[chunk >> 6] >> (chunk & 63)) & 1; }
+    // Coalesced runs of chunks not yet marked.
+    void missing(std::vector<byte_range>& out) const;
+
+    bool known() const { return file_bytes_ != 0; }
+    bool complete() const { return known() && marked_ == chunk_count_; }
+    uint64_t file_bytes() const { return file_bytes_; }
+    uint32_t chunk_bytes() const { return chunk_bytes_; }
+    size_t chunk_count() const { return chunk_count_; }
+    // Marked chunks plus the received bytes of partial ones.
+    uint64_t done_bytes() const { return done_bytes_; }
+
+private:
+    struct header {
+        char magic[4];
+        uint32_t version;
+        uint64_t file_bytes;
+        uint32_t chunk_bytes;
+        uint32_t id_length;
+    };
+
+    uint64_t chunk_size(size_t chunk) const;
+
+    uint64_t file_bytes_ = 0;
+    uint32_t chunk_bytes_ = 0;
+    size_t chunk_count_ = 0;
+    size_t marked_ = 0;
+    uint64_t done_bytes_ = 0;
+    std::vector<uint64_t> bits_;
+    std::unordered_map<size_t, std::vector<byte_range>> partial_;  // chunk -> sorted received spans, chunk-relative; not saved
+};
+
+// Chunked, resumable filestream sessions. start() asks the host for the ranges its
+// checkpoint is missing (the whole file when it has none); the host answers with on_chunk()
+// per piece and on_failure() when the connection drops, after which resume() asks for what
+// is still missing. Once the last byte of a request arrives the host is done with it; if the
+// file is still incomplete, pieces were lost on the way and drained() reports it so the
+// caller can treat it as a failure.
+// Checkpoints are saved every kSaveEveryChunks chunks, on failure and when a session stops
+// unfinished, and deleted once the file is complete.
+class c_filestream_transport : public c_download_transport {
+public:
+    using request_fn = std::function<void(const std::string& file_id, const std::vector<byte_range>& ranges)>;
+    using saved_fn = std::function<void(const std::string& file_id, const c_chunk_checkpoint& checkpoint)>;
+
+    static constexpr uint32_t kDefaultChunkBytes = 256 * 1024;
+    static constexpr uint32_t kSaveEveryChunks = 64;
+    static constexpr int kMaxRetries = 5;
+
+    explicit c_filestream_transport(request_fn request, uint32_t chunk_bytes = kDefaultChunkBytes)
+        : request_(std::move(request)), chunk_bytes_(chunk_bytes ? chunk_bytes : kDefaultChunkBytes) {}
+
+    // Where checkpoints live; empty keeps them in memory for this process only.
+    void set_directory(const std::filesystem::path& directory) { directory_ = directory; }
+    // Called after every checkpoint that reached disk, with what was written.
+    void set_saved_callback(saved_fn fn) { saved_ = std::move(fn); }
+    std::filesystem::path checkpoint_path(std::string_view file_id) const;
+
+    void start(download_item& item) override;
+    uint64_t pump(download_item&, uint64_t) override { return 0; }
+    void stop(const download_item& item) override;
+
+    // nullptr if file_id has no running session. A total that differs from the checkpoint's
+    // means the file changed: the checkpoint restarts and the whole file is requested again.
+    const c_chunk_checkpoint* on_chunk(std::string_view file_id, uint64_t offset, uint64_t length, uint64_t total_bytes);
+    // Saves the checkpoint and returns the session's failures since its last completed
+    // chunk, or 0 if file_id has no running session.
+    int on_failure(std::string_view file_id);
+    bool resume(std::string_view file_id);
+    // True once the end of the last request arrived and the file is still incomplete.
+    bool drained(std::string_view file_id) const;
+    const c_chunk_checkpoint* checkpoint(std::string_view file_id) const;
+
+private:
+    struct session {
+        std::string file_id;
+        c_chunk_checkpoint checkpoint;
+        bool running = false;
+        int failures = 0;
+        uint32_t unsaved_chunks = 0;
+        uint64_t request_end = 0;       // end of the last requested range; UINT64_MAX before the size is known
+        bool request_delivered = false;
+    };
+
+    session* find_running(std::string_view file_id);
+    void request(session& s);
+    void save(session& s);
+
+    request_fn request_;
+    saved_fn saved_;
+    uint32_t chunk_bytes_;
+    std::filesystem::path directory_;
+    std::unordered_map<std::string, session> sessions_;     // unfinished files stay for a later start()
+};
+
+#endif // FILESTREAM_SESSION_HPP
@@ -0,0 +1,162 @@
+#include "frame_hash.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRAME_HASH_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    constexpr size_t kStripeSize = 32;
+    constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t kSecret[4] = {
+        0xBE4BA423396CFEB8ull, 0x1CAD21F72C81017Cull, 0xDB979083E96DD4DEull, 0x1F67B3B7A4A44072ull
+    };
+
+    uint64_t avalanche(uint64_t h) {
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime1;
+        h ^= h >> 32;
+        return h;
+    }
+
+    // One 32-byte stripe into four 64-bit lanes: lane += swapped input + lo32(k) * hi32(k),
+    // with k = input ^ secret. Both paths below compute exactly this.
+#ifdef FRAME_HASH_SSE2
+    struct accumulator {
+        __m128i lanes[2];
+
+        accumulator() {
+            lanes[0] = _mm_setzero_si128();
+            lanes[1] = _mm_setzero_si128();
+        }
+
+        void stripe(const unsigned char* p) {
+            for (int i = 0; i < 2; i++) {
+                const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+                const __m128i secret = _mm_set_epi64x(static_cast<long long>(kSecret[i * 2 + 1]), static_cast<long long>(kSecret[i * 2]));
+                const __m128i key = _mm_xor_si128(data, secret);
+                const __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, 0x31));
+                lanes[i] = _mm_add_epi64(lanes[i], _mm_shuffle_epi32(data, 0x4E));
+                lanes[i] = _mm_add_epi64(lanes[i], product);
+            }
+        }
+
+        void store(uint64_t out[4]) const {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lanes[0]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2), lanes[1]);
+        }
+    };
+#else
+    struct accumulator {
+        uint64_t lanes[4] = {};
+
+        void stripe(const unsigned char* p) {
+            uint64_t data[4];
+            memcpy(data, p, sizeof(data));
+            for (int i = 0; i < 4; i++) {
+                const uint64_t key = data[i] ^ kSecret[i];
+                lanes[i ^ 1] += data[i];
+                lanes[i] += (key & 0xFFFFFFFFull) * (key >> 32);
+            }
+        }
+
+        void store(uint64_t out[4]) const {
+            memcpy(out, lanes, sizeof(lanes));
+        }
+    };
+#endif
+
+    template <typename T>
+    uint64_t bits_of(T value) {
+        static_assert(sizeof(T) <= sizeof(uint64_t), "value too wide");
+        uint64_t bits = 0;
+        memcpy(&bits, &value, sizeof(T));
+        return bits;
+    }
+}
+
+uint64_t frame_hash_bytes(const void* data, size_t size, uint64_t seed) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    accumulator acc;
+
+    size_t remaining = size;
+    while (remaining >= kStripeSize) {
+        acc.stripe(p);
+        p += kStripeSize;
+        remaining -= kStripeSize;
+    }
+    if (remaining > 0) {
+        unsigned char tail[kStripeSize] = {};
+        memcpy(tail, p, remaining);
+        acc.stripe(tail);
+    }
+
+    uint64_t lanes[4];
+    acc.store(lanes);
+
+    uint64_t h = seed ^ (static_cast<uint64_t>(size) * kPrime1);
+    for (uint64_t lane : lanes) {
+        h = avalanche(h ^ lane) + kPrime2;
+    }
+    return h;
+}
+
+void c_frame_hasher::begin(uint64_t seed) {
+    hash_ = kPrime1 ^ seed;
+    reliable_ = true;
+}
+
+void c_frame_hasher::mix(uint64_t value) {
+    hash_ ^= value * kPrime2;
+    hash_ = ((hash_ << 31) | (hash_ >> 33)) * kPrime1;
+}
+
+void c_frame_hasher::add_viewport(const ImGuiViewport* viewport) {
+    if (!viewport) {
+        mix(0);
+        return;
+    }
+
+    mix(viewport->ID);
+    mix(static_cast<uint64_t>(viewport->Flags));
+    add_draw_data(viewport->DrawData);
+}
+
+void c_frame_hasher::add_draw_data(const ImDrawData* draw_data) {
+    if (!draw_data || !draw_data->Valid) {
+        mix(0);
+        return;
+    }
+
+    mix(static_cast<uint64_t>(draw_data->CmdListsCount));
+    mix(bits_of(draw_data->DisplayPos));
+    mix(bits_of(draw_data->DisplaySize));
+    mix(bits_of(draw_data->FramebufferScale));
+
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        add_draw_list(draw_data->CmdLists[n]);
+    }
+}
+
+void c_frame_hasher::add_draw_list(const ImDrawList* list) {
+    hash_ = frame_hash_bytes(list->VtxBuffer.Data, list->VtxBuffer.size_in_bytes(), hash_);
+    hash_ = frame_hash_bytes(list->IdxBuffer.Data, list->IdxBuffer.size_in_bytes(), hash_);
+
+    mix(static_cast<uint64_t>(list->CmdBuffer.Size));
+    for (const ImDrawCmd& cmd : list->CmdBuffer) {
+        if (cmd.UserCallback && cmd.UserCallback != ImDrawCallback_ResetRenderState) {
+            reliable_ = false;
+        }
+
+        mix(bits_of(ImVec2(cmd.ClipRect.x, cmd.ClipRect.y)));
+        mix(bits_of(ImVec2(cmd.ClipRect.z, cmd.ClipRect.w)));
+        mix(bits_of(cmd.TextureId));
+        mix((static_cast<uint64_t>(cmd.VtxOffset) << 32) | cmd.IdxOffset);
+        mix(cmd.ElemCount);
+        mix(bits_of(cmd.UserCallback));
+    }
+}
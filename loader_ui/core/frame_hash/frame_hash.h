@@ -0,0 +1,41 @@
+#ifndef FRAME_HASH_HPP
+#define FRAME_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "../dep/imgui/imgui.h"
+
+struct frame_skip_stats {
+    uint64_t presented_frames = 0;
+    uint64_t skipped_frames = 0;
+    uint64_t forced_presents = 0;   // presented although the hash matched (resize, device loss, request)
+};
+
+// 64-bit content hash over a byte range. Uses SSE2 when available; the scalar path
+// computes the same value so hashes are comparable across builds.
+uint64_t frame_hash_bytes(const void* data, size_t size, uint64_t seed);
+
+// Hashes everything that decides what ends up on screen for a set of viewports:
+// viewport identity/flags, display rect and scale, every draw command's state and the
+// vertex/index streams it references. Two frames with equal hashes produce the same
+// pixels, provided texture contents did not change behind the same ImTextureID.
+class c_frame_hasher {
+public:
+    void begin(uint64_t seed = 0);
+    void add_viewport(const ImGuiViewport* viewport);
+    void add_draw_data(const ImDrawData* draw_data);
+    void add_draw_list(const ImDrawList* list);
+
+    uint64_t value() const { return hash_; }
+    // False once a user callback was seen; its output cannot be vouched for.
+    bool reliable() const { return reliable_; }
+
+    void mix(uint64_t value);
+
+private:
+
+    uint64_t hash_ = 0;
+    bool reliable_ = true;
+};
+
+#endif // FRAME_HASH_HPP
@@ -1,14 +1,23 @@
 #include "imgui_manager.h"
+#include <atomic>
+#include <filesystem>
 #include <iostream>
 #include <tchar.h>
+#include "../timer_wheel/timer_wheel.h"
 
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
 static bool g_should_close = false;
+// Set by anything that invalidates what is on screen; the next frame presents even if its hash matches.
+// Also set from the render thread on device loss.
+static std::atomic<bool> g_force_present{ true };
+
+// How long a skipped frame sleeps while a widget is active (text cursor blink, drags).
+static constexpr DWORD kSkippedFrameWaitMs = 16;
 
 c_imgui_manager::c_imgui_manager()
     : hwnd(nullptr), pd3dDevice(nullptr), pd3dDeviceContext(nullptr),
-    pSwapChain(nullptr), pMainRenderTargetView(nullptr), initialized(false) {
+    pSwapChain(nullptr), pMainRenderTargetView(nullptr), initialized(false), headless(false) {
 }
 
 c_imgui_manager::~c_imgui_manager() {
@@ -20,6 +29,10 @@ LRESULT WINAPI c_imgui_manager::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPAR
         return true;
 
     switch (msg) {
+    case WM_SIZE:
+    case WM_DISPLAYCHANGE:
+        g_force_present = true;
+        break;
     case WM_DESTROY:
         g_should_close = true;
         ::PostQuitMessage(0);
@@ -37,12 +50,20 @@ LRESULT WINAPI c_imgui_manager::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPAR
     return ::DefWindowProcW(hWnd, msg, wParam, lParam);
 }
 
-bool c_imgui_manager::initialize(const std::string& title) {
+bool c_imgui_manager::initialize(const std::string& title, bool headless_mode) {
     if (initialized) {
         return true;
     }
 
     g_should_close = false;
+    g_force_present = true;
+    headless = headless_mode;
+    frame_skipped = false;
+    presented_hash_valid = false;
+
+    if (headless) {
+        return initialize_headless();
+    }
 
     WNDCLASSEXW wc = {
             sizeof(wc), CS_CLASSDC, WndProc, 0L, 0L,
@@ -72,6 +93,7 @@ bool c_imgui_manager::initialize(const std::string& title) {
     }
 
     IMGUI_CHECKVERSION();
+    allocator.install();
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
@@ -85,16 +107,49 @@ bool c_imgui_manager::initialize(const std::string& title) {
         style.Colors[ImGuiCol_WindowBg].w = 0.95f;
     }
 
+    wake_event = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+
     ImGui_ImplWin32_Init(hwnd);
+    ImGui_ImplWin32_SetInputObserver(&c_imgui_manager::observe_input, this);
     ImGui_ImplDX11_Init(pd3dDevice, pd3dDeviceContext);
 
     initalize_fonts();
 
+    c_allocation_tracker::attach_current_thread();
+
     initialized = true;
     std::cout << "ImGui manager initialized" << std::endl;
     return true;
 }
 
+bool c_imgui_manager::initialize_headless() {
+    IMGUI_CHECKVERSION();
+    allocator.install();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
+    io.IniFilename = "";
+    io.DisplaySize = headless_display_size;
+
+    initalize_fonts();
+
+    // No renderer backend: build the atlas ourselves so ImGui::NewFrame accepts it.
+    unsigned char* pixels = nullptr;
+    int width = 0, height = 0;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    io.Fonts->SetTexID(soft_renderer.create_texture(pixels, width, height));
+
+    c_allocation_tracker::attach_current_thread();
+
+    initialized = true;
+    return true;
+}
+
+void c_imgui_manager::set_headless_display_size(int width, int height) {
+    if (width > 0 && height > 0)
+        headless_display_size = ImVec2(static_cast<float>(width), static_cast<float>(height));
+}
+
 ImFont* c_imgui_manager::get_font(const char* font_name) {
     for (const auto& font : fonts) {
         if (font && strcmp(font->name, font_name) == 0)
@@ -107,14 +162,25 @@ ImFont* c_imgui_manager::get_font(const char* font_name) {
 void c_imgui_manager::initalize_fonts() {
     ImGuiIO& io = ImGui::GetIO();
 
+    const char* path = !font_path.empty() ? font_path.c_str() : headless ? nullptr : "c:\\Windows\\Fonts\\bahnschrift.ttf";
+    std::error_code ec;
+    if (path && !std::filesystem::exists(std::filesystem::u8path(path), ec))
+        path = nullptr;
+
     //First font pushed is default font
-    fonts.push_back(new font_object(nullptr, "normal", "c:\\Windows\\Fonts\\bahnschrift.ttf", 14.f));
-    fonts.push_back(new font_object(nullptr, "title", "c:\\Windows\\Fonts\\bahnschrift.ttf", 22.f));
-    fonts.push_back(new font_object(nullptr, "smalltitle", "c:\\Windows\\Fonts\\bahnschrift.ttf", 18.f));
-    fonts.push_back(new font_object(nullptr, "subtitle", "c:\\Windows\\Fonts\\bahnschrift.ttf", 10.f));
+    fonts.push_back(new font_object(nullptr, "normal", path, 14.f));
+    fonts.push_back(new font_object(nullptr, "title", path, 22.f));
+    fonts.push_back(new font_object(nullptr, "smalltitle", path, 18.f));
+    fonts.push_back(new font_object(nullptr, "subtitle", path, 10.f));
 
     for (auto font : fonts) {
-        font->font = io.Fonts->AddFontFromFileTTF(font->font_path, font->size, NULL, io.Fonts->GetGlyphRangesDefault());
+        if (font->font_path) {
+            font->font = io.Fonts->AddFontFromFileTTF(font->font_path, font->size, NULL, io.Fonts->GetGlyphRangesDefault());
+            continue;
+        }
+        ImFontConfig font_config;
+        font_config.SizePixels = font->size;
+        font->font = io.Fonts->AddFontDefault(&font_config);
     }
 }
 
@@ -123,17 +189,44 @@ void c_imgui_manager::shutdown() {
         return;
     }
 
-    ImGui_ImplDX11_Shutdown();
-    ImGui_ImplWin32_Shutdown();
+    c_allocation_tracker::detach_current_thread();
+
+    recorder.stop();
+    // The render thread holds swap chains and ImGui-allocated snapshots; it goes first.
+    render_thread.stop();
+    threaded_rendering = false;
+    draw_optimizer.release();
+    draw_cache.clear();
+    if (!headless) {
+        ImGui_ImplDX11_Shutdown();
+        ImGui_ImplWin32_Shutdown();
+    }
+    else {
+        soft_renderer.destroy_texture(ImGui::GetIO().Fonts->TexID);
+        software_rendering = false;
+    }
     ImGui::DestroyContext();
+    allocator.uninstall();
+
+    for (auto font : fonts) {
+        delete font;
+    }
+    fonts.clear();
 
-    CleanupDeviceD3D();
+    if (!headless) {
+        CleanupDeviceD3D();
 
-    if (hwnd) {
-        ::DestroyWindow(hwnd);
-        hwnd = nullptr;
+        if (wake_event) {
+            ::CloseHandle(wake_event);
+            wake_event = nullptr;
+        }
+
+        if (hwnd) {
+            ::DestroyWindow(hwnd);
+            hwnd = nullptr;
+        }
+        ::UnregisterClassW(L"ImGui Context", GetModuleHandle(nullptr));
     }
-    ::UnregisterClassW(L"ImGui Context", GetModuleHandle(nullptr));
 
     initialized = false;
 }
@@ -144,6 +237,28 @@ bool c_imgui_manager::should_close() const {
 
 void c_imgui_manager::new_frame() {
     if (!initialized) return;
+    PROFILE_SCOPE("new_frame", "frame");
+
+    const uint64_t now = c_latency_tracker::now_us();
+    metrics = frame_metrics{};
+    if (frame_start_us != 0)
+        metrics.frame_ms = (now - frame_start_us) / 1000.f;
+    frame_start_us = now;
+
+    allocator.begin_frame();
+    draw_optimizer.begin_frame();
+
+    if (headless) {
+        headless_vtx_ring.begin_frame();
+        headless_idx_ring.begin_frame();
+        ImGui::GetIO().DeltaTime = next_delta_time > 0.f ? next_delta_time : 1.0f / 60.0f;
+        next_delta_time = 0.f;
+        ImGui::NewFrame();
+        recorder.record_frame(ImGui::GetIO().DeltaTime, GImGui->InputEventsTrail);
+        latency.collect_frame();
+        draw_cache.begin_frame();
+        return;
+    }
 
     MSG msg;
     while (::PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE)) {
@@ -158,28 +273,395 @@ void c_imgui_manager::new_frame() {
 
     ImGui_ImplDX11_NewFrame();
     ImGui_ImplWin32_NewFrame();
+    PROFILE_SCOPE("ImGui::NewFrame", "frame");
     ImGui::NewFrame();
+    // After NewFrame so this frame's input events are visible.
+    recorder.record_frame(ImGui::GetIO().DeltaTime, GImGui->InputEventsTrail);
+    latency.collect_frame();
+    draw_cache.begin_frame();
 }
 
 void c_imgui_manager::render() {
     if (!initialized) return;
+    PROFILE_SCOPE("render", "frame");
 
-    ImGui::Render();
+    const uint64_t submit_start_us = c_latency_tracker::now_us();
+    metrics.ui_ms = (submit_start_us - frame_start_us) / 1000.f;
 
-    const float clear_color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
-    pd3dDeviceContext->OMSetRenderTargets(1, &pMainRenderTargetView, nullptr);
-    pd3dDeviceContext->ClearRenderTargetView(pMainRenderTargetView, clear_color);
-    ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    {
+        PROFILE_SCOPE("ImGui::Render", "frame");
+        ImGui::Render();
+    }
+
+    // Damage has to be diffed per source list, so it runs before the optimizer merges them.
+    update_damage();
+
+    // Every viewport's draw data is final once Render() returns, including the ones
+    // RenderPlatformWindowsDefault submits below.
+    ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+    for (int i = 0; i < platform_io.Viewports.Size; i++) {
+        draw_optimizer.optimize(platform_io.Viewports[i]->DrawData);
+    }
+
+    if (headless) {
+        const ImDrawData* draw_data = ImGui::GetDrawData();
+        headless_vtx_ring.reserve((size_t)draw_data->TotalVtxCount);
+        headless_idx_ring.reserve((size_t)draw_data->TotalIdxCount);
+        if (software_rendering) {
+            PROFILE_SCOPE("soft_renderer", "render");
+            if (headless_damage.full())
+                soft_renderer.render(draw_data);
+            else
+                soft_renderer.render(draw_data, headless_damage.rects().data(), (int)headless_damage.rects().size());
+        }
+        latency.complete_frame(c_latency_tracker::now_us());
+        record_metrics(submit_start_us);
+        perf_overlay.record(metrics);
+        return;
+    }
+
+    frame_skipped = should_skip_frame();
+
+    if (threaded_rendering) {
+        submit_threaded();
+        record_metrics(submit_start_us);
+        // The render thread's timing for the previous frame; this one is still in flight.
+        metrics.present_ms = (float)render_thread.stats().last_submit_ms;
+        return;
+    }
+
+    if (!frame_skipped) {
+        PROFILE_SCOPE("ImGui_ImplDX11_RenderDrawData", "render");
+        ImGui_ImplDX11_BeginUploadFrame();
+        const float clear_color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        pd3dDeviceContext->OMSetRenderTargets(1, &pMainRenderTargetView, nullptr);
+        pd3dDeviceContext->ClearRenderTargetView(pMainRenderTargetView, clear_color);
+        ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    }
 
     if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
+        // Platform windows are still created, moved and resized on skipped frames.
         ImGui::UpdatePlatformWindows();
-        ImGui::RenderPlatformWindowsDefault();
+        if (!frame_skipped) {
+            // Draws and presents every platform window.
+            PROFILE_SCOPE("RenderPlatformWindowsDefault", "render");
+            ImGui::RenderPlatformWindowsDefault();
+        }
     }
+    record_metrics(submit_start_us);
+}
+
+void c_imgui_manager::record_metrics(uint64_t submit_start_us) {
+    metrics.submit_ms = (c_latency_tracker::now_us() - submit_start_us) / 1000.f;
+
+    // Counted after the optimizer, i.e. what the backend actually draws.
+    ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+    for (int i = 0; i < platform_io.Viewports.Size; i++) {
+        const ImDrawData* draw_data = platform_io.Viewports[i]->DrawData;
+        if (!draw_data || (frame_skipped && !headless))
+            continue;
+        metrics.vertices += draw_data->TotalVtxCount;
+        metrics.indices += draw_data->TotalIdxCount;
+        for (int n = 0; n < draw_data->CmdListsCount; n++)
+            metrics.draw_calls += draw_data->CmdLists[n]->CmdBuffer.Size;
+    }
+
+    metrics.heap_live_bytes = allocator.pool_live_bytes();
+    metrics.heap_reserved_bytes = allocator.pool_reserved_bytes();
+    const ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    metrics.atlas_width = atlas->TexWidth;
+    metrics.atlas_height = atlas->TexHeight;
+}
+
+void c_imgui_manager::update_damage() {
+    frame_damage = damage_stats{};
+    auto accumulate = [this](const c_damage_tracker& tracker) {
+        const damage_stats& stats = tracker.stats();
+        frame_damage.rect_count += stats.rect_count;
+        frame_damage.full = frame_damage.full || stats.full;
+        frame_damage.dirty_pixels += stats.dirty_pixels;
+        frame_damage.total_pixels += stats.total_pixels;
+    };
+
+    if (headless) {
+        if (software_rendering) {
+            headless_damage.update(ImGui::GetDrawData());
+            accumulate(headless_damage);
+        }
+        return;
+    }
+
+    // Drop trackers of viewports that no longer exist.
+    ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+    viewport_damages.erase(std::remove_if(viewport_damages.begin(), viewport_damages.end(),
+        [](const viewport_damage& entry) { return ImGui::FindViewportByID(entry.viewport_id) == nullptr; }),
+        viewport_damages.end());
+
+    // The main viewport is cleared and redrawn by us every frame; only secondary viewports
+    // go through the backend's partial path.
+    for (int i = 1; i < platform_io.Viewports.Size; i++) {
+        ImGuiViewport* viewport = platform_io.Viewports[i];
+        auto it = std::find_if(viewport_damages.begin(), viewport_damages.end(),
+            [viewport](const viewport_damage& entry) { return entry.viewport_id == viewport->ID; });
+        if (it == viewport_damages.end()) {
+            viewport_damages.push_back(viewport_damage{ viewport->ID, c_damage_tracker{} });
+            it = viewport_damages.end() - 1;
+        }
+
+        // Same triggers as a forced present: after a resize or device loss nothing on screen can be trusted.
+        if (g_force_present)
+            it->tracker.invalidate();
+        it->tracker.update(viewport->DrawData);
+        accumulate(it->tracker);
+
+        // The render thread hands the rects over with its snapshot.
+        if (threaded_rendering)
+            continue;
+        if (it->tracker.full()) {
+            ImGui_ImplDX11_SetViewportDamage(viewport, nullptr, -1);
+            continue;
+        }
+        ImVec4 rects[c_damage_tracker::kMaxRects];
+        int rect_count = 0;
+        for (const damage_rect& r : it->tracker.rects()) {
+            rects[rect_count++] = ImVec4((float)r.x0, (float)r.y0, (float)r.x1, (float)r.y1);
+        }
+        ImGui_ImplDX11_SetViewportDamage(viewport, rects, rect_count);
+    }
+}
+
+void c_imgui_manager::submit_threaded() {
+    const bool viewports_enabled = (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable) != 0;
+
+    PROFILE_SCOPE("submit_threaded", "render");
+    // Filled while the render thread may still be presenting the previous frame.
+    render_frame& frame = render_thread.acquire();
+    if (!frame_skipped) {
+        frame.main.capture(ImGui::GetDrawData());
+
+        ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+        for (int i = 1; viewports_enabled && i < platform_io.Viewports.Size; i++) {
+            ImGuiViewport* viewport = platform_io.Viewports[i];
+            if (viewport->Flags & ImGuiViewportFlags_IsMinimized)
+                continue;
+
+            render_viewport& out = frame.add_viewport();
+            out.viewport_id = viewport->ID;
+            out.clear = !(viewport->Flags & ImGuiViewportFlags_NoRendererClear);
+            for (const viewport_damage& entry : viewport_damages) {
+                if (entry.viewport_id != viewport->ID || entry.tracker.full())
+                    continue;
+                out.damage_full = false;
+                for (const damage_rect& r : entry.tracker.rects()) {
+                    out.damage[out.damage_count++] = ImVec4((float)r.x0, (float)r.y0, (float)r.x1, (float)r.y1);
+                }
+            }
+            out.draw.capture(viewport->DrawData);
+        }
+    }
+
+    // Swap chains are created, resized and destroyed in UpdatePlatformWindows.
+    {
+        PROFILE_SCOPE("wait_idle", "render");
+        render_thread.wait_idle();
+    }
+    ImGui_ImplDX11_GetUploadStats(&threaded_upload_vtx, &threaded_upload_idx);
+    if (viewports_enabled)
+        ImGui::UpdatePlatformWindows();
+    if (frame_skipped)
+        return;
+
+    frame.input_stamps.swap(latency.frame_stamps());
+
+    // Bound after the update so windows created this frame have their renderer data.
+    for (int i = 0; i < frame.viewport_count; i++) {
+        render_viewport& out = *frame.viewports[i];
+        ImGuiViewport* viewport = ImGui::FindViewportByID(out.viewport_id);
+        out.renderer_user_data = viewport ? viewport->RendererUserData : nullptr;
+    }
+    render_thread.publish();
+}
+
+// Render thread. Same sequence as the synchronous render() + present().
+void c_imgui_manager::submit_frame(render_frame& frame) {
+    PROFILE_SCOPE("submit_frame", "render");
+    {
+        PROFILE_SCOPE("ImGui_ImplDX11_RenderDrawData", "render");
+        ImGui_ImplDX11_BeginUploadFrame();
+        const float clear_color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        pd3dDeviceContext->OMSetRenderTargets(1, &pMainRenderTargetView, nullptr);
+        pd3dDeviceContext->ClearRenderTargetView(pMainRenderTargetView, clear_color);
+        if (!frame.main.empty())
+            ImGui_ImplDX11_RenderDrawData(frame.main.draw_data());
+
+        for (int i = 0; i < frame.viewport_count; i++) {
+            render_viewport& viewport = *frame.viewports[i];
+            ImGui_ImplDX11_SetViewportDataDamage(viewport.renderer_user_data, viewport.damage, viewport.damage_full ? -1 : viewport.damage_count);
+            ImGui_ImplDX11_RenderViewport(viewport.renderer_user_data, viewport.draw.draw_data(), viewport.clear);
+        }
+    }
+
+    PROFILE_SCOPE("Present", "present");
+    for (int i = 0; i < frame.viewport_count; i++) {
+        ImGui_ImplDX11_PresentViewport(frame.viewports[i]->renderer_user_data);
+    }
+
+    HRESULT hr = pSwapChain->Present(1, 0);
+    if (hr == DXGI_ERROR_DEVICE_REMOVED || hr == DXGI_ERROR_DEVICE_RESET)
+        g_force_present = true;
+    // Leave no back buffer bound: the UI thread resizes swap chains while we are idle.
+    pd3dDeviceContext->OMSetRenderTargets(0, nullptr, nullptr);
+    latency.complete(frame.input_stamps.data(), frame.input_stamps.size(), c_latency_tracker::now_us());
+}
+
+bool c_imgui_manager::should_skip_frame() {
+    if (!frame_skip_enabled) {
+        g_force_present = false;
+        return false;
+    }
+
+    frame_hasher.begin();
+    ImGuiPlatformIO& platform_io = ImGui::GetPlatformIO();
+    for (int i = 0; i < platform_io.Viewports.Size; i++) {
+        frame_hasher.add_viewport(platform_io.Viewports[i]);
+    }
+    const uint64_t hash = frame_hasher.value();
+
+    bool force = g_force_present || !presented_hash_valid || !frame_hasher.reliable();
+    if (!force && pd3dDevice->GetDeviceRemovedReason() != S_OK)
+        force = true;
+
+    if (!force && hash == presented_hash) {
+        skip_stats.skipped_frames++;
+        return true;
+    }
+
+    if (force && presented_hash_valid && hash == presented_hash)
+        skip_stats.forced_presents++;
+    skip_stats.presented_frames++;
+
+    g_force_present = false;
+    presented_hash = hash;
+    presented_hash_valid = true;
+    return false;
 }
 
 void c_imgui_manager::present() {
-    if (!initialized) return;
-    pSwapChain->Present(1, 0);
+    if (!initialized || headless) return;
+
+    if (frame_skipped) {
+        // The input changed nothing on screen; what it would have shown is already there.
+        latency.complete_frame(c_latency_tracker::now_us());
+        perf_overlay.record(metrics);
+        // Nothing was submitted, so there is no vsync to pace us; sleep until input, a
+        // wake() or the next scheduled deadline.
+        ::MsgWaitForMultipleObjects(wake_event ? 1 : 0, wake_event ? &wake_event : nullptr, FALSE, idle_wait_ms(), QS_ALLINPUT);
+        return;
+    }
+
+    // Presented by the render thread.
+    if (threaded_rendering) {
+        perf_overlay.record(metrics);
+        return;
+    }
+
+    const uint64_t present_start_us = c_latency_tracker::now_us();
+    {
+        PROFILE_SCOPE("Present", "present");
+        HRESULT hr = pSwapChain->Present(1, 0);
+        if (hr == DXGI_ERROR_DEVICE_REMOVED || hr == DXGI_ERROR_DEVICE_RESET)
+            g_force_present = true;
+    }
+    const uint64_t present_end_us = c_latency_tracker::now_us();
+    latency.complete_frame(present_end_us);
+    metrics.present_ms = (present_end_us - present_start_us) / 1000.f;
+    perf_overlay.record(metrics);
+}
+
+DWORD c_imgui_manager::idle_wait_ms() const {
+    if (GImGui->ActiveId != 0)
+        return kSkippedFrameWaitMs;
+    if (next_wake_us == UINT64_MAX)
+        return max_idle_wait_ms;
+
+    const uint64_t now = c_timer_wheel::now_us();
+    const uint64_t until_ms = next_wake_us > now ? (next_wake_us - now + 999) / 1000 : 0;
+    return until_ms < max_idle_wait_ms ? static_cast<DWORD>(until_ms) : max_idle_wait_ms;
+}
+
+void c_imgui_manager::wake() {
+    if (wake_event)
+        ::SetEvent(wake_event);
+}
+
+void c_imgui_manager::observe_input(unsigned int msg, bool after, void* user_data) {
+    c_imgui_manager* self = static_cast<c_imgui_manager*>(user_data);
+    if (after)
+        self->latency.end_input();
+    else
+        self->latency.begin_input();
+}
+
+void c_imgui_manager::queue_text_input(const char* utf8) {
+    if (!initialized)
+        return;
+    latency.begin_input();
+    ImGui::GetIO().AddInputCharactersUTF8(utf8);
+    latency.end_input();
+}
+
+void c_imgui_manager::queue_key_input(ImGuiKey key, bool down) {
+    if (!initialized)
+        return;
+    latency.begin_input();
+    ImGui::GetIO().AddKeyEvent(key, down);
+    latency.end_input();
+}
+
+void c_imgui_manager::set_frame_skip(bool enabled) {
+    frame_skip_enabled = enabled;
+    frame_skipped = false;
+    g_force_present = true;
+}
+
+void c_imgui_manager::set_threaded_rendering(bool enabled) {
+    if (!initialized || headless || enabled == threaded_rendering)
+        return;
+
+    if (enabled) {
+        threaded_rendering = render_thread.start([this](render_frame& frame) { submit_frame(frame); });
+        return;
+    }
+    render_thread.stop();
+    threaded_rendering = false;
+    // Damage was routed through the snapshots; the backend has none for the next frame.
+    g_force_present = true;
+}
+
+void c_imgui_manager::set_software_rendering(bool enabled) {
+    software_rendering = enabled && headless;
+}
+
+void c_imgui_manager::request_present() {
+    g_force_present = true;
+}
+
+void c_imgui_manager::get_upload_stats(upload_ring_stats* out_vtx, upload_ring_stats* out_idx) const {
+    if (!initialized)
+        return;
+
+    if (headless) {
+        if (out_vtx) *out_vtx = headless_vtx_ring.stats();
+        if (out_idx) *out_idx = headless_idx_ring.stats();
+        return;
+    }
+
+    if (threaded_rendering) {
+        if (out_vtx) *out_vtx = threaded_upload_vtx;
+        if (out_idx) *out_idx = threaded_upload_idx;
+        return;
+    }
+    ImGui_ImplDX11_GetUploadStats(out_vtx, out_idx);
 }
 
 void c_imgui_manager::set_should_close(bool close) {
@@ -188,8 +670,18 @@ void c_imgui_manager::set_should_close(bool close) {
 
 void c_imgui_manager::set_window_title(const std::string& title) {
     if (hwnd) {
-        std::wstring wtitle(title.begin(), title.end());
-        ::SetWindowTextW(hwnd, wtitle.c_str());
+        wchar_t wtitle[256];
+        // No UTF-8 sequence needs more UTF-16 units than it has bytes, so a prefix that fits
+        // the buffer in bytes always converts; cut it at a character boundary.
+        size_t bytes = title.size();
+        if (bytes >= IM_ARRAYSIZE(wtitle)) {
+            bytes = IM_ARRAYSIZE(wtitle) - 1;
+            while (bytes > 0 && (static_cast<unsigned char>(title[bytes]) & 0xC0) == 0x80)
+                bytes--;
+        }
+        int length = bytes ? ::MultiByteToWideChar(CP_UTF8, 0, title.data(), static_cast<int>(bytes), wtitle, IM_ARRAYSIZE(wtitle) - 1) : 0;
+        wtitle[length > 0 ? length : 0] = L'\0';
+        ::SetWindowTextW(hwnd, wtitle);
     }
 }
 
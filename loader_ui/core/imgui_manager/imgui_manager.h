@@ -9,6 +9,18 @@
 #include "../dep/imgui/imgui.h"
 #include "../dep/imgui/imgui_impl_win32.h"
 #include "../dep/imgui/imgui_impl_dx11.h"
+#include "../allocator/allocator.h"
+#include "../upload_ring/upload_ring.h"
+#include "../draw_optimizer/draw_optimizer.h"
+#include "../frame_hash/frame_hash.h"
+#include "../soft_renderer/soft_renderer.h"
+#include "../damage_tracker/damage_tracker.h"
+#include "../draw_cache/draw_cache.h"
+#include "../render_thread/render_thread.h"
+#include "../latency/latency.h"
+#include "../profiler/profiler.h"
+#include "../perf_overlay/perf_overlay.h"
+#include "../input_recorder/input_recorder.h"
 
 struct font_object {
     ImFont* font;
@@ -31,6 +43,11 @@ static ImColor darken(const ImColor& color, float factor = 0.8f) {
     );
 }
 
+struct viewport_damage {
+    ImGuiID viewport_id;
+    c_damage_tracker tracker;
+};
+
 class c_imgui_manager {
 private:
     HWND hwnd;
@@ -40,18 +57,70 @@ private:
     ID3D11RenderTargetView* pMainRenderTargetView;
     std::vector<font_object*> fonts;
     bool initialized;
+    bool headless;
+    c_ui_allocator allocator;
+    // Headless frames run the same upload placement policy as the DX11 backend, minus the GPU.
+    c_upload_ring headless_vtx_ring{ 5000 };
+    c_upload_ring headless_idx_ring{ 10000 };
+    c_draw_optimizer draw_optimizer;
+    c_draw_cache draw_cache;
+    c_frame_hasher frame_hasher;
+    bool frame_skip_enabled = false;
+    bool frame_skipped = false;
+    bool presented_hash_valid = false;
+    uint64_t presented_hash = 0;
+    frame_skip_stats skip_stats{};
+    c_soft_renderer soft_renderer;
+    bool software_rendering = false;
+    std::vector<viewport_damage> viewport_damages;
+    c_damage_tracker headless_damage;
+    damage_stats frame_damage{};
+    // With threaded rendering every ID3D11DeviceContext call is made on the render thread;
+    // the UI thread only touches swap chains and backend state between wait_idle() and
+    // publish(), while the render thread is idle.
+    c_render_thread render_thread;
+    bool threaded_rendering = false;
+    upload_ring_stats threaded_upload_vtx{};    // read while the render thread was idle
+    upload_ring_stats threaded_upload_idx{};
+    c_latency_tracker latency;
+    c_perf_overlay perf_overlay;
+    frame_metrics metrics{};
+    uint64_t frame_start_us = 0;
+    c_input_recorder recorder;
+    float next_delta_time = 0.f;
+    HANDLE wake_event = nullptr;
+    uint64_t next_wake_us = UINT64_MAX;
+    DWORD max_idle_wait_ms = 100;
+    std::string font_path;
+    ImVec2 headless_display_size{ 1280.f, 720.f };
 
+    void update_damage();
+    void record_metrics(uint64_t submit_start_us);
+    void submit_threaded();
+    void submit_frame(render_frame& frame);
+    bool initialize_headless();
+    bool should_skip_frame();
+    DWORD idle_wait_ms() const;
     bool CreateDeviceD3D(HWND hWnd);
     void CleanupDeviceD3D();
     void CreateRenderTarget();
     void CleanupRenderTarget();
     static LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
+    static void observe_input(unsigned int msg, bool after, void* user_data);
 
 public:
     c_imgui_manager();
     ~c_imgui_manager();
 
-    bool initialize(const std::string& title);
+    // Headless mode skips the window, device and backends; frames are built and
+    // ImGui::Render'ed but never submitted. Used for allocation checks and replays.
+    bool initialize(const std::string& title, bool headless_mode = false);
+    // Before initialize(): every font is loaded from this TTF. Empty uses Bahnschrift from
+    // the Windows fonts directory when windowed and ImGui's embedded font headless, which is
+    // also the fallback for a missing file.
+    void set_font_path(const std::string& path) { font_path = path; }
+    // Before initialize(): the display headless frames are laid out on.
+    void set_headless_display_size(int width, int height);
     ImFont* get_font(const char* font_name);
     void initalize_fonts();
     void shutdown();
@@ -61,8 +130,59 @@ public:
     void present();
 
     HWND get_hwnd() const { return hwnd; }
+    bool is_headless() const { return headless; }
+    c_ui_allocator& get_allocator() { return allocator; }
+    void get_upload_stats(upload_ring_stats* out_vtx, upload_ring_stats* out_idx) const;
+    const draw_optimizer_stats& get_draw_stats() const { return draw_optimizer.last_frame_stats(); }
+    c_draw_cache& get_draw_cache() { return draw_cache; }
+
+    // When enabled, a frame whose draw data hashes the same as the last presented one is
+    // neither submitted nor presented. Resizes, device loss and request_present() force
+    // the next frame through regardless.
+    void set_frame_skip(bool enabled);
+    bool is_frame_skip_enabled() const { return frame_skip_enabled; }
+    void request_present();
+    bool was_frame_skipped() const { return frame_skipped; }
+    const frame_skip_stats& get_frame_skip_stats() const { return skip_stats; }
+    // A skipped frame sleeps until input, wake(), the time set here (steady clock, us) or
+    // max_idle_wait_ms, whichever comes first. Set every frame; UINT64_MAX means nothing
+    // is scheduled.
+    void set_next_wake_us(uint64_t us) { next_wake_us = us; }
+    void set_max_idle_wait_ms(DWORD ms) { max_idle_wait_ms = ms; }
+    // Any thread: ends the current idle sleep.
+    void wake();
+
+    // Headless only: rasterize each frame on the CPU so pixels are available without a device.
+    void set_software_rendering(bool enabled);
+    bool is_software_rendering() const { return software_rendering; }
+    const c_soft_renderer& get_soft_renderer() const { return soft_renderer; }
+    // Summed over every render target of the last frame; full means at least one was redrawn entirely.
+    const damage_stats& get_damage_stats() const { return frame_damage; }
+
+    // Windowed only: render() snapshots the draw data and a render thread submits and
+    // presents it, so building frame N+1 overlaps the GPU work and vsync of frame N.
+    void set_threaded_rendering(bool enabled);
+    bool is_threaded_rendering() const { return threaded_rendering; }
+    const render_thread_stats& get_render_thread_stats() const { return render_thread.stats(); }
+    int get_pending_render_frames() { return threaded_rendering ? render_thread.pending_frames() : 0; }
+
+    // Time from an input message (key/char/button press, wheel) arriving to the present of
+    // the first frame that processed it. Headless frames count as presented when rendered.
+    latency_histogram get_input_latency() const { return latency.histogram(); }
+    void reset_input_latency() { latency.reset(); }
+    // Synthetic input, stamped like window messages. Takes effect on the next new_frame().
+    void queue_text_input(const char* utf8);
+    void queue_key_input(ImGuiKey key, bool down);
     void set_should_close(bool close);
 
+    // Frame metrics are recorded every frame; the overlay draws itself when toggled.
+    c_perf_overlay& get_perf_overlay() { return perf_overlay; }
+
+    // Logs every frame's delta time and consumed input events while recording.
+    c_input_recorder& get_input_recorder() { return recorder; }
+    // Headless only: delta time of the next frame instead of the fixed 1/60 s (replays).
+    void set_next_delta_time(float delta_time) { next_delta_time = delta_time; }
+
     // Utility functions
     void set_window_title(const std::string& title);
 };
@@ -0,0 +1,281 @@
+#include "input_recorder.h"
+#include <cstring>
+
+namespace {
+    constexpr char kMagic[4] = { 'L', 'U', 'I', 'R' };
+    constexpr size_t kFlushBytes = 64 * 1024;
+
+    void encode_event(c_log_writer& out, const ImGuiInputEvent& event) {
+        out.put_u8(static_cast<uint8_t>(event.Type));
+        out.put_u8(static_cast<uint8_t>(event.Source));
+        switch (event.Type) {
+        case ImGuiInputEventType_MousePos:
+            out.put_f32(event.MousePos.PosX);
+            out.put_f32(event.MousePos.PosY);
+            out.put_u8(static_cast<uint8_t>(event.MousePos.MouseSource));
+            break;
+        case ImGuiInputEventType_MouseWheel:
+            out.put_f32(event.MouseWheel.WheelX);
+            out.put_f32(event.MouseWheel.WheelY);
+            out.put_u8(static_cast<uint8_t>(event.MouseWheel.MouseSource));
+            break;
+        case ImGuiInputEventType_MouseButton:
+            out.put_varint(static_cast<uint64_t>(event.MouseButton.Button));
+            out.put_bool(event.MouseButton.Down);
+            out.put_u8(static_cast<uint8_t>(event.MouseButton.MouseSource));
+            break;
+        case ImGuiInputEventType_MouseViewport:
+            out.put_varint(event.MouseViewport.HoveredViewportID);
+            break;
+        case ImGuiInputEventType_Key:
+            out.put_varint(static_cast<uint64_t>(event.Key.Key));
+            out.put_bool(event.Key.Down);
+            out.put_f32(event.Key.AnalogValue);
+            break;
+        case ImGuiInputEventType_Text:
+            out.put_varint(event.Text.Char);
+            break;
+        case ImGuiInputEventType_Focus:
+            out.put_bool(event.AppFocused.Focused);
+            break;
+        default:
+            break;
+        }
+    }
+
+    bool decode_event(c_log_reader& in, ImGuiInputEvent& event) {
+        event = ImGuiInputEvent();
+        event.Type = static_cast<ImGuiInputEventType>(in.get_u8());
+        event.Source = static_cast<ImGuiInputSource>(in.get_u8());
+        switch (event.Type) {
+        case ImGuiInputEventType_MousePos:
+            event.MousePos.PosX = in.get_f32();
+            event.MousePos.PosY = in.get_f32();
+            event.MousePos.MouseSource = static_cast<ImGuiMouseSource>(in.get_u8());
+            break;
+        case ImGuiInputEventType_MouseWheel:
+            event.MouseWheel.WheelX = in.get_f32();
+            event.MouseWheel.WheelY = in.get_f32();
+            event.MouseWheel.MouseSource = static_cast<ImGuiMouseSource>(in.get_u8());
+            break;
+        case ImGuiInputEventType_MouseButton:
+            event.MouseButton.Button = static_cast<int>(in.get_varint());
+            event.MouseButton.Down = in.get_bool();
+            event.MouseButton.MouseSource = static_cast<ImGuiMouseSource>(in.get_u8());
+            break;
+        case ImGuiInputEventType_MouseViewport:
+            event.MouseViewport.HoveredViewportID = static_cast<ImGuiID>(in.get_varint());
+            break;
+        case ImGuiInputEventType_Key:
+            event.Key.Key = static_cast<ImGuiKey>(in.get_varint());
+            event.Key.Down = in.get_bool();
+            event.Key.AnalogValue = in.get_f32();
+            break;
+        case ImGuiInputEventType_Text:
+            event.Text.Char = static_cast<unsigned int>(in.get_varint());
+            break;
+        case ImGuiInputEventType_Focus:
+            event.AppFocused.Focused = in.get_bool();
+            break;
+        default:
+            return false;
+        }
+        return in.ok();
+    }
+}
+
+void c_log_writer::put_varint(uint64_t value) {
+    while (value >= 0x80) {
+        bytes_.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    bytes_.push_back(static_cast<uint8_t>(value));
+}
+
+void c_log_writer::put_f32(float value) {
+    put_bytes(&value, sizeof(value));
+}
+
+void c_log_writer::put_string(const std::string& value) {
+    put_varint(value.size());
+    put_bytes(value.data(), value.size());
+}
+
+void c_log_writer::put_bytes(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    bytes_.insert(bytes_.end(), bytes, bytes + size);
+}
+
+bool c_log_reader::take(size_t count) {
+    if (!ok_ || size_ - offset_ < count) {
+        ok_ = false;
+        return false;
+    }
+    return true;
+}
+
+uint8_t c_log_reader::get_u8() {
+    if (!take(1))
+        return 0;
+    return data_[offset_++];
+}
+
+uint64_t c_log_reader::get_varint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const uint8_t byte = get_u8();
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return ok_ ? value : 0;
+    }
+    ok_ = false;
+    return 0;
+}
+
+float c_log_reader::get_f32() {
+    float value = 0.f;
+    if (take(sizeof(value))) {
+        memcpy(&value, data_ + offset_, sizeof(value));
+        offset_ += sizeof(value);
+    }
+    return value;
+}
+
+std::string c_log_reader::get_string() {
+    const uint64_t size = get_varint();
+    if (!take(static_cast<size_t>(size)))
+        return std::string();
+    std::string value(reinterpret_cast<const char*>(data_ + offset_), static_cast<size_t>(size));
+    offset_ += static_cast<size_t>(size);
+    return value;
+}
+
+bool c_log_reader::get_bytes(std::vector<unsigned char>& out) {
+    const uint64_t size = get_varint();
+    if (!take(static_cast<size_t>(size)))
+        return false;
+    out.assign(data_ + offset_, data_ + offset_ + size);
+    offset_ += static_cast<size_t>(size);
+    return true;
+}
+
+bool c_input_recorder::start(const char* path) {
+    stop();
+    file_ = fopen(path, "wb");
+    if (!file_)
+        return false;
+
+    frame_ = 0;
+    pending_.assign(kMagic, kMagic + sizeof(kMagic));
+    const uint32_t version = kVersion;
+    pending_.insert(pending_.end(), reinterpret_cast<const uint8_t*>(&version), reinterpret_cast<const uint8_t*>(&version) + sizeof(version));
+    return true;
+}
+
+void c_input_recorder::stop() {
+    if (!file_)
+        return;
+    if (!pending_.empty())
+        fwrite(pending_.data(), 1, pending_.size(), file_);
+    fclose(file_);
+    file_ = nullptr;
+    pending_.clear();
+}
+
+void c_input_recorder::record_frame(float delta_time, const ImVector<ImGuiInputEvent>& events) {
+    if (!file_)
+        return;
+
+    payload_.clear();
+    payload_.put_f32(delta_time);
+    payload_.put_varint(static_cast<uint64_t>(events.Size));
+    for (const ImGuiInputEvent& event : events)
+        encode_event(payload_, event);
+    write_record(log_record_type::frame, payload_.bytes());
+    frame_++;
+}
+
+void c_input_recorder::record(log_record_type type, const c_log_writer& payload) {
+    if (file_)
+        write_record(type, payload.bytes());
+}
+
+void c_input_recorder::write_record(log_record_type type, const std::vector<uint8_t>& payload) {
+    record_.clear();
+    record_.put_u8(static_cast<uint8_t>(type));
+    record_.put_varint(frame_);
+    record_.put_varint(payload.size());
+    pending_.insert(pending_.end(), record_.bytes().begin(), record_.bytes().end());
+    pending_.insert(pending_.end(), payload.begin(), payload.end());
+
+    if (pending_.size() >= kFlushBytes) {
+        fwrite(pending_.data(), 1, pending_.size(), file_);
+        pending_.clear();
+    }
+}
+
+bool c_input_log::load(const char* path) {
+    data_.clear();
+    offset_ = 0;
+    truncated_ = false;
+
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+    uint8_t chunk[64 * 1024];
+    size_t read = 0;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        data_.insert(data_.end(), chunk, chunk + read);
+    fclose(file);
+
+    uint32_t version = 0;
+    if (data_.size() < sizeof(kMagic) + sizeof(version) || memcmp(data_.data(), kMagic, sizeof(kMagic)) != 0)
+        return false;
+    memcpy(&version, data_.data() + sizeof(kMagic), sizeof(version));
+    if (version != c_input_recorder::kVersion)
+        return false;
+    offset_ = sizeof(kMagic) + sizeof(version);
+    return true;
+}
+
+bool c_input_log::next(log_record& out) {
+    if (offset_ >= data_.size())
+        return false;
+
+    c_log_reader header(data_.data() + offset_, data_.size() - offset_);
+    out.type = static_cast<log_record_type>(header.get_u8());
+    out.frame = header.get_varint();
+    const uint64_t size = header.get_varint();
+    if (!header.ok()) {
+        truncated_ = true;
+        return false;
+    }
+
+    const size_t start = offset_ + header.offset();
+    if (data_.size() - start < size) {
+        truncated_ = true;
+        return false;
+    }
+
+    out.payload = data_.data() + start;
+    out.size = static_cast<size_t>(size);
+    offset_ = start + out.size;
+    return true;
+}
+
+bool c_input_log::queue_frame(const log_record& record, float& delta_time, int& event_count) {
+    ImGuiContext& g = *GImGui;
+    c_log_reader in(record.payload, record.size);
+    delta_time = in.get_f32();
+    const uint64_t count = in.get_varint();
+    event_count = 0;
+    for (uint64_t i = 0; i < count && in.ok(); i++) {
+        ImGuiInputEvent event;
+        if (!decode_event(in, event))
+            return false;
+        event.EventId = g.InputEventsNextEventId++;
+        g.InputEventsQueue.push_back(event);
+        event_count++;
+    }
+    return in.ok();
+}
@@ -0,0 +1,132 @@
+#ifndef INPUT_RECORDER_HPP
+#define INPUT_RECORDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "../dep/imgui/imgui.h"
+#include "../dep/imgui/imgui_internal.h"
+
+// Session log: "LUIR", u32 version, then records of
+//   u8 type, varint frame, varint payload size, payload
+// Integers are LEB128 varints, floats raw little-endian. A frame record holds the delta
+// time and every input event ImGui consumed in that frame; state records hold the
+// arguments of a host call and are written when the call happens. A host callback the
+// UI invokes is bracketed by callback/callback_return records naming it, so calls the
+// host makes from inside it replay at the same point of the frame. A clock record holds
+// the wall clock when recording started.
+enum class log_record_type : uint8_t {
+    frame = 1,
+    authenticated = 2,
+    status_message = 3,
+    error_message = 4,
+    loading = 5,
+    loading_progress = 6,
+    local_account = 7,
+    license_only_mode = 8,
+    subscription_delta = 9,
+    download_progress = 10,
+    download_finished = 11,
+    filestream_chunk = 12,
+    filestream_failed = 13,
+    clock = 14,
+    callback = 15,
+    callback_return = 16,
+};
+
+class c_log_writer {
+public:
+    void put_u8(uint8_t value) { bytes_.push_back(value); }
+    void put_bool(bool value) { put_u8(value ? 1 : 0); }
+    void put_varint(uint64_t value);
+    void put_f32(float value);
+    void put_string(const std::string& value);
+    void put_bytes(const void* data, size_t size);
+
+    void clear() { bytes_.clear(); }
+    const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+private:
+    std::vector<uint8_t> bytes_;
+};
+
+// Reads fail sticky: after the first short read every getter returns zero and ok() is false.
+class c_log_reader {
+public:
+    c_log_reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    uint8_t get_u8();
+    bool get_bool() { return get_u8() != 0; }
+    uint64_t get_varint();
+    float get_f32();
+    std::string get_string();
+    bool get_bytes(std::vector<unsigned char>& out);
+
+    bool ok() const { return ok_; }
+    size_t offset() const { return offset_; }
+
+private:
+    bool take(size_t count);
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_ = 0;
+    bool ok_ = true;
+};
+
+class c_input_recorder {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    ~c_input_recorder() { stop(); }
+
+    bool start(const char* path);
+    // Flushes and closes the log.
+    void stop();
+    bool recording() const { return file_ != nullptr; }
+    uint64_t frame() const { return frame_; }
+
+    // Right after ImGui::NewFrame: the delta time and g.InputEventsTrail.
+    void record_frame(float delta_time, const ImVector<ImGuiInputEvent>& events);
+    void record(log_record_type type, const c_log_writer& payload);
+
+private:
+    void write_record(log_record_type type, const std::vector<uint8_t>& payload);
+
+    FILE* file_ = nullptr;
+    uint64_t frame_ = 0;
+    c_log_writer record_;
+    c_log_writer payload_;
+    std::vector<uint8_t> pending_;
+};
+
+struct log_record {
+    log_record_type type;
+    uint64_t frame;
+    const uint8_t* payload;
+    size_t size;
+};
+
+class c_input_log {
+public:
+    bool load(const char* path);
+    // False at the end or on a truncated record.
+    bool next(log_record& out);
+    bool truncated() const { return truncated_; }
+    // For reading ahead: seek(tell()) returns to the same record.
+    size_t tell() const { return offset_; }
+    void seek(size_t offset) { offset_ = offset; }
+
+    // Decodes a frame record and queues its events for the next NewFrame, exactly as
+    // recorded (no io.Add*Event filtering).
+    static bool queue_frame(const log_record& record, float& delta_time, int& event_count);
+
+private:
+    std::vector<uint8_t> data_;
+    size_t offset_ = 0;
+    bool truncated_ = false;
+};
+
+#endif // INPUT_RECORDER_HPP
@@ -0,0 +1,133 @@
+#include "latency.h"
+#include "../dep/imgui/imgui_internal.h"
+#include <bit>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    // Presses, text and wheel are what a user waits on; motion and releases are not counted.
+    bool is_press(const ImGuiInputEvent& event) {
+        switch (event.Type) {
+        case ImGuiInputEventType_Key:
+            return event.Key.Down;
+        case ImGuiInputEventType_MouseButton:
+            return event.MouseButton.Down;
+        case ImGuiInputEventType_Text:
+        case ImGuiInputEventType_MouseWheel:
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+int latency_histogram::bucket_index(uint64_t us) {
+    if (us < kSubBuckets)
+        return static_cast<int>(us);
+    const int octave = static_cast<int>(std::bit_width(us)) - 1;
+    const int index = (octave - 1) * kSubBuckets + static_cast<int>((us >> (octave - 2)) & (kSubBuckets - 1));
+    return index < kBucketCount ? index : kBucketCount - 1;
+}
+
+uint64_t latency_histogram::bucket_upper_us(int index) {
+    if (index < kSubBuckets)
+        return static_cast<uint64_t>(index) + 1;
+    const int octave = index / kSubBuckets + 1;
+    const int sub = index % kSubBuckets;
+    return static_cast<uint64_t>(kSubBuckets + 1 + sub) << (octave - 2);
+}
+
+void latency_histogram::add(uint64_t us) {
+    counts[bucket_index(us)]++;
+    samples++;
+    total_us += us;
+    if (us > max_us)
+        max_us = us;
+}
+
+double latency_histogram::percentile_us(double p) const {
+    if (samples == 0)
+        return 0.0;
+    const uint64_t target = static_cast<uint64_t>(std::ceil(p * static_cast<double>(samples)));
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        seen += counts[i];
+        if (seen >= target && seen > 0) {
+            const uint64_t upper = bucket_upper_us(i);
+            return static_cast<double>(upper < max_us ? upper : max_us);
+        }
+    }
+    return static_cast<double>(max_us);
+}
+
+uint64_t c_latency_tracker::now_us() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void c_latency_tracker::begin_input() {
+    // WndProc handlers can re-enter; only the outermost call stamps.
+    if (depth_++ > 0 || ImGui::GetCurrentContext() == nullptr)
+        return;
+    open_first_id_ = GImGui->InputEventsNextEventId;
+    open_us_ = now_us();
+}
+
+void c_latency_tracker::end_input() {
+    if (depth_ == 0 || --depth_ > 0 || ImGui::GetCurrentContext() == nullptr)
+        return;
+    const ImU32 end_id = GImGui->InputEventsNextEventId;
+    if (end_id != open_first_id_)
+        pending_.push_back(stamp{ open_first_id_, end_id, open_us_, false });
+}
+
+void c_latency_tracker::collect_frame() {
+    const ImGuiContext& g = *GImGui;
+    for (const ImGuiInputEvent& event : g.InputEventsTrail) {
+        if (!is_press(event))
+            continue;
+        for (stamp& s : pending_) {
+            if (event.EventId < s.first_id || event.EventId >= s.end_id)
+                continue;
+            if (!s.recorded) {
+                s.recorded = true;
+                frame_.push_back(s.us);
+            }
+            break;
+        }
+    }
+
+    // Trickled events stay queued for later frames; only fully processed messages go.
+    const ImU32 first_queued = g.InputEventsQueue.Size > 0 ? g.InputEventsQueue[0].EventId : g.InputEventsNextEventId;
+    size_t kept = 0;
+    for (const stamp& s : pending_) {
+        if (s.end_id > first_queued)
+            pending_[kept++] = s;
+    }
+    pending_.resize(kept);
+}
+
+void c_latency_tracker::complete_frame(uint64_t present_us) {
+    if (frame_.empty())
+        return;
+    complete(frame_.data(), frame_.size(), present_us);
+    frame_.clear();
+}
+
+void c_latency_tracker::complete(const uint64_t* stamps, size_t count, uint64_t present_us) {
+    if (count == 0)
+        return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count; i++)
+        histogram_.add(present_us > stamps[i] ? present_us - stamps[i] : 0);
+}
+
+latency_histogram c_latency_tracker::histogram() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return histogram_;
+}
+
+void c_latency_tracker::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    histogram_.clear();
+}
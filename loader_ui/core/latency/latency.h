@@ -0,0 +1,73 @@
+#ifndef LATENCY_HPP
+#define LATENCY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "../dep/imgui/imgui.h"
+
+// Log-linear histogram of microsecond samples: values below 4 get their own bucket,
+// every octave above is split into kSubBuckets equal parts (<= 25% relative error).
+struct latency_histogram {
+    static constexpr int kSubBuckets = 4;
+    static constexpr int kBucketCount = 80;     // up to ~2 s, larger samples land in the last bucket
+
+    uint64_t counts[kBucketCount] = {};
+    uint64_t samples = 0;
+    uint64_t total_us = 0;
+    uint64_t max_us = 0;
+
+    void add(uint64_t us);
+    void clear() { *this = latency_histogram{}; }
+
+    static int bucket_index(uint64_t us);
+    // Exclusive upper bound of a bucket, in microseconds.
+    static uint64_t bucket_upper_us(int index);
+
+    double mean_us() const { return samples ? double(total_us) / double(samples) : 0.0; }
+    // Upper bound of the bucket holding the p-th fraction (0..1) of samples.
+    double percentile_us(double p) const;
+};
+
+// Input-to-present latency. Every call that queues ImGui input events is bracketed by
+// begin_input()/end_input(), which stamps the event ids it produced with the arrival
+// time. After NewFrame, collect_frame() picks up the stamps of the press/text events the
+// frame processed; whoever presents that frame hands them to complete() with the present
+// time. A message counts once, at the first frame that processed any of its events.
+class c_latency_tracker {
+public:
+    static uint64_t now_us();
+
+    // ImGui thread.
+    void begin_input();
+    void end_input();
+    void collect_frame();
+    std::vector<uint64_t>& frame_stamps() { return frame_; }
+    // Completes and clears frame_stamps().
+    void complete_frame(uint64_t present_us);
+
+    // Any thread.
+    void complete(const uint64_t* stamps, size_t count, uint64_t present_us);
+    latency_histogram histogram() const;
+    void reset();
+
+private:
+    struct stamp {
+        ImU32 first_id;
+        ImU32 end_id;
+        uint64_t us;
+        bool recorded;
+    };
+
+    std::vector<stamp> pending_;
+    std::vector<uint64_t> frame_;
+    int depth_ = 0;
+    ImU32 open_first_id_ = 0;
+    uint64_t open_us_ = 0;
+
+    mutable std::mutex mutex_;
+    latency_histogram histogram_;
+};
+
+#endif // LATENCY_HPP
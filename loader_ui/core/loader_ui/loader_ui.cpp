@@ -1,6 +1,13 @@
 #define IMGUI_DEFINE_MATH_OPERATORS
 #include "loader_ui.h"
 #include "../imgui_manager/imgui_manager.h"
+#include "../profiler/profiler.h"
+#include "../timer_wheel/timer_wheel.h"
+#include "../expiry/expiry.h"
+#include "../subscription_store/subscription_store.h"
+#include "../profile_snapshot/profile_snapshot.h"
+#include "../download_scheduler/download_scheduler.h"
+#include "../filestream_session/filestream_session.h"
 #include "../dep/imgui/imgui.h"
 #include <iostream>
 #include <cstring>
@@ -8,17 +15,237 @@
 #include <array>
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
 #include <string_view>
+#include <mutex>
 #include "../dep/imgui/imgui_internal.h"
 
 static c_imgui_manager* imgui_manager = nullptr;
 
+// Windows open centred on the primary monitor, or on the display headless.
+static ImVec2 screen_center() {
+    if (imgui_manager && imgui_manager->is_headless())
+        return ImGui::GetIO().DisplaySize * 0.5f;
+    return ImVec2(GetSystemMetrics(SM_CXSCREEN) * 0.5f, GetSystemMetrics(SM_CYSCREEN) * 0.5f);
+}
+
+// Messages are drawn inside cached windows and ui_state is public, so they are keyed by content.
+static uint64_t hash_messages(const ui_state& state) {
+    const uint64_t status = frame_hash_bytes(state.status_message.data(), state.status_message.size(), 0);
+    return frame_hash_bytes(state.error_message.data(), state.error_message.size(), status);
+}
+
+// Host callbacks show up in the trace and in the perf overlay's callback timings, and
+// are bracketed in the session log so a replay knows which host calls they made.
+class callback_scope {
+public:
+    explicit callback_scope(const char* name)
+        : name_(name), start_us_(c_profiler::now_us())
+#ifndef LOADER_UI_DISABLE_PROFILER
+        , profile_(name, "callback")
+#endif
+    {
+        mark(log_record_type::callback);
+    }
+    ~callback_scope() {
+        mark(log_record_type::callback_return);
+        if (imgui_manager)
+            imgui_manager->get_perf_overlay().add_callback_time(name_, (c_profiler::now_us() - start_us_) / 1000.f);
+    }
+
+private:
+    void mark(log_record_type type) const {
+        if (!imgui_manager || !imgui_manager->get_input_recorder().recording())
+            return;
+        c_log_writer payload;
+        payload.put_string(name_);
+        imgui_manager->get_input_recorder().record(type, payload);
+    }
+
+    const char* name_;
+    uint64_t start_us_;
+#ifndef LOADER_UI_DISABLE_PROFILER
+    c_profile_scope profile_;
+#endif
+};
+
+// Texture sizes for stats; every texture the UI creates is 32 bits per texel.
+static uint64_t texture_bytes(ID3D11ShaderResourceView* view) {
+    if (!view)
+        return 0;
+
+    ID3D11Resource* resource = nullptr;
+    view->GetResource(&resource);
+    if (!resource)
+        return 0;
+
+    uint64_t bytes = 0;
+    D3D11_RESOURCE_DIMENSION dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+    resource->GetType(&dimension);
+    if (dimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
+        D3D11_TEXTURE2D_DESC desc;
+        static_cast<ID3D11Texture2D*>(resource)->GetDesc(&desc);
+        bytes = static_cast<uint64_t>(desc.Width) * desc.Height * desc.ArraySize * 4;
+    }
+    resource->Release();
+    return bytes;
+}
+
+// Host calls are logged with their arguments so a replay repeats them between the same frames.
+template <typename Encode>
+static void record_call(log_record_type type, Encode&& encode) {
+    if (!imgui_manager || !imgui_manager->get_input_recorder().recording())
+        return;
+    c_log_writer payload;
+    encode(payload);
+    imgui_manager->get_input_recorder().record(type, payload);
+}
+
+// Video payloads are left out of the log; they can be megabytes and nothing draws them yet.
+static void encode_subscription(c_log_writer& out, const user_subscription& sub, const unsigned char* image, size_t image_size) {
+    out.put_string(sub.plan);
+    out.put_string(sub.expires_at);
+    out.put_string(sub.status);
+    out.put_bool(sub.frozen);
+    out.put_string(sub.plan_id);
+    out.put_string(sub.default_file_id);
+    out.put_string(sub.product_image_mime);
+    out.put_string(sub.product_image_updated_at);
+    out.put_varint(image_size);
+    out.put_bytes(image, image_size);
+    out.put_string(sub.product_video_mime);
+    out.put_string(sub.product_video_updated_at);
+    out.put_string(sub.product_video_path);
+}
+
+static void decode_subscription(c_log_reader& in, user_subscription& sub) {
+    sub.plan = in.get_string();
+    sub.expires_at = in.get_string();
+    sub.status = in.get_string();
+    sub.frozen = in.get_bool();
+    sub.plan_id = in.get_string();
+    sub.default_file_id = in.get_string();
+    sub.product_image_mime = in.get_string();
+    sub.product_image_updated_at = in.get_string();
+    in.get_bytes(sub.product_image);
+    sub.product_video_mime = in.get_string();
+    sub.product_video_updated_at = in.get_string();
+    sub.product_video_path = in.get_string();
+}
+
+static void encode_profile(c_log_writer& out, const user_profile& profile) {
+    out.put_string(profile.username);
+    out.put_string(profile.email);
+    out.put_string(profile.ip);
+    out.put_varint(profile.subscriptions.size());
+    for (const user_subscription* sub : profile.subscriptions) {
+        out.put_bool(sub != nullptr);
+        if (sub)
+            encode_subscription(out, *sub, sub->product_image.data(), sub->product_image.size());
+    }
+}
+
+static bool decode_profile(c_log_reader& in, user_profile& profile, std::vector<std::unique_ptr<user_subscription>>& storage) {
+    profile = user_profile{};
+    profile.username = in.get_string();
+    profile.email = in.get_string();
+    profile.ip = in.get_string();
+    const uint64_t count = in.get_varint();
+    for (uint64_t i = 0; i < count && in.ok(); i++) {
+        if (!in.get_bool()) {
+            profile.subscriptions.push_back(nullptr);
+            continue;
+        }
+        auto sub = std::make_unique<user_subscription>();
+        decode_subscription(in, *sub);
+        profile.subscriptions.push_back(sub.get());
+        storage.push_back(std::move(sub));
+    }
+    return in.ok();
+}
+
+struct subscription_delta {
+    enum class kind : uint8_t { upsert, remove, patch, image, video };
+    enum patch_field : uint8_t {
+        patch_plan = 1 << 0,
+        patch_status = 1 << 1,
+        patch_expires_at = 1 << 2,
+        patch_default_file_id = 1 << 3,
+        patch_frozen = 1 << 4,
+    };
+
+    kind type = kind::upsert;
+    std::string plan_id;
+    uint8_t fields = 0;             // patch: which fields of `values` to copy
+    user_subscription values;       // upsert: the whole record; otherwise the new values
+};
+
+struct c_loader_ui::delta_queue {
+    std::mutex mutex;
+    std::vector<subscription_delta> pending;
+};
+
+struct c_loader_ui::download_event {
+    enum class kind : uint8_t {
+        loading,
+        fraction,
+        progress,
+        finished,
+        chunk,
+        failed,
+    };
+    kind type = kind::progress;
+    std::string file_id;
+    uint64_t offset = 0;                // chunk
+    uint64_t length = 0;                // chunk
+    uint64_t done_bytes = 0;
+    uint64_t total_bytes = 0;
+    float fraction = 0.f;
+    bool flag = false;                  // loading: active; finished: ok
+};
+
+struct c_loader_ui::download_event_queue {
+    std::mutex mutex;
+    std::vector<download_event> pending;
+};
+
+struct media_release_queue {
+    std::mutex mutex;
+    std::vector<std::pair<void (*)(void*), void*>> pending;
+};
+
+static void encode_delta(c_log_writer& out, const subscription_delta& delta) {
+    out.put_u8(static_cast<uint8_t>(delta.type));
+    out.put_string(delta.plan_id);
+    out.put_u8(delta.fields);
+    encode_subscription(out, delta.values, delta.values.product_image.data(), delta.values.product_image.size());
+}
+
+static bool decode_delta(c_log_reader& in, subscription_delta& delta) {
+    delta.type = static_cast<subscription_delta::kind>(in.get_u8());
+    delta.plan_id = in.get_string();
+    delta.fields = in.get_u8();
+    decode_subscription(in, delta.values);
+    return in.ok() && delta.type <= subscription_delta::kind::video;
+}
+
 c_loader_ui::c_loader_ui()
-    : should_close(false), initialized(false) {
+    : should_close(false), initialized(false), timers_(std::make_unique<c_timer_wheel>()),
+      subscriptions_(std::make_unique<c_subscription_store>()), deltas_(std::make_unique<delta_queue>()),
+      media_releases_(std::make_shared<media_release_queue>()),
+      download_transport_(std::make_unique<c_callback_transport>([this](const std::string& file_id) { handle_launch_request(file_id); })),
+      filestream_transport_(std::make_unique<c_filestream_transport>([this](const std::string& file_id, const std::vector<byte_range>& ranges) {
+          request_file_ranges(file_id, ranges);
+      })),
+      downloads_(std::make_unique<c_download_scheduler>(download_transport_.get())),
+      download_events_(std::make_unique<download_event_queue>()) {
+    downloads_->set_finished_callback([this](const download_item& item) { on_download_finished(item); });
 }
 
 c_loader_ui::~c_loader_ui() {
     shutdown();
+    subscriptions_->clear();
+    run_media_releases();
 }
 
 bool c_loader_ui::initialize(const ui_config& cfg) {
@@ -27,19 +254,32 @@ bool c_loader_ui::initialize(const ui_config& cfg) {
     }
 
     config = cfg;
+    c_profiler::set_enabled(config.profiling);
+    c_profiler::set_thread_name("ui");
 
     if (!imgui_manager) {
         imgui_manager = new c_imgui_manager();
     }
 
-    if (!imgui_manager->initialize(config.title)) {
+    imgui_manager->set_font_path(config.font_path ? config.font_path : "");
+    imgui_manager->set_headless_display_size(config.display_width, config.display_height);
+    if (!imgui_manager->initialize(config.title, config.headless)) {
         std::cerr << "Failed to initialize ImGui manager" << std::endl;
         return false;
     }
+    imgui_manager->set_frame_skip(config.frame_skip);
+    imgui_manager->set_software_rendering(config.software_render);
+    imgui_manager->set_threaded_rendering(config.render_thread);
+    imgui_manager->set_max_idle_wait_ms(config.max_idle_wait_ms);
+    downloads_->set_max_sessions(config.download_sessions);
+    download_transport_->set_finish_on_return(!config.report_downloads);
+    if (config.filestream_checkpoint_directory)
+        filestream_transport_->set_directory(std::filesystem::u8path(config.filestream_checkpoint_directory));
 
     apply_base_theme();
 
     initialized = true;
+    load_profile_snapshot();
     std::cout << "UI initialized successfully" << std::endl;
     return true;
 }
@@ -49,22 +289,24 @@ void c_loader_ui::shutdown() {
         return;
     }
 
+    // Written only here, off the frame path; includes deltas applied since sign-in.
+    if (state.authenticated)
+        save_profile_snapshot();
+
     state = ui_state{};
     license_redeem_pending_ = false;
     license_success_active_ = false;
     license_success_message_.clear();
-    load_animation_active_ = false;
     load_completion_popup_pending_ = false;
-    load_animation_product_.clear();
     load_completion_message_.clear();
-    load_animation_stop_requested_ = false;
-    selected_subscription_snapshot_ = nullptr;
-    pending_file_id_.clear();
-    pending_product_name_.clear();
-    download_start_enqueued_ = false;
-    download_delay_until_ = {};
-    download_active_ = false;
-    download_progress_ = 0.f;
+    cancel_pending_launch();
+    selected_product_row_ = -1;
+    status_column_width_ = 0.f;
+    downloads_->clear();
+    timers_->clear();
+    license_banner_timer_ = 0;
+    load_animation_timer_ = 0;
+    download_timer_ = 0;
 
     if (imgui_manager) {
         imgui_manager->shutdown();
@@ -88,71 +330,27 @@ void c_loader_ui::update() {
         return;
     }
 
+    run_media_releases();
+    apply_download_events();
+    apply_subscription_deltas();
     imgui_manager->new_frame();
+    timers_->advance(clock_us());
+    downloads_->tick(clock_us());
 }
 
-std::string format_expiration_remaining(const std::string& timestamp)
-{
-    if (timestamp.empty())
-        return "-";
-
-    std::tm tm{};
-    std::istringstream iss(timestamp);
-    iss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-    if (iss.fail())
-        return timestamp;
-
-    long microseconds = 0;
-    if (iss.peek() == '.')
-    {
-        iss.get();
-        std::string fractional;
-        std::getline(iss, fractional);
-        if (!fractional.empty())
-        {
-            while (fractional.size() < 6)
-                fractional.push_back('0');
-            try
-            {
-                microseconds = std::stol(fractional.substr(0, 6));
-            }
-            catch (...)
-            {
-                microseconds = 0;
-            }
-        }
-    }
-
-    time_t utc_time = _mkgmtime(&tm);
-    if (utc_time == static_cast<time_t>(-1))
-        return timestamp;
-
-    auto expiry_tp = std::chrono::system_clock::from_time_t(utc_time) + std::chrono::microseconds(microseconds);
-    auto now = std::chrono::system_clock::now();
-    if (expiry_tp <= now)
-        return "Expired";
-
-    auto remaining = std::chrono::duration_cast<std::chrono::seconds>(expiry_tp - now);
-    long long total_seconds = remaining.count();
-    long long days = total_seconds / 86400;
-    total_seconds %= 86400;
-    long long hours = total_seconds / 3600;
-    total_seconds %= 3600;
-    long long minutes = total_seconds / 60;
-    long long seconds = total_seconds % 60;
+uint64_t c_loader_ui::clock_us() const {
+    return replay_clock_ ? replay_clock_us_ : c_timer_wheel::now_us();
+}
 
-    std::ostringstream oss;
-    oss << days << "d "
-        << std::setw(2) << std::setfill('0') << hours << "h "
-        << std::setw(2) << std::setfill('0') << minutes << "m "
-        << std::setw(2) << std::setfill('0') << seconds << "s";
-    return oss.str();
+int64_t c_loader_ui::wall_us() const {
+    return replay_clock_ ? replay_wall_us_ : wall_clock_us();
 }
 
 void c_loader_ui::render() {
     if (!initialized || !imgui_manager) {
         return;
     }
+    next_expiry_change_us_ = c_expiry_countdown::kNever;
 
     render_auth_mode_window();
 
@@ -168,19 +366,39 @@ void c_loader_ui::render() {
         render_main_window();
     }
 
+    c_perf_overlay& overlay = imgui_manager->get_perf_overlay();
+    int media_images = 0;
+    for (const product_view& view : products) {
+        if (view.image)
+            media_images++;
+    }
+    overlay.set_media_counts(media_images, static_cast<int>(video_players.size()), static_cast<int>(video_cache_paths.size()));
+    overlay.draw();
+
     imgui_manager->render();
+
+    // Download progress arrives through host calls, which wake the next frame, and the
+    // loading animation moves every frame; everything else waits for its deadline.
+    uint64_t next_wake_us = timers_->next_deadline_us();
+    if (next_expiry_change_us_ != c_expiry_countdown::kNever) {
+        const uint64_t expiry_wake_us = clock_us() + static_cast<uint64_t>((std::max)(next_expiry_change_us_ - wall_us(), int64_t{ 0 }));
+        next_wake_us = (std::min)(next_wake_us, expiry_wake_us);
+    }
+    imgui_manager->set_next_wake_us(load_animation_active_ ? 0 : next_wake_us);
     imgui_manager->present();
 }
 
 void c_loader_ui::render_auth_mode_window() {
     if (!initialized || !imgui_manager)
         return;
+    PROFILE_SCOPE("render_auth_mode_window", "ui");
 
     static bool set_once = false;
     state.license_only_mode = false;
     if (!set_once) {
 
         if (auth_mode_callback) {
+            callback_scope callback_timer("auth_mode_callback");
             auth_mode_callback(false);
         }
 
@@ -194,33 +412,40 @@ void c_loader_ui::render_auth_mode_window() {
 }
 
 void c_loader_ui::render_login_window() {
-    ImGui::SetNextWindowPos(ImVec2((float)GetSystemMetrics(SM_CXSCREEN) / 2, (float)GetSystemMetrics(SM_CYSCREEN) / 2),
-        ImGuiCond_FirstUseEver, ImVec2(0.5f, 0.5f));
+    PROFILE_SCOPE("render_login_window", "ui");
+    ImGui::SetNextWindowPos(screen_center(), ImGuiCond_FirstUseEver, ImVec2(0.5f, 0.5f));
     ImGui::SetNextWindowSize(ImVec2(300, 400), ImGuiCond_FirstUseEver);
 
     ImGui::Begin("Bootstrapper##login window", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse);
     {
         ImGuiIO& io = ImGui::GetIO();
         auto colors = ImGui::GetStyle().Colors;
+        c_draw_cache& draw_cache = imgui_manager->get_draw_cache();
+        const uint64_t message_inputs = hash_messages(state);
 
         ImGui::BeginChild("##header", ImVec2(ImGui::GetWindowWidth() - 30, 35));
         {
-            ImGui::GetWindowDrawList()->AddRectFilledMultiColor(ImGui::GetWindowPos(), ImGui::GetWindowPos() + ImGui::GetWindowSize(),
-                ImColor(colors[ImGuiCol_ChildBg]), ImColor(colors[ImGuiCol_ChildBg]),
-                darken(ImColor(colors[ImGuiCol_ChildBg])), darken(ImColor(colors[ImGuiCol_ChildBg])));
-
-            ImGui::PushFont(imgui_manager->get_font("title"));
-            ImVec2 title_size = ImGui::CalcTextSize("Welcome Back");
-            ImGui::SetCursorPos(ImVec2(ImGui::GetWindowWidth() / 2 - title_size.x / 2, title_size.y / 8));
-            ImGui::Text("Welcome Back");
-            ImGui::SameLine(5);
-            if (ImGui::Button("X", ImVec2(25, 25))) {
-                if (exit_callback) {
-                    exit_callback();
+            if (!draw_cache.begin()) {
+                ImGui::GetWindowDrawList()->AddRectFilledMultiColor(ImGui::GetWindowPos(), ImGui::GetWindowPos() + ImGui::GetWindowSize(),
+                    ImColor(colors[ImGuiCol_ChildBg]), ImColor(colors[ImGuiCol_ChildBg]),
+                    darken(ImColor(colors[ImGuiCol_ChildBg])), darken(ImColor(colors[ImGuiCol_ChildBg])));
+
+                ImGui::PushFont(imgui_manager->get_font("title"));
+                ImVec2 title_size = ImGui::CalcTextSize("Welcome Back");
+                ImGui::SetCursorPos(ImVec2(ImGui::GetWindowWidth() / 2 - title_size.x / 2, title_size.y / 8));
+                ImGui::Text("Welcome Back");
+                ImGui::SameLine(5);
+                if (ImGui::Button("X", ImVec2(25, 25))) {
+                    if (exit_callback) {
+                        callback_scope callback_timer("exit_callback");
+                        exit_callback();
+                    }
+                    should_close = true;
                 }
-                should_close = true;
+                ImGui::PopFont();
+
+                draw_cache.end();
             }
-            ImGui::PopFont();
 
             ImGui::EndChild();
         }
@@ -228,41 +453,46 @@ void c_loader_ui::render_login_window() {
         ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 8);
         ImGui::BeginChild("##body", ImVec2(ImGui::GetWindowWidth() - 30, ImGui::GetWindowHeight() - 80));
         {
-            ImGui::PushFont(imgui_manager->get_font("smalltitle"));
-            ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25));
-            static char username_buffer[256] = "";
-            ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(ImGui::GetWindowWidth() / 8, 15));
-            ImGui::InputTextWithHint("##username", "Login", username_buffer, sizeof(username_buffer));
-
-            ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25));
-            static char password_buffer[256] = "";
-            ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 8);
-            ImGui::InputTextWithHint("##password", "Password", password_buffer, sizeof(password_buffer), ImGuiInputTextFlags_Password);
-            ImGui::PopFont();
-
-            ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(ImGui::GetWindowWidth() / 8, ImGui::GetWindowHeight() / 2.5));
-            if (ImGui::Button("Login", ImVec2(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25), 35))) {
-                if (login_callback && strlen(username_buffer) > 0 && strlen(password_buffer) > 0) {
-                    login_callback(std::string(username_buffer), std::string(password_buffer));
+            if (!draw_cache.begin(message_inputs)) {
+                ImGui::PushFont(imgui_manager->get_font("smalltitle"));
+                ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25));
+                static char username_buffer[256] = "";
+                ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(ImGui::GetWindowWidth() / 8, 15));
+                ImGui::InputTextWithHint("##username", "Login", username_buffer, sizeof(username_buffer));
+
+                ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25));
+                static char password_buffer[256] = "";
+                ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 8);
+                ImGui::InputTextWithHint("##password", "Password", password_buffer, sizeof(password_buffer), ImGuiInputTextFlags_Password);
+                ImGui::PopFont();
+
+                ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(ImGui::GetWindowWidth() / 8, ImGui::GetWindowHeight() / 2.5));
+                if (ImGui::Button("Login", ImVec2(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25), 35))) {
+                    if (login_callback && strlen(username_buffer) > 0 && strlen(password_buffer) > 0) {
+                        callback_scope callback_timer("login_callback");
+                        login_callback(std::string(username_buffer), std::string(password_buffer));
+                    }
+                }
+                ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 8);
+                if (ImGui::Button("Register", ImVec2(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25), 35))) {
+                    show_register();
                 }
-            }
-            ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 8);
-            if (ImGui::Button("Register", ImVec2(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25), 35))) {
-                show_register();
-            }
 
-            if (!state.status_message.empty()) {
-                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.7f, 0.9f, 0.7f, 1.0f));
-                ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 2 - ImGui::CalcTextSize(state.status_message.c_str()).x / 2);
-                ImGui::Text(state.status_message.c_str());
-                ImGui::PopStyleColor();
-            }
+                if (!state.status_message.empty()) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.7f, 0.9f, 0.7f, 1.0f));
+                    ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 2 - ImGui::CalcTextSize(state.status_message.c_str()).x / 2);
+                    ImGui::Text(state.status_message.c_str());
+                    ImGui::PopStyleColor();
+                }
+
+                if (!state.error_message.empty()) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f));
+                    ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 2 - ImGui::CalcTextSize(state.status_message.c_str()).x / 2);
+                    ImGui::Text("%s", state.error_message.c_str());
+                    ImGui::PopStyleColor();
+                }
 
-            if (!state.error_message.empty()) {
-                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f));
-                ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 2 - ImGui::CalcTextSize(state.status_message.c_str()).x / 2);
-                ImGui::Text("%s", state.error_message.c_str());
-                ImGui::PopStyleColor();
+                draw_cache.end();
             }
 
             ImGui::EndChild();
@@ -273,33 +503,40 @@ void c_loader_ui::render_login_window() {
 }
 
 void c_loader_ui::render_register_window() {
-    ImGui::SetNextWindowPos(ImVec2((float)GetSystemMetrics(SM_CXSCREEN) / 2, (float)GetSystemMetrics(SM_CYSCREEN) / 2),
-        ImGuiCond_FirstUseEver, ImVec2(0.5f, 0.5f));
+    PROFILE_SCOPE("render_register_window", "ui");
+    ImGui::SetNextWindowPos(screen_center(), ImGuiCond_FirstUseEver, ImVec2(0.5f, 0.5f));
     ImGui::SetNextWindowSize(ImVec2(300, 400), ImGuiCond_FirstUseEver);
 
     ImGui::Begin("Bootstrapper##register window", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse);
     {
         ImGuiIO& io = ImGui::GetIO();
         auto colors = ImGui::GetStyle().Colors;
+        c_draw_cache& draw_cache = imgui_manager->get_draw_cache();
+        const uint64_t message_inputs = hash_messages(state);
 
         ImGui::BeginChild("##header", ImVec2(ImGui::GetWindowWidth() - 30, 35));
         {
-            ImGui::GetWindowDrawList()->AddRectFilledMultiColor(ImGui::GetWindowPos(), ImGui::GetWindowPos() + ImGui::GetWindowSize(),
-                ImColor(colors[ImGuiCol_ChildBg]), ImColor(colors[ImGuiCol_ChildBg]),
-                darken(ImColor(colors[ImGuiCol_ChildBg])), darken(ImColor(colors[ImGuiCol_ChildBg])));
-
-            ImGui::PushFont(imgui_manager->get_font("title"));
-            ImVec2 title_size = ImGui::CalcTextSize("Join Us Today");
-            ImGui::SetCursorPos(ImVec2(ImGui::GetWindowWidth() / 2 - title_size.x / 2, title_size.y / 8));
-            ImGui::Text("Join Us Today");
-            ImGui::SameLine(5);
-            if (ImGui::Button("X", ImVec2(25, 25))) {
-                if (exit_callback) {
-                    exit_callback();
+            if (!draw_cache.begin()) {
+                ImGui::GetWindowDrawList()->AddRectFilledMultiColor(ImGui::GetWindowPos(), ImGui::GetWindowPos() + ImGui::GetWindowSize(),
+                    ImColor(colors[ImGuiCol_ChildBg]), ImColor(colors[ImGuiCol_ChildBg]),
+                    darken(ImColor(colors[ImGuiCol_ChildBg])), darken(ImColor(colors[ImGuiCol_ChildBg])));
+
+                ImGui::PushFont(imgui_manager->get_font("title"));
+                ImVec2 title_size = ImGui::CalcTextSize("Join Us Today");
+                ImGui::SetCursorPos(ImVec2(ImGui::GetWindowWidth() / 2 - title_size.x / 2, title_size.y / 8));
+                ImGui::Text("Join Us Today");
+                ImGui::SameLine(5);
+                if (ImGui::Button("X", ImVec2(25, 25))) {
+                    if (exit_callback) {
+                        callback_scope callback_timer("exit_callback");
+                        exit_callback();
+                    }
+                    should_close = true;
                 }
-                should_close = true;
+                ImGui::PopFont();
+
+                draw_cache.end();
             }
-            ImGui::PopFont();
 
             ImGui::EndChild();
         }
@@ -307,49 +544,54 @@ void c_loader_ui::render_register_window() {
         ImGui::SetCursorPosY(ImGui::GetCursorPosY() + 8);
         ImGui::BeginChild("##body", ImVec2(ImGui::GetWindowWidth() - 30, ImGui::GetWindowHeight() - 80));
         {
-            ImGui::PushFont(imgui_manager->get_font("smalltitle"));
-            ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25));
-            static char username_buffer[256] = "";
-            ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(ImGui::GetWindowWidth() / 8, 15));
-            ImGui::InputTextWithHint("##username", "Login", username_buffer, sizeof(username_buffer));
-
-            ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25));
-            static char password_buffer[256] = "";
-            ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 8);
-            ImGui::InputTextWithHint("##password", "Password", password_buffer, sizeof(password_buffer), ImGuiInputTextFlags_Password);
-
-            ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25));
-            static char license_buffer[256] = "";
-            ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 8);
-            ImGui::InputTextWithHint("##license", "License", license_buffer, sizeof(license_buffer));
-            ImGui::PopFont();
-
-            ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(ImGui::GetWindowWidth() / 8, ImGui::GetWindowHeight() / 3.5));
-            if (ImGui::Button("Create Account", ImVec2(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25), 35))) {
-                if (register_callback && strlen(username_buffer) > 0 &&
-                    strlen(password_buffer) > 0 && strlen(license_buffer) > 0) {
-                    register_callback(std::string(username_buffer),
-                        std::string(password_buffer),
-                        std::string(license_buffer));
+            if (!draw_cache.begin(message_inputs)) {
+                ImGui::PushFont(imgui_manager->get_font("smalltitle"));
+                ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25));
+                static char username_buffer[256] = "";
+                ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(ImGui::GetWindowWidth() / 8, 15));
+                ImGui::InputTextWithHint("##username", "Login", username_buffer, sizeof(username_buffer));
+
+                ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25));
+                static char password_buffer[256] = "";
+                ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 8);
+                ImGui::InputTextWithHint("##password", "Password", password_buffer, sizeof(password_buffer), ImGuiInputTextFlags_Password);
+
+                ImGui::SetNextItemWidth(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25));
+                static char license_buffer[256] = "";
+                ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 8);
+                ImGui::InputTextWithHint("##license", "License", license_buffer, sizeof(license_buffer));
+                ImGui::PopFont();
+
+                ImGui::SetCursorPos(ImGui::GetCursorPos() + ImVec2(ImGui::GetWindowWidth() / 8, ImGui::GetWindowHeight() / 3.5));
+                if (ImGui::Button("Create Account", ImVec2(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25), 35))) {
+                    if (register_callback && strlen(username_buffer) > 0 &&
+                        strlen(password_buffer) > 0 && strlen(license_buffer) > 0) {
+                        callback_scope callback_timer("register_callback");
+                        register_callback(std::string(username_buffer),
+                            std::string(password_buffer),
+                            std::string(license_buffer));
+                    }
+                }
+                ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 8);
+                if (ImGui::Button("Back To Login", ImVec2(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25), 35))) {
+                    show_login();
                 }
-            }
-            ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 8);
-            if (ImGui::Button("Back To Login", ImVec2(ImGui::GetWindowWidth() - (ImGui::GetWindowWidth() * 0.25), 35))) {
-                show_login();
-            }
 
-            if (!state.status_message.empty()) {
-                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.7f, 0.9f, 0.7f, 1.0f));
-                ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 2 - ImGui::CalcTextSize(state.status_message.c_str()).x / 2);
-                ImGui::Text(state.status_message.c_str());
-                ImGui::PopStyleColor();
-            }
+                if (!state.status_message.empty()) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.7f, 0.9f, 0.7f, 1.0f));
+                    ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 2 - ImGui::CalcTextSize(state.status_message.c_str()).x / 2);
+                    ImGui::Text(state.status_message.c_str());
+                    ImGui::PopStyleColor();
+                }
 
-            if (!state.error_message.empty()) {
-                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f));
-                ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 2 - ImGui::CalcTextSize(state.status_message.c_str()).x / 2);
-                ImGui::Text("%s", state.error_message.c_str());
-                ImGui::PopStyleColor();
+                if (!state.error_message.empty()) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f));
+                    ImGui::SetCursorPosX(ImGui::GetWindowWidth() / 2 - ImGui::CalcTextSize(state.status_message.c_str()).x / 2);
+                    ImGui::Text("%s", state.error_message.c_str());
+                    ImGui::PopStyleColor();
+                }
+
+                draw_cache.end();
             }
 
             ImGui::EndChild();
@@ -359,12 +601,17 @@ void c_loader_ui::render_register_window() {
     }
 }
 
+enum product_column : ImGuiID {
+    product_column_plan,
+    product_column_status,
+    product_column_expires,
+    product_column_frozen,
+};
+
 void c_loader_ui::render_main_window() {
-    static int selected_subscription = -1;
+    PROFILE_SCOPE("render_main_window", "ui");
     ImGui::SetNextWindowSize(ImVec2(600, 400), ImGuiCond_Always);
-    ImGui::SetNextWindowPos(
-        ImVec2(GetSystemMetrics(SM_CXSCREEN) * 0.5f, GetSystemMetrics(SM_CYSCREEN) * 0.5f),
-        ImGuiCond_Always, ImVec2(0.5f, 0.5f));
+    ImGui::SetNextWindowPos(screen_center(), ImGuiCond_Always, ImVec2(0.5f, 0.5f));
 
     static bool window_open = true;
     if (!ImGui::Begin(config.application_name, &window_open, ImGuiWindowFlags_NoResize)) {
@@ -373,36 +620,90 @@ void c_loader_ui::render_main_window() {
     }
 
     if (!window_open) {
-        if (exit_callback) exit_callback();
+        if (exit_callback) {
+            callback_scope callback_timer("exit_callback");
+            exit_callback();
+        }
         close();
         ImGui::End();
         return;
     }
 
-    const auto now = std::chrono::steady_clock::now();
-    if (download_start_enqueued_ && now >= download_delay_until_)
-        trigger_pending_download();
-
     ImGui::TextUnformatted("Products");
+    if (products_stale_) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(refreshing...)");
+    }
     ImGui::Separator();
 
-    std::vector<user_subscription*> subs_snapshot;
-    for (auto* s : user.subscriptions)
-        if (s) subs_snapshot.push_back(s);
-
-    if (ImGui::BeginChild("product_list", ImVec2(-1.f, 200.f), true)) {
-        if (subs_snapshot.empty()) {
-            ImGui::TextDisabled("No subscriptions available.");
+    // The profile is public; pick up hosts that edit its subscriptions in place.
+    if (subscriptions_->source_count() != user.subscriptions.size())
+        rebuild_product_rows();
+
+    ImGui::SetNextItemWidth(-1.f);
+    ImGui::InputTextWithHint("##product_filter", "Search products", product_filter_, IM_ARRAYSIZE(product_filter_));
+
+    constexpr ImGuiTableFlags table_flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_SortMulti |
+        ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_Resizable;
+    // Distinct statuses are few and their sizes cached, so this stays cheap with many rows.
+    float status_width = ImGui::CalcTextSize("Status").x;
+    for (c_string_table::string_id status : subscriptions_->status_values())
+        status_width = (std::max)(status_width, subscriptions_->strings().text_size(status).x);
+
+    if (ImGui::BeginTable("product_list", 4, table_flags, ImVec2(-1.f, 176.f))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Plan", ImGuiTableColumnFlags_DefaultSort | ImGuiTableColumnFlags_WidthStretch, 0.f, product_column_plan);
+        ImGui::TableSetupColumn("Status", ImGuiTableColumnFlags_WidthFixed, status_width, product_column_status);
+        ImGui::TableSetupColumn("Expires", ImGuiTableColumnFlags_WidthFixed, 120.f, product_column_expires);
+        ImGui::TableSetupColumn("Frozen", ImGuiTableColumnFlags_WidthFixed, 50.f, product_column_frozen);
+        // The init width only applies when the column is created; refit when statuses change.
+        if (status_column_width_ > 0.f && status_column_width_ != status_width)
+            ImGui::TableSetColumnWidth(1, status_width);
+        status_column_width_ = status_width;
+        ImGui::TableHeadersRow();
+
+        if (ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs()) {
+            if (specs->SpecsDirty || product_sort_dirty_) {
+                sort_product_rows(specs);
+                specs->SpecsDirty = false;
+            }
         }
-        else {
-            for (int i = 0; i < subs_snapshot.size(); ++i) {
-                bool is_selected = (selected_subscription == i);
-                if (ImGui::Selectable(subs_snapshot[i]->plan.c_str(), is_selected))
-                    selected_subscription = i;
+        filter_product_rows();
+
+        const int64_t wall_now_us = wall_us();
+        c_subscription_store& store = *subscriptions_;
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(visible_rows_.size()));
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                const int entry = visible_rows_[row];
+                const int i = store.source_index(entry);
+                // The host may null an entry in place; skip it as assign() would.
+                if (!user.subscriptions[i])
+                    continue;
+                ImGui::PushID(i);
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                if (ImGui::Selectable(store.text(store.plan(entry)).c_str(), selected_product_row_ == entry, ImGuiSelectableFlags_SpanAllColumns))
+                    selected_product_row_ = entry;
+                ImGui::TableSetColumnIndex(1);
+                const std::string& status = store.text(store.status(entry));
+                ImGui::TextUnformatted(status.data(), status.data() + status.size());
+                ImGui::TableSetColumnIndex(2);
+                c_expiry_countdown& countdown = store.countdown(entry);
+                ImGui::TextDisabled("%s", countdown.text(wall_now_us));
+                next_expiry_change_us_ = (std::min)(next_expiry_change_us_, countdown.next_change_us(wall_now_us));
+                ImGui::TableSetColumnIndex(3);
+                ImGui::TextUnformatted(store.flags(entry) & c_subscription_store::flag_frozen ? "Yes" : "No");
+                ImGui::PopID();
             }
         }
+        ImGui::EndTable();
     }
-    ImGui::EndChild();
+    if (subscriptions_->empty())
+        ImGui::TextDisabled("No subscriptions available.");
+    else if (visible_rows_.empty())
+        ImGui::TextDisabled("No products match the search.");
 
     ImGui::Separator();
 
@@ -428,12 +729,19 @@ void c_loader_ui::render_main_window() {
     ImGui::Separator();
 
     user_subscription* selected_sub = nullptr;
-    if (selected_subscription >= 0 && selected_subscription < static_cast<int>(subs_snapshot.size()))
-        selected_sub = subs_snapshot[selected_subscription];
+    if (selected_product_row_ >= 0 && selected_product_row_ < static_cast<int>(subscriptions_->size()))
+        selected_sub = user.subscriptions[subscriptions_->source_index(selected_product_row_)];
 
-    bool disable_load = load_animation_active_ || download_active_ || download_start_enqueued_;
+    // The original launch runs one product at a time.
+    bool disable_load = products_stale_ ||
+        (!config.queue_launches && (load_animation_active_ || download_start_enqueued_ || !downloads_->empty()));
     if (disable_load) ImGui::BeginDisabled();
 
+    if (config.queue_launches) {
+        ImGui::SetNextItemWidth(90.f);
+        ImGui::Combo("##load_priority", &load_priority_, "High\0Normal\0Low\0");
+        ImGui::SameLine();
+    }
     if (ImGui::Button("Load", ImVec2(-1.f, 0.f))) {
         if (!selected_sub) {
             state.error_message = "Select a product to load.";
@@ -443,42 +751,47 @@ void c_loader_ui::render_main_window() {
             state.error_message = "No loader file is configured for this product.";
             state.status_message.clear();
         }
-        else {
+        else if (!config.queue_launches) {
             load_animation_active_ = true;
-            load_animation_start_ = now;
+            load_animation_start_us_ = clock_us();
             load_animation_product_ = selected_sub->plan;
             load_completion_popup_pending_ = false;
             load_completion_message_.clear();
-            load_animation_stop_requested_ = false;
-            state.error_message.clear();
             pending_file_id_ = selected_sub->default_file_id;
             pending_product_name_ = selected_sub->plan;
             download_start_enqueued_ = false;
-            download_delay_until_ = {};
-            download_active_ = false;
-            download_progress_ = 0.f;
-            state.status_message = "Loading (" + load_animation_product_ + ")";
+            state.error_message.clear();
+            state.status_message.assign("Loading (").append(load_animation_product_).append(")");
             license_success_active_ = false;
             license_success_message_.clear();
+            timers_->cancel(license_banner_timer_);
+            timers_->reschedule(load_animation_timer_,
+                clock_us() + static_cast<uint64_t>(kLoadAnimationDuration * 1e6f), [this] {
+                    load_animation_active_ = false;
+                    load_completion_popup_pending_ = true;
+                    load_completion_message_ = "Launch complete.";
+                });
+        }
+        else if (!downloads_->enqueue(selected_sub->default_file_id, selected_sub->plan, 1 - load_priority_)) {
+            state.error_message = "This product is already queued.";
+            state.status_message.clear();
+        }
+        else {
+            state.error_message.clear();
+            state.status_message.assign("Queued ").append(selected_sub->plan);
+            license_success_active_ = false;
+            license_success_message_.clear();
+            timers_->cancel(license_banner_timer_);
         }
     }
     if (disable_load) ImGui::EndDisabled();
 
     if (load_animation_active_) {
-        float elapsed = std::chrono::duration<float>(now - load_animation_start_).count();
-        float progress = ImClamp(elapsed / kLoadAnimationDuration, 0.0f, 1.0f);
-        if (elapsed >= kLoadAnimationDuration) {
-            load_animation_active_ = false;
-            load_completion_popup_pending_ = true;
-            load_completion_message_ = "Launch complete.";
-        }
+        const float elapsed = static_cast<float>(clock_us() - load_animation_start_us_) / 1e6f;
         ImGui::Text("Loading %s...", load_animation_product_.c_str());
-        ImGui::ProgressBar(progress, ImVec2(-1.f, 0.f));
-    }
-    else if (download_active_) {
-        ImGui::Text("Downloading %s...", pending_product_name_.c_str());
-        ImGui::ProgressBar(ImClamp(download_progress_, 0.f, 1.f), ImVec2(-1.f, 0.f));
+        ImGui::ProgressBar(ImClamp(elapsed / kLoadAnimationDuration, 0.0f, 1.0f), ImVec2(-1.f, 0.f));
     }
+    render_downloads();
 
     if (load_completion_popup_pending_) {
         ImGui::OpenPopup("popup");
@@ -490,11 +803,9 @@ void c_loader_ui::render_main_window() {
         if (ImGui::Button("OK", ImVec2(120.f, 0.f))) {
             ImGui::CloseCurrentPopup();
             if (!pending_file_id_.empty()) {
-                download_delay_until_ = now + std::chrono::seconds(5);
                 download_start_enqueued_ = true;
-                download_progress_ = 0.f;
-                download_active_ = false;
-                state.status_message = "Preparing download for " + pending_product_name_;
+                timers_->reschedule(download_timer_, clock_us() + kDownloadDelayUs, [this] { trigger_pending_download(); });
+                state.status_message.assign("Preparing download for ").append(pending_product_name_);
             }
         }
         ImGui::EndPopup();
@@ -576,11 +887,126 @@ void c_loader_ui::apply_base_theme() {
 
 
 void c_loader_ui::set_authenticated(bool auth, user_profile* new_profile) {
+    record_call(log_record_type::authenticated, [&](c_log_writer& out) {
+        out.put_bool(auth);
+        out.put_bool(new_profile != nullptr);
+        if (new_profile)
+            encode_profile(out, *new_profile);
+    });
+    apply_authenticated(auth, new_profile);
+}
+
+static std::string view_to_string(const ui_string_view& view) {
+    return view.data ? std::string(view.data, view.length) : std::string();
+}
+
+// The ref queues the host's release once its last copy is gone, even if data is null; the
+// last copy may go on the host's thread, so the release itself waits for the UI thread.
+static c_subscription_store::media_ref borrow_media(const ui_media_buffer& buffer, const std::shared_ptr<media_release_queue>& releases) {
+    c_subscription_store::media_ref ref;
+    ref.data = buffer.data;
+    ref.size = buffer.data ? buffer.size : 0;
+    ref.owner = std::shared_ptr<void>(const_cast<unsigned char*>(buffer.data),
+        [queue = releases, release = buffer.release, user = buffer.user](void*) {
+            if (!release)
+                return;
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            queue->pending.emplace_back(release, user);
+        });
+    return ref;
+}
+
+void c_loader_ui::run_media_releases() {
+    std::vector<std::pair<void (*)(void*), void*>> batch;
+    {
+        std::lock_guard<std::mutex> lock(media_releases_->mutex);
+        batch.swap(media_releases_->pending);
+    }
+    for (const auto& [release, user] : batch)
+        release(user);
+}
+
+bool c_loader_ui::set_authenticated(bool auth, const ui_profile_desc& profile) {
+    ui_profile_desc desc{};
+    memcpy(&desc, &profile, (std::min)(static_cast<size_t>(profile.struct_size), sizeof(desc)));
+    if (profile.struct_size < sizeof(uint32_t) || (desc.subscription_count && (!desc.subscriptions || !desc.subscription_stride)))
+        return false;
+
+    user_profile converted;
+    converted.username = view_to_string(desc.username);
+    converted.email = view_to_string(desc.email);
+    converted.ip = view_to_string(desc.ip);
+
+    // Only the small fields are copied; the media refs own the host's buffers from here on,
+    // so every path below releases them exactly once.
+    std::vector<std::unique_ptr<user_subscription>> storage;
+    std::vector<c_subscription_store::media_ref> images;
+    std::vector<c_subscription_store::media_ref> videos;
+    storage.reserve(desc.subscription_count);
+    images.reserve(desc.subscription_count);
+    videos.reserve(desc.subscription_count);
+    const unsigned char* record = reinterpret_cast<const unsigned char*>(desc.subscriptions);
+    for (size_t i = 0; i < desc.subscription_count; i++, record += desc.subscription_stride) {
+        ui_subscription_desc entry{};
+        memcpy(&entry, record, (std::min)(desc.subscription_stride, sizeof(entry)));
+
+        auto sub = std::make_unique<user_subscription>();
+        sub->plan = view_to_string(entry.plan);
+        sub->expires_at = view_to_string(entry.expires_at);
+        sub->status = view_to_string(entry.status);
+        sub->frozen = entry.frozen != 0;
+        sub->plan_id = view_to_string(entry.plan_id);
+        sub->default_file_id = view_to_string(entry.default_file_id);
+        sub->product_image_mime = view_to_string(entry.image_mime);
+        sub->product_image_updated_at = view_to_string(entry.image_updated_at);
+        sub->product_video_mime = view_to_string(entry.video_mime);
+        sub->product_video_updated_at = view_to_string(entry.video_updated_at);
+        sub->product_video_path = view_to_string(entry.video_path);
+        images.push_back(borrow_media(entry.image, media_releases_));
+        videos.push_back(borrow_media(entry.video, media_releases_));
+        converted.subscriptions.push_back(sub.get());
+        storage.push_back(std::move(sub));
+    }
+
+    record_call(log_record_type::authenticated, [&](c_log_writer& out) {
+        out.put_bool(auth);
+        out.put_bool(true);
+        out.put_string(converted.username);
+        out.put_string(converted.email);
+        out.put_string(converted.ip);
+        out.put_varint(storage.size());
+        for (size_t i = 0; i < storage.size(); i++) {
+            out.put_bool(true);
+            encode_subscription(out, *storage[i], images[i].data, images[i].size);
+        }
+    });
+    apply_authenticated(auth, &converted);
+
+    if (state.authenticated) {
+        // Rows map 1:1 to the converted list, which has no null entries.
+        for (size_t row = 0; row < storage.size(); row++) {
+            if (images[row].data)
+                subscriptions_->set_image(row, std::move(images[row]));
+            if (videos[row].data)
+                subscriptions_->set_video(row, std::move(videos[row]));
+        }
+        for (std::unique_ptr<user_subscription>& sub : storage)
+            owned_subscriptions_.push_back(std::move(sub));
+    }
+    return true;
+}
+
+void c_loader_ui::apply_authenticated(bool auth, user_profile* new_profile) {
     state.authenticated = auth;
 
     if (new_profile != nullptr) {
+        const bool reconciled = products_stale_ && auth && reconcile_stale_rows(*new_profile);
         user = *new_profile;
+        if (!reconciled)
+            rebuild_product_rows();
+        owned_subscriptions_.clear();
     }
+    products_stale_ = false;
 
     if (state.authenticated) {
         products_dirty = true;
@@ -590,6 +1016,13 @@ void c_loader_ui::set_authenticated(bool auth, user_profile* new_profile) {
         release_product_views();
         products_dirty = false;
         user.subscriptions.clear();
+        subscriptions_->clear();
+        selected_product_row_ = -1;
+        owned_subscriptions_.clear();
+        product_sort_dirty_ = true;
+        // The next user must not see this one's products; a replay's sign-out is not real.
+        if (!replay_clock_)
+            remove_profile_snapshot();
         if (state.license_only_mode) {
             state.show_login_window = false;
             state.show_register_window = false;
@@ -599,65 +1032,387 @@ void c_loader_ui::set_authenticated(bool auth, user_profile* new_profile) {
             show_login();
         }
     }
+    wake();
+}
+
+void c_loader_ui::load_profile_snapshot() {
+    if (!config.profile_snapshot_path || state.authenticated)
+        return;
+
+    c_profile_snapshot snapshot;
+    if (!snapshot.open(std::filesystem::u8path(config.profile_snapshot_path)) || snapshot.size() == 0)
+        return;
+
+    PROFILE_SCOPE("load_profile_snapshot", "ui");
+    user = user_profile{};
+    user.username = snapshot.username();
+    owned_subscriptions_.clear();
+    for (size_t i = 0; i < snapshot.size(); i++) {
+        owned_subscriptions_.push_back(std::make_unique<user_subscription>());
+        snapshot.read(i, *owned_subscriptions_.back());
+        user.subscriptions.push_back(owned_subscriptions_.back().get());
+    }
+    rebuild_product_rows();
+    products_stale_ = true;
+    show_main();
+}
+
+void c_loader_ui::save_profile_snapshot() const {
+    if (config.profile_snapshot_path)
+        c_profile_snapshot::write(std::filesystem::u8path(config.profile_snapshot_path), user);
+}
+
+void c_loader_ui::remove_profile_snapshot() const {
+    if (!config.profile_snapshot_path)
+        return;
+    std::error_code error;
+    std::filesystem::remove(std::filesystem::u8path(config.profile_snapshot_path), error);
+}
+
+// Keeps the stale rows, their order and countdowns when the fresh profile lists the same
+// plan ids in the same order, which is the common case; only rows whose fields changed are
+// re-read. Anything else falls back to a full rebuild.
+bool c_loader_ui::reconcile_stale_rows(const user_profile& fresh) {
+    c_subscription_store& store = *subscriptions_;
+    if (store.source_count() != fresh.subscriptions.size())
+        return false;
+    size_t row = 0;
+    for (size_t i = 0; i < fresh.subscriptions.size(); i++) {
+        const user_subscription* sub = fresh.subscriptions[i];
+        if (!sub)
+            continue;
+        if (row >= store.size() || store.source_index(row) != static_cast<int>(i) || store.plan_id(row) != sub->plan_id)
+            return false;
+        row++;
+    }
+    if (row != store.size())
+        return false;
+
+    bool changed_any = false;
+    for (row = 0; row < store.size(); row++) {
+        const user_subscription& stale = *store.source(row);
+        user_subscription* sub = fresh.subscriptions[store.source_index(row)];
+        const bool changed = stale.plan != sub->plan || stale.status != sub->status ||
+            stale.expires_at != sub->expires_at || stale.frozen != sub->frozen ||
+            stale.default_file_id != sub->default_file_id ||
+            stale.product_image_mime != sub->product_image_mime ||
+            stale.product_image_updated_at != sub->product_image_updated_at ||
+            stale.product_video_mime != sub->product_video_mime ||
+            stale.product_video_updated_at != sub->product_video_updated_at ||
+            stale.product_video_path != sub->product_video_path;
+        store.set_source(row, sub);
+        // Media bytes never come from the snapshot, so rows that have some are re-read too.
+        if (changed || !sub->product_image.empty() || !sub->product_video.empty()) {
+            store.update(row);
+            changed_any |= changed;
+        }
+    }
+    if (changed_any)
+        product_sort_dirty_ = true;
+    return true;
+}
+
+void c_loader_ui::rebuild_product_rows() {
+    // The selection follows its plan id; assign() also starts a fresh string table.
+    std::string selected_plan_id;
+    if (selected_product_row_ >= 0 && selected_product_row_ < static_cast<int>(subscriptions_->size()))
+        selected_plan_id = subscriptions_->plan_id(selected_product_row_);
+    subscriptions_->assign(user.subscriptions);
+    selected_product_row_ = selected_plan_id.empty() ? -1 : subscriptions_->find_plan_id(selected_plan_id);
+    product_sort_dirty_ = true;
+}
+
+void c_loader_ui::sort_product_rows(const ImGuiTableSortSpecs* specs) {
+    PROFILE_SCOPE("sort_product_rows", "ui");
+    const c_subscription_store& store = *subscriptions_;
+    sorted_rows_.resize(store.size());
+    for (size_t i = 0; i < sorted_rows_.size(); i++)
+        sorted_rows_[i] = static_cast<int>(i);
+
+    auto key = [&](int row, ImGuiID column) -> int64_t {
+        switch (column) {
+        case product_column_plan: return store.strings().rank(store.plan(row));
+        case product_column_status: return store.strings().rank(store.status(row));
+        case product_column_expires: return store.expires_us(row);
+        case product_column_frozen: return store.flags(row) & c_subscription_store::flag_frozen;
+        default: return 0;
+        }
+    };
+    std::sort(sorted_rows_.begin(), sorted_rows_.end(), [&](int a, int b) {
+        for (int n = 0; n < specs->SpecsCount; n++) {
+            const ImGuiTableColumnSortSpecs& spec = specs->Specs[n];
+            const int64_t lhs = key(a, spec.ColumnUserID);
+            const int64_t rhs = key(b, spec.ColumnUserID);
+            if (lhs != rhs)
+                return spec.SortDirection == ImGuiSortDirection_Descending ? lhs > rhs : lhs < rhs;
+        }
+        return a < b;
+    });
+
+    product_sort_dirty_ = false;
+    product_filter_dirty_ = true;
+}
+
+// Case-insensitive match of the search box against an already lowercase query.
+static bool equals_lowercase(std::string_view text, std::string_view lower) {
+    if (text.size() != lower.size())
+        return false;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (tolower(static_cast<unsigned char>(text[i])) != static_cast<unsigned char>(lower[i]))
+            return false;
+    }
+    return true;
+}
+
+void c_loader_ui::filter_product_rows() {
+    // Runs every frame; nothing is built until the query changes.
+    const std::string_view query(product_filter_);
+    if (!product_filter_dirty_ && equals_lowercase(query, applied_filter_))
+        return;
+
+    // Typing another character only narrows the current matches; anything else (a new
+    // sort, new data, deleting) filters the sorted rows again.
+    const bool narrowing = !product_filter_dirty_ && query.size() >= applied_filter_.size() &&
+        equals_lowercase(query.substr(0, applied_filter_.size()), applied_filter_);
+    if (!narrowing)
+        visible_rows_ = sorted_rows_;
+
+    applied_filter_.assign(query);
+    for (char& c : applied_filter_)
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    if (!applied_filter_.empty())
+        subscriptions_->filter(applied_filter_, visible_rows_);
+    product_filter_dirty_ = false;
 }
 
 
 void c_loader_ui::set_status_message(const std::string& message) {
+    record_call(log_record_type::status_message, [&](c_log_writer& out) { out.put_string(message); });
     state.status_message = message;
     state.error_message.clear();
 
     if (license_redeem_pending_ && !message.empty()) {
         license_success_active_ = true;
         license_success_message_ = message;
-        license_success_start_ = std::chrono::steady_clock::now();
         license_redeem_pending_ = false;
+        timers_->reschedule(license_banner_timer_,
+            clock_us() + static_cast<uint64_t>(kLicenseBannerDuration * 1e6f), [this] {
+                license_success_active_ = false;
+                license_success_message_.clear();
+            });
     }
 
     if (message.empty()) {
         license_success_active_ = false;
         license_success_message_.clear();
+        timers_->cancel(license_banner_timer_);
     }
+    wake();
 }
 
 void c_loader_ui::set_error_message(const std::string& message) {
+    record_call(log_record_type::error_message, [&](c_log_writer& out) { out.put_string(message); });
     state.error_message = message;
     state.status_message.clear();
     license_redeem_pending_ = false;
     license_success_active_ = false;
     license_success_message_.clear();
-    load_animation_active_ = false;
-    load_animation_stop_requested_ = false;
     load_completion_popup_pending_ = false;
     load_completion_message_.clear();
-    load_animation_product_.clear();
-    pending_file_id_.clear();
-    pending_product_name_.clear();
-    download_start_enqueued_ = false;
-    download_active_ = false;
-    download_progress_ = 0.f;
+    cancel_pending_launch();
+    error_messages_++;
+    timers_->cancel(license_banner_timer_);
+    wake();
 }
 
 void c_loader_ui::set_loading(bool active) {
-    if (active) {
-        download_active_ = true;
-        download_progress_ = 0.f;
-        if (!pending_product_name_.empty()) {
-            state.status_message = "Downloading " + pending_product_name_;
+    download_event event;
+    event.type = download_event::kind::loading;
+    event.flag = active;
+    queue_download_event(std::move(event));
+}
+
+void c_loader_ui::wake() {
+    if (imgui_manager)
+        imgui_manager->wake();
+}
+
+void c_loader_ui::set_loading_progress(float progress) {
+    download_event event;
+    event.type = download_event::kind::fraction;
+    event.fraction = progress;
+    queue_download_event(std::move(event));
+}
+
+void c_loader_ui::set_download_progress(const std::string& file_id, uint64_t done_bytes, uint64_t total_bytes) {
+    download_event event;
+    event.type = download_event::kind::progress;
+    event.file_id = file_id;
+    event.done_bytes = done_bytes;
+    event.total_bytes = total_bytes;
+    queue_download_event(std::move(event));
+}
+
+void c_loader_ui::finish_download(const std::string& file_id, bool ok) {
+    download_event event;
+    event.type = download_event::kind::finished;
+    event.file_id = file_id;
+    event.flag = ok;
+    queue_download_event(std::move(event));
+}
+
+void c_loader_ui::queue_download_event(download_event&& event) {
+    {
+        std::lock_guard<std::mutex> lock(download_events_->mutex);
+        download_events_->pending.push_back(std::move(event));
+    }
+    wake();
+}
+
+// Logged here rather than by the setters, which may run on any thread.
+void c_loader_ui::apply_download_events() {
+    std::vector<download_event> batch;
+    {
+        std::lock_guard<std::mutex> lock(download_events_->mutex);
+        batch.swap(download_events_->pending);
+    }
+
+    for (const download_event& event : batch) {
+        switch (event.type) {
+        case download_event::kind::loading: {
+            record_call(log_record_type::loading, [&](c_log_writer& out) { out.put_bool(event.flag); });
+            const download_item* item = downloads_->oldest_running();
+            if (event.flag)
+                state.status_message = item ? "Downloading " + item->name : "Downloading...";
+            else if (item)
+                downloads_->finish(item->file_id, true);
+            break;
         }
-        else {
-            state.status_message = "Downloading...";
+        case download_event::kind::fraction:
+            record_call(log_record_type::loading_progress, [&](c_log_writer& out) { out.put_f32(event.fraction); });
+            if (const download_item* item = downloads_->oldest_running())
+                downloads_->report_fraction(item->file_id, event.fraction);
+            break;
+        case download_event::kind::progress:
+            record_call(log_record_type::download_progress, [&](c_log_writer& out) {
+                out.put_string(event.file_id);
+                out.put_varint(event.done_bytes);
+                out.put_varint(event.total_bytes);
+            });
+            downloads_->report(event.file_id, event.done_bytes, event.total_bytes);
+            break;
+        case download_event::kind::finished:
+            record_call(log_record_type::download_finished, [&](c_log_writer& out) {
+                out.put_string(event.file_id);
+                out.put_bool(event.flag);
+            });
+            downloads_->finish(event.file_id, event.flag);
+            break;
+        case download_event::kind::chunk:
+            record_call(log_record_type::filestream_chunk, [&](c_log_writer& out) {
+                out.put_string(event.file_id);
+                out.put_varint(event.offset);
+                out.put_varint(event.length);
+                out.put_varint(event.total_bytes);
+            });
+            if (const c_chunk_checkpoint* checkpoint = filestream_transport_->on_chunk(event.file_id, event.offset, event.length, event.total_bytes))
+                downloads_->report(event.file_id, checkpoint->done_bytes(), checkpoint->file_bytes());
+            // The host finished the request but pieces never arrived; ask again for what is missing.
+            if (filestream_transport_->drained(event.file_id))
+                retry_file_ranges(event.file_id);
+            break;
+        case download_event::kind::failed:
+            record_call(log_record_type::filestream_failed, [&](c_log_writer& out) { out.put_string(event.file_id); });
+            retry_file_ranges(event.file_id);
+            break;
         }
     }
-    else {
-        download_active_ = false;
-        download_progress_ = 0.f;
-        download_start_enqueued_ = false;
-        pending_product_name_.clear();
+}
+
+void c_loader_ui::filestream_chunk(const std::string& file_id, uint64_t offset, uint64_t length, uint64_t total_bytes) {
+    download_event event;
+    event.type = download_event::kind::chunk;
+    event.file_id = file_id;
+    event.offset = offset;
+    event.length = length;
+    event.total_bytes = total_bytes;
+    queue_download_event(std::move(event));
+}
+
+void c_loader_ui::filestream_failed(const std::string& file_id) {
+    download_event event;
+    event.type = download_event::kind::failed;
+    event.file_id = file_id;
+    queue_download_event(std::move(event));
+}
+
+void c_loader_ui::retry_file_ranges(const std::string& file_id) {
+    const int failures = filestream_transport_->on_failure(file_id);
+    if (!failures)
+        return;
+    if (failures > c_filestream_transport::kMaxRetries) {
+        // The checkpoint stays, so loading the product again resumes.
+        downloads_->finish(file_id, false);
+        return;
     }
+    timers_->schedule_at(clock_us() + (250'000ull << (failures - 1)), [this, file_id] { filestream_transport_->resume(file_id); });
 }
 
-void c_loader_ui::set_loading_progress(float progress) {
-    download_progress_ = ImClamp(progress, 0.0f, 1.0f);
+void c_loader_ui::request_file_ranges(const std::string& file_id, const std::vector<byte_range>& ranges) {
+    if (!filestream_range_callback)
+        return;
+    std::vector<filestream_range> host_ranges(ranges.size());
+    for (size_t i = 0; i < ranges.size(); i++)
+        host_ranges[i] = filestream_range{ ranges[i].offset, ranges[i].length };
+    callback_scope callback_timer("filestream_callback");
+    filestream_range_callback(file_id, host_ranges.data(), host_ranges.size());
+}
+
+void c_loader_ui::on_download_finished(const download_item& item) {
+    if (item.state == download_state::failed) {
+        // Keep the host's own explanation if it gave one.
+        if (state.error_message.empty())
+            state.error_message.assign("Download failed: ").append(item.name);
+        return;
+    }
+    // The original launch raised its popup before the download started.
+    if (!config.queue_launches)
+        return;
+    load_completion_message_.assign(item.name).append(" is ready.");
+    load_completion_popup_pending_ = true;
+    if (downloads_->items().size() == 1)
+        state.status_message.clear();
+}
+
+void c_loader_ui::render_downloads() {
+    const std::vector<download_item>& items = downloads_->items();
+    if (items.empty())
+        return;
+
+    static const char* const priority_names[] = { "high", "normal", "low" };
+    uint64_t cancelled = 0;
+    for (const download_item& item : items) {
+        ImGui::PushID(static_cast<int>(item.id));
+        if (item.state == download_state::queued) {
+            // Only queued items: running sessions belong to the host, which cannot abort them.
+            if (ImGui::SmallButton("Cancel"))
+                cancelled = item.id;
+            ImGui::SameLine();
+            ImGui::TextDisabled("%s (queued, %s)", item.name.c_str(), priority_names[ImClamp(1 - item.priority, 0, 2)]);
+        }
+        else {
+            char overlay[64] = "";
+            if (item.total_bytes) {
+                snprintf(overlay, sizeof(overlay), "%.1f / %.1f MB",
+                    static_cast<double>(item.done_bytes) / 1048576.0, static_cast<double>(item.total_bytes) / 1048576.0);
+            }
+            ImGui::Text("Downloading %s...", item.name.c_str());
+            ImGui::ProgressBar(item.progress(), ImVec2(-1.f, 0.f), overlay[0] ? overlay : nullptr);
+        }
+        ImGui::PopID();
+    }
+    if (cancelled)
+        downloads_->cancel(cancelled);
 }
 
 void c_loader_ui::show_login() {
@@ -693,10 +1448,13 @@ void c_loader_ui::show_main() {
 }
 
 void c_loader_ui::set_local_account_username(const std::string& username) {
+    record_call(log_record_type::local_account, [&](c_log_writer& out) { out.put_string(username); });
     user.username = username;
+    wake();
 }
 
 void c_loader_ui::set_license_only_mode(bool enabled) {
+    record_call(log_record_type::license_only_mode, [&](c_log_writer& out) { out.put_bool(enabled); });
     state.license_only_mode = enabled;
     if (enabled) {
         if (!state.authenticated) {
@@ -708,6 +1466,176 @@ void c_loader_ui::set_license_only_mode(bool enabled) {
             show_login();
         }
     }
+    wake();
+}
+
+void c_loader_ui::queue_delta(subscription_delta&& delta) {
+    {
+        std::lock_guard<std::mutex> lock(deltas_->mutex);
+        deltas_->pending.push_back(std::move(delta));
+    }
+    wake();
+}
+
+void c_loader_ui::upsert_subscription(const user_subscription& subscription) {
+    subscription_delta delta;
+    delta.type = subscription_delta::kind::upsert;
+    delta.plan_id = subscription.plan_id;
+    delta.values = subscription;
+    queue_delta(std::move(delta));
+}
+
+void c_loader_ui::remove_subscription(const std::string& plan_id) {
+    subscription_delta delta;
+    delta.type = subscription_delta::kind::remove;
+    delta.plan_id = plan_id;
+    queue_delta(std::move(delta));
+}
+
+void c_loader_ui::patch_subscription(const std::string& plan_id, const subscription_patch& patch) {
+    subscription_delta delta;
+    delta.type = subscription_delta::kind::patch;
+    delta.plan_id = plan_id;
+    if (patch.plan) {
+        delta.fields |= subscription_delta::patch_plan;
+        delta.values.plan = patch.plan;
+    }
+    if (patch.status) {
+        delta.fields |= subscription_delta::patch_status;
+        delta.values.status = patch.status;
+    }
+    if (patch.expires_at) {
+        delta.fields |= subscription_delta::patch_expires_at;
+        delta.values.expires_at = patch.expires_at;
+    }
+    if (patch.default_file_id) {
+        delta.fields |= subscription_delta::patch_default_file_id;
+        delta.values.default_file_id = patch.default_file_id;
+    }
+    if (patch.frozen >= 0) {
+        delta.fields |= subscription_delta::patch_frozen;
+        delta.values.frozen = patch.frozen != 0;
+    }
+    queue_delta(std::move(delta));
+}
+
+void c_loader_ui::set_subscription_image(const std::string& plan_id, std::vector<unsigned char> image, const std::string& mime, const std::string& updated_at) {
+    subscription_delta delta;
+    delta.type = subscription_delta::kind::image;
+    delta.plan_id = plan_id;
+    delta.values.product_image = std::move(image);
+    delta.values.product_image_mime = mime;
+    delta.values.product_image_updated_at = updated_at;
+    queue_delta(std::move(delta));
+}
+
+void c_loader_ui::set_subscription_video(const std::string& plan_id, std::vector<unsigned char> video, const std::string& mime, const std::string& updated_at, const std::string& path) {
+    subscription_delta delta;
+    delta.type = subscription_delta::kind::video;
+    delta.plan_id = plan_id;
+    delta.values.product_video = std::move(video);
+    delta.values.product_video_mime = mime;
+    delta.values.product_video_updated_at = updated_at;
+    delta.values.product_video_path = path;
+    queue_delta(std::move(delta));
+}
+
+// Host-owned subscriptions are copied before their first change.
+user_subscription* c_loader_ui::own_subscription(size_t row) {
+    user_subscription* sub = subscriptions_->source(row);
+    for (const std::unique_ptr<user_subscription>& owned : owned_subscriptions_) {
+        if (owned.get() == sub)
+            return sub;
+    }
+    owned_subscriptions_.push_back(std::make_unique<user_subscription>(*sub));
+    sub = owned_subscriptions_.back().get();
+    user.subscriptions[subscriptions_->source_index(row)] = sub;
+    subscriptions_->set_source(row, sub);
+    return sub;
+}
+
+void c_loader_ui::apply_subscription_deltas() {
+    std::vector<subscription_delta> batch;
+    {
+        std::lock_guard<std::mutex> lock(deltas_->mutex);
+        batch.swap(deltas_->pending);
+    }
+    if (batch.empty())
+        return;
+
+    PROFILE_SCOPE("apply_subscription_deltas", "ui");
+    c_subscription_store& store = *subscriptions_;
+    if (store.source_count() != user.subscriptions.size())
+        rebuild_product_rows();
+
+    for (subscription_delta& delta : batch) {
+        record_call(log_record_type::subscription_delta, [&](c_log_writer& out) { encode_delta(out, delta); });
+
+        const int row = store.find_plan_id(delta.plan_id);
+        if (row < 0 && delta.type != subscription_delta::kind::upsert)
+            continue;
+
+        switch (delta.type) {
+        case subscription_delta::kind::upsert:
+            if (row < 0) {
+                owned_subscriptions_.push_back(std::make_unique<user_subscription>(std::move(delta.values)));
+                user.subscriptions.push_back(owned_subscriptions_.back().get());
+                store.append(user.subscriptions.back(), static_cast<int>(user.subscriptions.size() - 1));
+            }
+            else {
+                *own_subscription(row) = std::move(delta.values);
+                store.reset(row);
+            }
+            break;
+        case subscription_delta::kind::remove: {
+            const user_subscription* sub = store.source(row);
+            user.subscriptions.erase(user.subscriptions.begin() + store.source_index(row));
+            store.erase(row);
+            if (selected_product_row_ == row)
+                selected_product_row_ = -1;
+            else if (selected_product_row_ > row)
+                selected_product_row_--;
+            owned_subscriptions_.erase(std::remove_if(owned_subscriptions_.begin(), owned_subscriptions_.end(),
+                [&](const std::unique_ptr<user_subscription>& owned) { return owned.get() == sub; }), owned_subscriptions_.end());
+            break;
+        }
+        case subscription_delta::kind::patch: {
+            user_subscription* sub = own_subscription(row);
+            if (delta.fields & subscription_delta::patch_plan)
+                sub->plan = std::move(delta.values.plan);
+            if (delta.fields & subscription_delta::patch_status)
+                sub->status = std::move(delta.values.status);
+            if (delta.fields & subscription_delta::patch_expires_at)
+                sub->expires_at = std::move(delta.values.expires_at);
+            if (delta.fields & subscription_delta::patch_default_file_id)
+                sub->default_file_id = std::move(delta.values.default_file_id);
+            if (delta.fields & subscription_delta::patch_frozen)
+                sub->frozen = delta.values.frozen;
+            store.update(row);
+            break;
+        }
+        case subscription_delta::kind::image: {
+            user_subscription* sub = own_subscription(row);
+            sub->product_image = std::move(delta.values.product_image);
+            sub->product_image_mime = std::move(delta.values.product_image_mime);
+            sub->product_image_updated_at = std::move(delta.values.product_image_updated_at);
+            store.set_image(row, {});
+            break;
+        }
+        case subscription_delta::kind::video: {
+            user_subscription* sub = own_subscription(row);
+            sub->product_video = std::move(delta.values.product_video);
+            sub->product_video_mime = std::move(delta.values.product_video_mime);
+            sub->product_video_updated_at = std::move(delta.values.product_video_updated_at);
+            sub->product_video_path = std::move(delta.values.product_video_path);
+            store.set_video(row, {});
+            break;
+        }
+        }
+    }
+    store.compact_strings();
+    // Keys of the touched rows may have moved; the permutation is cheap to rebuild.
+    product_sort_dirty_ = true;
 }
 
 void c_loader_ui::set_login_callback(LoginCallback callback) {
@@ -730,25 +1658,42 @@ void c_loader_ui::set_filestream_callback(FilestreamCallback callback) {
     filestream_callback = callback;
 }
 
+void c_loader_ui::set_filestream_range_callback(FilestreamRangeCallback callback) {
+    filestream_range_callback = callback;
+    if (filestream_range_callback)
+        downloads_->set_transport(filestream_transport_.get());
+    else
+        downloads_->set_transport(download_transport_.get());
+}
+
 void c_loader_ui::set_auth_mode_callback(AuthModeCallback callback) {
     auth_mode_callback = callback;
 }
 
 void c_loader_ui::handle_login_request(const std::string& username, const std::string& password) {
     if (login_callback) {
+        callback_scope callback_timer("login_callback");
         login_callback(username, password);
     }
 }
 
 void c_loader_ui::handle_register_request(const std::string& username, const std::string& password, const std::string& license) {
     if (register_callback) {
+        callback_scope callback_timer("register_callback");
         register_callback(username, password, license);
     }
 }
 
 void c_loader_ui::handle_launch_request(const std::string& file_id) {
     if (filestream_callback && !file_id.empty()) {
-        filestream_callback(file_id);
+        const uint64_t errors = error_messages_;
+        {
+            callback_scope callback_timer("filestream_callback");
+            filestream_callback(file_id);
+        }
+        // An error raised by the callback itself fails this launch, and only this one.
+        if (error_messages_ != errors)
+            downloads_->finish(file_id, false);
     }
 }
 
@@ -757,6 +1702,7 @@ void c_loader_ui::handle_license_redeem(const std::string& license) {
         license_redeem_pending_ = true;
         license_success_active_ = false;
         license_success_message_.clear();
+        callback_scope callback_timer("license_callback");
         license_callback(user.username, license);
     }
 }
@@ -769,21 +1715,25 @@ void c_loader_ui::release_product_views() {
 
 }
 
+void c_loader_ui::cancel_pending_launch() {
+    load_animation_active_ = false;
+    load_animation_product_.clear();
+    pending_file_id_.clear();
+    pending_product_name_.clear();
+    download_start_enqueued_ = false;
+    timers_->cancel(load_animation_timer_);
+    timers_->cancel(download_timer_);
+}
+
 void c_loader_ui::trigger_pending_download() {
-    if (pending_file_id_.empty()) {
-        download_start_enqueued_ = false;
+    download_start_enqueued_ = false;
+    if (pending_file_id_.empty())
         return;
-    }
 
     const std::string file_id = pending_file_id_;
     pending_file_id_.clear();
-
-    download_start_enqueued_ = false;
-    download_delay_until_ = {};
-
-    if (!file_id.empty()) {
-        handle_launch_request(file_id);
-    }
+    downloads_->enqueue(file_id, pending_product_name_, 0);
+    pending_product_name_.clear();
 }
 
 void c_loader_ui::initialize_fallback_icons() {
@@ -810,6 +1760,334 @@ void c_loader_ui::release_fallback_icons() {
 void c_loader_ui::rebuild_product_views() {
 }
 
+bool c_loader_ui::get_framebuffer(const uint32_t** pixels, int* width, int* height) const {
+    if (!initialized || !imgui_manager || !imgui_manager->is_software_rendering())
+        return false;
+
+    const c_soft_renderer& renderer = imgui_manager->get_soft_renderer();
+    if (pixels) *pixels = renderer.pixels();
+    if (width) *width = renderer.width();
+    if (height) *height = renderer.height();
+    return renderer.width() > 0 && renderer.height() > 0;
+}
+
+bool c_loader_ui::get_input_latency(input_latency_stats& out) const {
+    if (!initialized || !imgui_manager)
+        return false;
+
+    static_assert(input_latency_stats::kBuckets == latency_histogram::kBucketCount, "bucket layout is part of the API");
+    const latency_histogram histogram = imgui_manager->get_input_latency();
+    out.samples = histogram.samples;
+    out.mean_ms = histogram.mean_us() / 1000.0;
+    out.p50_ms = histogram.percentile_us(0.50) / 1000.0;
+    out.p90_ms = histogram.percentile_us(0.90) / 1000.0;
+    out.p99_ms = histogram.percentile_us(0.99) / 1000.0;
+    out.max_ms = histogram.max_us / 1000.0;
+    memcpy(out.buckets, histogram.counts, sizeof(out.buckets));
+    return true;
+}
+
+void c_loader_ui::reset_input_latency() {
+    if (imgui_manager)
+        imgui_manager->reset_input_latency();
+}
+
+void c_loader_ui::queue_text_input(const char* utf8) {
+    if (imgui_manager && utf8)
+        imgui_manager->queue_text_input(utf8);
+}
+
+void c_loader_ui::queue_key_input(int key, bool down) {
+    if (imgui_manager)
+        imgui_manager->queue_key_input(static_cast<ImGuiKey>(key), down);
+}
+
+bool c_loader_ui::get_stats(ui_stats& out) const {
+    if (!initialized || !imgui_manager)
+        return false;
+
+    ui_stats stats;
+    stats.version = ui_stats::kVersion;
+
+    c_perf_overlay& overlay = imgui_manager->get_perf_overlay();
+    std::vector<frame_metrics> history(c_metrics_ring::kCapacity);
+    const int count = overlay.ring().copy_recent(history.data(), static_cast<int>(history.size()));
+    stats.frames = overlay.ring().total();
+    for (int i = 0; i < count; i++) {
+        const double cpu_ms = static_cast<double>(history[i].ui_ms) + history[i].submit_ms + history[i].present_ms;
+        stats.avg_frame_ms += cpu_ms;
+        stats.max_frame_ms = (std::max)(stats.max_frame_ms, cpu_ms);
+        stats.last_frame_ms = cpu_ms;
+    }
+    if (count > 0)
+        stats.avg_frame_ms /= count;
+
+    const frame_skip_stats& skips = imgui_manager->get_frame_skip_stats();
+    stats.frames_presented = skips.presented_frames;
+    stats.frames_skipped = skips.skipped_frames;
+
+    c_ui_allocator& allocator = imgui_manager->get_allocator();
+    const allocator_frame_stats& allocations = allocator.last_frame_stats();
+    stats.allocations_per_frame = allocations.allocation_count;
+    stats.allocated_bytes_per_frame = allocations.bytes_allocated;
+    stats.heap_allocations_per_frame = allocations.heap_allocations;
+    stats.heap_live_bytes = allocator.pool_live_bytes();
+    stats.heap_reserved_bytes = allocator.pool_reserved_bytes();
+
+    const ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    stats.atlas_bytes = static_cast<uint64_t>(atlas->TexWidth) * atlas->TexHeight * 4;
+    stats.texture_bytes = stats.atlas_bytes;
+    for (const product_view& view : products) {
+        if (view.owns_image)
+            stats.texture_bytes += texture_bytes(view.image);
+    }
+    for (const std::filesystem::path& path : video_cache_paths) {
+        std::error_code ec;
+        const uintmax_t size = std::filesystem::file_size(path, ec);
+        if (!ec)
+            stats.media_cache_bytes += size;
+    }
+
+    stats.queued_input_events = static_cast<uint32_t>(ImGui::GetCurrentContext()->InputEventsQueue.Size);
+    stats.pending_render_frames = static_cast<uint32_t>(imgui_manager->get_pending_render_frames());
+
+    for (int i = 0; i < c_perf_overlay::kMaxCallbacks; i++) {
+        const c_perf_overlay::callback_timing& timing = overlay.callbacks()[i];
+        if (timing.name == nullptr)
+            break;
+        stats.callback_calls += timing.calls;
+        stats.callback_avg_ms += timing.total_ms;
+        stats.callback_max_ms = (std::max)(stats.callback_max_ms, static_cast<double>(timing.max_ms));
+    }
+    if (stats.callback_calls > 0)
+        stats.callback_avg_ms /= static_cast<double>(stats.callback_calls);
+    stats.callback_last_ms = overlay.last_callback_ms();
+
+    // Only as much as the caller's struct holds; it sets struct_size itself.
+    const uint32_t caller_size = out.struct_size;
+    const size_t copy_size = (std::min)(static_cast<size_t>(caller_size), sizeof(ui_stats));
+    if (copy_size > offsetof(ui_stats, version)) {
+        memcpy(&out, &stats, copy_size);
+        out.struct_size = caller_size;
+    }
+    return copy_size > offsetof(ui_stats, version);
+}
+
+bool c_loader_ui::start_recording(const std::string& path) {
+    if (!initialized || !imgui_manager)
+        return false;
+    if (!imgui_manager->get_input_recorder().start(path.c_str()))
+        return false;
+    // Replays start their countdowns from the wall clock of the recording.
+    record_call(log_record_type::clock, [](c_log_writer& out) { out.put_varint(static_cast<uint64_t>(wall_clock_us())); });
+    return true;
+}
+
+void c_loader_ui::stop_recording() {
+    if (imgui_manager)
+        imgui_manager->get_input_recorder().stop();
+}
+
+bool c_loader_ui::run_replay(const std::string& path, replay_result& result) {
+    result = replay_result{};
+    if (!initialized || !imgui_manager || !imgui_manager->is_headless())
+        return false;
+
+    c_input_log log;
+    if (!log.load(path.c_str()))
+        return false;
+
+    // Replayed profiles point into this until the end of the replay.
+    std::vector<std::unique_ptr<user_subscription>> subscriptions;
+    user_profile profile;
+    bool valid = true;
+
+    // Repeats one host call; false if its record is corrupt.
+    auto apply = [&](const log_record& record) {
+        c_log_reader in(record.payload, record.size);
+        switch (record.type) {
+        case log_record_type::authenticated: {
+            const bool auth = in.get_bool();
+            const bool has_profile = in.get_bool();
+            if (has_profile && !decode_profile(in, profile, subscriptions))
+                return false;
+            if (in.ok())
+                set_authenticated(auth, has_profile ? &profile : nullptr);
+            break;
+        }
+        case log_record_type::status_message:
+            set_status_message(in.get_string());
+            break;
+        case log_record_type::error_message:
+            set_error_message(in.get_string());
+            break;
+        case log_record_type::loading:
+            set_loading(in.get_bool());
+            break;
+        case log_record_type::loading_progress:
+            set_loading_progress(in.get_f32());
+            break;
+        case log_record_type::download_progress: {
+            const std::string file_id = in.get_string();
+            const uint64_t done_bytes = in.get_varint();
+            set_download_progress(file_id, done_bytes, in.get_varint());
+            break;
+        }
+        case log_record_type::download_finished: {
+            const std::string file_id = in.get_string();
+            finish_download(file_id, in.get_bool());
+            break;
+        }
+        case log_record_type::filestream_chunk: {
+            const std::string file_id = in.get_string();
+            const uint64_t offset = in.get_varint();
+            const uint64_t length = in.get_varint();
+            filestream_chunk(file_id, offset, length, in.get_varint());
+            break;
+        }
+        case log_record_type::filestream_failed:
+            filestream_failed(in.get_string());
+            break;
+        case log_record_type::local_account:
+            set_local_account_username(in.get_string());
+            break;
+        case log_record_type::license_only_mode:
+            set_license_only_mode(in.get_bool());
+            break;
+        case log_record_type::subscription_delta: {
+            subscription_delta delta;
+            if (!decode_delta(in, delta))
+                return false;
+            queue_delta(std::move(delta));
+            break;
+        }
+        case log_record_type::clock:
+            replay_wall_us_ = static_cast<int64_t>(in.get_varint());
+            return in.ok();
+        default:
+            // Callback markers are handled by replay_callback; newer types are skipped.
+            return true;
+        }
+        result.state_changes++;
+        return in.ok();
+    };
+
+    auto names = [](const log_record& record, const char* name) {
+        c_log_reader in(record.payload, record.size);
+        return in.get_string() == name;
+    };
+
+    // Stands in for a host callback: repeats what was logged this frame up to the end of
+    // the callback's recorded call, so the calls the host made inside it land before the
+    // rest of the frame runs. Nothing is repeated if the recording never made the call.
+    auto replay_callback = [&](const char* name) {
+        const size_t start = log.tell();
+        log_record record;
+        bool found = false;
+        while (!found && log.next(record) && record.type != log_record_type::frame)
+            found = record.type == log_record_type::callback && names(record, name);
+        log.seek(start);
+        if (!found)
+            return;
+
+        bool inside = false;
+        while (valid && log.next(record)) {
+            if (record.type == log_record_type::callback)
+                inside = inside || names(record, name);
+            else if (record.type == log_record_type::callback_return) {
+                if (inside && names(record, name))
+                    break;
+            }
+            else
+                valid = apply(record);
+        }
+    };
+
+    // The host never hears from a replay. Set callbacks are swapped rather than cleared
+    // so the UI takes the same paths as with the host attached.
+    const LoginCallback host_login = login_callback;
+    const RegisterCallback host_register = register_callback;
+    const LicenseCallback host_license = license_callback;
+    const ExitCallback host_exit = exit_callback;
+    const FilestreamCallback host_filestream = filestream_callback;
+    const FilestreamRangeCallback host_filestream_range = filestream_range_callback;
+    const AuthModeCallback host_auth_mode = auth_mode_callback;
+    auto stub = [&](auto& callback, const char* name) {
+        if (callback)
+            callback = [&replay_callback, name](const auto&...) { replay_callback(name); };
+    };
+    stub(login_callback, "login_callback");
+    stub(register_callback, "register_callback");
+    stub(license_callback, "license_callback");
+    stub(exit_callback, "exit_callback");
+    stub(filestream_callback, "filestream_callback");
+    stub(filestream_range_callback, "filestream_callback");
+    stub(auth_mode_callback, "auth_mode_callback");
+
+    replay_clock_ = true;
+    replay_clock_us_ = c_timer_wheel::now_us();
+    replay_wall_us_ = wall_clock_us();
+
+    log_record record;
+    while (valid && log.next(record)) {
+        if (record.type != log_record_type::frame) {
+            valid = apply(record);
+            continue;
+        }
+
+        float delta_time = 0.f;
+        int events = 0;
+        valid = c_input_log::queue_frame(record, delta_time, events);
+        if (!valid)
+            break;
+        imgui_manager->set_next_delta_time(delta_time);
+        const uint64_t delta_us = static_cast<uint64_t>(static_cast<double>(delta_time) * 1e6);
+        replay_clock_us_ += delta_us;
+        replay_wall_us_ += static_cast<int64_t>(delta_us);
+
+        const auto start = std::chrono::steady_clock::now();
+        update();
+        render();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.frames++;
+        result.input_events += static_cast<uint64_t>(events);
+        result.total_ms += ms;
+        result.max_frame_ms = (std::max)(result.max_frame_ms, ms);
+    }
+
+    if (result.frames > 0)
+        result.avg_frame_ms = result.total_ms / static_cast<double>(result.frames);
+    result.complete = valid && !log.truncated();
+
+    // Nothing may keep pointing into the replay's subscriptions.
+    selected_product_row_ = -1;
+    if (!user.subscriptions.empty())
+        set_authenticated(false, nullptr);
+
+    login_callback = host_login;
+    register_callback = host_register;
+    license_callback = host_license;
+    exit_callback = host_exit;
+    filestream_callback = host_filestream;
+    filestream_range_callback = host_filestream_range;
+    auth_mode_callback = host_auth_mode;
+    replay_clock_ = false;
+    return true;
+}
+
+void c_loader_ui::set_perf_overlay_visible(bool visible) {
+    if (imgui_manager)
+        imgui_manager->get_perf_overlay().set_visible(visible);
+}
+
+std::string c_loader_ui::get_trace() const {
+    return c_profiler::write_chrome_trace();
+}
+
+void c_loader_ui::clear_trace() {
+    c_profiler::clear();
+}
+
 void c_loader_ui::close() {
     should_close = true;
     if (imgui_manager) {
@@ -822,6 +2100,7 @@ static void(*g_register_callback)(const char*, const char*, const char*) = nullp
 static void(*g_license_callback)(const char*, const char*) = nullptr;
 static void(*g_exit_callback)() = nullptr;
 static void (*g_filestream_callback)(const char*) = nullptr;
+static void (*g_filestream_range_callback)(const char*, const filestream_range*, size_t) = nullptr;
 static void(*g_auth_mode_callback)(bool) = nullptr;
 
 extern "C" {
@@ -842,6 +2121,75 @@ extern "C" {
         return ui->initialize(config);
     }
 
+    LOADER_UI_API bool ui_initialize_headless(c_loader_ui* ui, const char* title) {
+        if (!ui) return false;
+
+        ui_config config;
+        config.title = title ? title : "Bootstrapper";
+        config.headless = true;
+
+        return ui->initialize(config);
+    }
+
+    LOADER_UI_API bool ui_initialize_software(c_loader_ui* ui, const char* title) {
+        if (!ui) return false;
+
+        ui_config config;
+        config.title = title ? title : "Bootstrapper";
+        config.headless = true;
+        config.software_render = true;
+
+        return ui->initialize(config);
+    }
+
+    LOADER_UI_API bool ui_get_framebuffer(c_loader_ui* ui, const uint32_t** rgba, int* width, int* height) {
+        return ui ? ui->get_framebuffer(rgba, width, height) : false;
+    }
+
+    LOADER_UI_API bool ui_start_recording(c_loader_ui* ui, const char* path) {
+        if (!ui || !path) return false;
+        return ui->start_recording(path);
+    }
+
+    LOADER_UI_API void ui_stop_recording(c_loader_ui* ui) {
+        if (ui) ui->stop_recording();
+    }
+
+    LOADER_UI_API bool ui_run_replay(c_loader_ui* ui, const char* path, replay_result* result) {
+        if (!ui || !path || !result) return false;
+        return ui->run_replay(path, *result);
+    }
+
+    LOADER_UI_API void ui_set_perf_overlay(c_loader_ui* ui, bool visible) {
+        if (ui) ui->set_perf_overlay_visible(visible);
+    }
+
+    LOADER_UI_API size_t ui_dump_trace(c_loader_ui* ui, char* buffer, size_t capacity) {
+        if (!ui) return 0;
+        const std::string trace = ui->get_trace();
+        if (buffer && capacity > trace.size())
+            memcpy(buffer, trace.c_str(), trace.size() + 1);
+        return trace.size() + 1;
+    }
+
+    LOADER_UI_API bool ui_write_trace_file(c_loader_ui* ui, const char* path) {
+        if (!ui || !path) return false;
+        const std::string trace = ui->get_trace();
+        FILE* file = fopen(path, "wb");
+        if (!file) return false;
+        const bool written = fwrite(trace.data(), 1, trace.size(), file) == trace.size();
+        return fclose(file) == 0 && written;
+    }
+
+    LOADER_UI_API void ui_clear_trace(c_loader_ui* ui) {
+        if (ui) ui->clear_trace();
+    }
+
+    LOADER_UI_API bool ui_get_input_latency(c_loader_ui* ui, input_latency_stats* stats) {
+        if (!ui || !stats) return false;
+        return ui->get_input_latency(*stats);
+    }
+
     LOADER_UI_API void ui_shutdown(c_loader_ui* ui) {
         if (ui) ui->shutdown();
     }
@@ -864,6 +2212,11 @@ extern "C" {
         }
     }
 
+    LOADER_UI_API bool ui_set_authenticated_desc(c_loader_ui* ui, bool auth, const ui_profile_desc* profile) {
+        if (!ui || !profile) return false;
+        return ui->set_authenticated(auth, *profile);
+    }
+
     LOADER_UI_API void ui_set_status_message(c_loader_ui* ui, const char* message) {
         if (ui) ui->set_status_message(message ? message : "");
     }
@@ -880,10 +2233,30 @@ extern "C" {
         if (ui) ui->set_loading_progress(progress);
     }
 
+    LOADER_UI_API void ui_set_download_progress(c_loader_ui* ui, const char* file_id, uint64_t done_bytes, uint64_t total_bytes) {
+        if (ui && file_id) ui->set_download_progress(file_id, done_bytes, total_bytes);
+    }
+
+    LOADER_UI_API void ui_finish_download(c_loader_ui* ui, const char* file_id, bool ok) {
+        if (ui && file_id) ui->finish_download(file_id, ok);
+    }
+
+    LOADER_UI_API void ui_filestream_chunk(c_loader_ui* ui, const char* file_id, uint64_t offset, uint64_t length, uint64_t total_bytes) {
+        if (ui && file_id) ui->filestream_chunk(file_id, offset, length, total_bytes);
+    }
+
+    LOADER_UI_API void ui_filestream_failed(c_loader_ui* ui, const char* file_id) {
+        if (ui && file_id) ui->filestream_failed(file_id);
+    }
+
     LOADER_UI_API void ui_close(c_loader_ui* ui) {
         if (ui) ui->close();
     }
 
+    LOADER_UI_API void ui_wake(c_loader_ui* ui) {
+        if (ui) ui->wake();
+    }
+
     LOADER_UI_API void ui_set_local_account(c_loader_ui* ui, const char* username) {
         if (ui && username) {
             ui->set_local_account_username(username);
@@ -896,6 +2269,28 @@ extern "C" {
         }
     }
 
+    LOADER_UI_API void ui_upsert_subscription(c_loader_ui* ui, const user_subscription* subscription) {
+        if (ui && subscription) ui->upsert_subscription(*subscription);
+    }
+
+    LOADER_UI_API void ui_remove_subscription(c_loader_ui* ui, const char* plan_id) {
+        if (ui && plan_id) ui->remove_subscription(plan_id);
+    }
+
+    LOADER_UI_API void ui_patch_subscription(c_loader_ui* ui, const char* plan_id, const subscription_patch* patch) {
+        if (ui && plan_id && patch) ui->patch_subscription(plan_id, *patch);
+    }
+
+    LOADER_UI_API void ui_set_subscription_image(c_loader_ui* ui, const char* plan_id, const unsigned char* data, size_t size, const char* mime, const char* updated_at) {
+        if (!ui || !plan_id || (!data && size)) return;
+        ui->set_subscription_image(plan_id, std::vector<unsigned char>(data, data + size), mime ? mime : "", updated_at ? updated_at : "");
+    }
+
+    LOADER_UI_API void ui_set_subscription_video(c_loader_ui* ui, const char* plan_id, const unsigned char* data, size_t size, const char* mime, const char* updated_at, const char* path) {
+        if (!ui || !plan_id || (!data && size)) return;
+        ui->set_subscription_video(plan_id, std::vector<unsigned char>(data, data + size), mime ? mime : "", updated_at ? updated_at : "", path ? path : "");
+    }
+
     LOADER_UI_API void ui_set_auth_mode_callback(c_loader_ui* ui, void(*callback)(bool)) {
         if (!ui) return;
 
@@ -1002,4 +2397,25 @@ extern "C" {
             ui->set_filestream_callback(nullptr);
         }
     }
+
+    LOADER_UI_API void ui_set_filestream_range_callback(
+        c_loader_ui* ui,
+        void(*callback)(const char*, const filestream_range*, size_t)
+    ) {
+        if (!ui) return;
+
+        g_filestream_range_callback = callback;
+
+        if (callback) {
+            ui->set_filestream_range_callback([](const std::string& file_id, const filestream_range* ranges, size_t count)
+                {
+                    if (g_filestream_range_callback) {
+                        g_filestream_range_callback(file_id.c_str(), ranges, count);
+                    }
+                });
+        }
+        else {
+            ui->set_filestream_range_callback(nullptr);
+        }
+    }
 }
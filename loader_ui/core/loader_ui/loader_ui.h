@@ -8,6 +8,7 @@
 #include <memory>
 #include <filesystem>
 #include <chrono>
+#include <cstdint>
 
 // DLL export/import macros - respect static builds
 #ifdef _WIN32
@@ -27,6 +28,13 @@ struct HWND__;
 typedef HWND__* HWND;
 
 struct ID3D11ShaderResourceView;
+struct ImGuiTableSortSpecs;
+
+// Byte range of a loader file; a zero length runs to the end of the file.
+struct filestream_range {
+    uint64_t offset;
+    uint64_t length;
+};
 
 // Callback function types
 typedef std::function<void(const std::string&, const std::string&)> LoginCallback;
@@ -34,6 +42,7 @@ typedef std::function<void(const std::string&, const std::string&, const std::st
 typedef std::function<void(const std::string&, const std::string&)> LicenseCallback;
 typedef std::function<void()> ExitCallback;
 typedef std::function<void(const std::string&)> FilestreamCallback;
+typedef std::function<void(const std::string&, const filestream_range*, size_t)> FilestreamRangeCallback;
 typedef std::function<void(bool)> AuthModeCallback;
 
 struct user_subscription {
@@ -59,9 +68,164 @@ struct user_profile {
     std::vector<user_subscription*> subscriptions;
 };
 
+// Plain C description of a profile for ui_set_authenticated_desc, so hosts need neither
+// this library's C++ runtime nor a copy of their data. Strings are views and need no
+// terminator; { nullptr, 0 } is empty.
+struct ui_string_view {
+    const char* data;
+    size_t length;
+};
+
+// Host bytes the UI borrows instead of copying. Once ui_set_authenticated_desc returns
+// true, release(user), if set, is called exactly once on the UI thread when the UI stops
+// referencing data: after a later profile or delta replaces it, on sign-out, or when the UI
+// is destroyed. On false the host keeps ownership.
+struct ui_media_buffer {
+    const unsigned char* data;
+    size_t size;
+    void (*release)(void* user);
+    void* user;
+};
+
+struct ui_subscription_desc {
+    ui_string_view plan;
+    ui_string_view expires_at;
+    ui_string_view status;
+    ui_string_view plan_id;
+    ui_string_view default_file_id;
+    ui_string_view image_mime;
+    ui_string_view image_updated_at;
+    ui_media_buffer image;
+    ui_string_view video_mime;
+    ui_string_view video_updated_at;
+    ui_string_view video_path;
+    ui_media_buffer video;
+    uint8_t frozen;
+};
+
+// struct_size and subscription_stride are the sizes the host was built with; fields
+// appended later read as zero for older hosts.
+struct ui_profile_desc {
+    uint32_t struct_size;
+    ui_string_view username;
+    ui_string_view email;
+    ui_string_view ip;
+    const ui_subscription_desc* subscriptions;
+    size_t subscription_count;
+    size_t subscription_stride;
+};
+
+// Fields changed by patch_subscription; null strings and a negative frozen are left as is.
+struct subscription_patch {
+    const char* plan = nullptr;
+    const char* status = nullptr;
+    const char* expires_at = nullptr;
+    const char* default_file_id = nullptr;
+    int frozen = -1;
+};
+
 struct ui_config {
     const char* title = "Bootstrapper";
     const char* application_name = "TestClient";
+    bool headless = false;
+    // Skip submit/present while the UI is pixel-identical to the last presented frame. Opt-in.
+    bool frame_skip = false;
+    // Headless only: rasterize frames on the CPU (see get_framebuffer).
+    bool software_render = false;
+    // Headless only: the display frames are laid out and rasterized on.
+    int display_width = 1280;
+    int display_height = 720;
+    // TTF every UI font is loaded from. Unset uses Bahnschrift from the Windows fonts
+    // directory, or ImGui's embedded font headless or when the file is missing.
+    const char* font_path = nullptr;
+    // Submit and present on a dedicated thread so GPU stalls and vsync don't block the caller.
+    bool render_thread = false;
+    // Longest sleep of an idle frame when no deadline is scheduled. Every state call wakes
+    // the UI; hosts that also write ui_state directly must call ui_wake() after.
+    uint32_t max_idle_wait_ms = 100;
+    // Record frame, render and callback timings for get_trace(). Can be toggled later.
+    bool profiling = false;
+    // If set, the product list is saved here at shutdown while signed in and deleted on
+    // sign-out, and the next initialize() shows it right away, marked stale, until
+    // set_authenticated arrives.
+    const char* profile_snapshot_path = nullptr;
+    // Load queues the product at once at the chosen priority and stays enabled; every
+    // finished download raises the completion popup. Unset keeps the original launch: a 5 s
+    // loading animation, the "Launch complete." popup, and the download starts 5 s after OK.
+    bool queue_launches = false;
+    // Filestream sessions run at once. Hosts that report per-file progress through
+    // set_download_progress can raise it; set_loading_progress only tracks one session.
+    int download_sessions = 1;
+    // Set if the host ends every filestream callback download itself, with finish_download
+    // or set_loading(false). Unset, a download is done once the callback returns.
+    bool report_downloads = false;
+    // With a filestream range callback, checkpoints of unfinished downloads are kept here
+    // so the next launch requests only the missing ranges. Unset keeps them in memory.
+    const char* filestream_checkpoint_directory = nullptr;
+};
+
+// Input-to-present latency of key/char/button presses. buckets[] is log-linear in
+// microseconds: indices 0-3 hold 0-3 us, above that each power of two is split in four
+// (index i >= 4 ends at (5 + i % 4) << (i / 4 - 1) us); the last bucket also takes overflow.
+struct input_latency_stats {
+    static constexpr int kBuckets = 80;
+    uint64_t samples = 0;
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p90_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+    uint64_t buckets[kBuckets] = {};
+};
+
+// Runtime cost counters for telemetry, filled by ui_get_stats. Callers set struct_size to
+// the sizeof(ui_stats) they were built against; only that many bytes are written, so older
+// hosts keep working as fields are appended. Never reorder or remove fields; bump
+// kVersion when appending.
+struct ui_stats {
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t struct_size = sizeof(ui_stats);
+    uint32_t version = 0;                   // set by the library
+
+    // CPU time per frame (building + submit + present call), over the last 256 frames.
+    uint64_t frames = 0;
+    double last_frame_ms = 0.0;
+    double avg_frame_ms = 0.0;
+    double max_frame_ms = 0.0;
+    uint64_t frames_presented = 0;
+    uint64_t frames_skipped = 0;            // identical to the last presented frame
+
+    // ImGui allocator, last completed frame.
+    uint64_t allocations_per_frame = 0;
+    uint64_t allocated_bytes_per_frame = 0;
+    uint64_t heap_allocations_per_frame = 0;
+    uint64_t heap_live_bytes = 0;
+    uint64_t heap_reserved_bytes = 0;
+
+    // 32-bit texels, top mip only.
+    uint64_t atlas_bytes = 0;
+    uint64_t texture_bytes = 0;             // atlas plus product images
+    uint64_t media_cache_bytes = 0;         // cached video files on disk
+
+    uint32_t queued_input_events = 0;
+    uint32_t pending_render_frames = 0;     // published to the render thread, not yet presented
+
+    // Host callbacks (login, register, license, filestream, auth mode), since initialize.
+    uint64_t callback_calls = 0;
+    double callback_last_ms = 0.0;
+    double callback_avg_ms = 0.0;
+    double callback_max_ms = 0.0;
+};
+
+struct replay_result {
+    uint64_t frames = 0;
+    uint64_t input_events = 0;
+    uint64_t state_changes = 0;         // host calls repeated from the log
+    double total_ms = 0.0;              // update() + render() of every frame
+    double avg_frame_ms = 0.0;
+    double max_frame_ms = 0.0;
+    bool complete = false;              // false if the log was truncated or corrupt
 };
 
 struct ui_state {
@@ -74,6 +238,16 @@ struct ui_state {
     std::string error_message;
 };
 class c_video_player;
+class c_timer_wheel;
+class c_subscription_store;
+class c_download_transport;
+class c_callback_transport;
+class c_download_scheduler;
+class c_filestream_transport;
+struct byte_range;
+struct media_release_queue;
+struct subscription_delta;
+struct download_item;
 class LOADER_UI_API c_loader_ui {
 public:
     struct product_view {
@@ -90,35 +264,13 @@ public:
     };
 
 private:
-    enum class banner_kind {
-        none,
-        info,
-        success,
-        error,
-        loading,
-        prompt
-    };
-
-    struct banner_state {
-        banner_kind kind = banner_kind::none;
-        std::string text;
-        std::chrono::steady_clock::time_point start_time{};
-        float duration = 0.f;
-        bool auto_clear = false;
-
-        bool has_follow_up = false;
-        banner_kind follow_up_kind = banner_kind::none;
-        std::string follow_up_text;
-        float follow_up_duration = 0.f;
-        bool follow_up_auto_clear = false;
-    };
-
     // Callback functions
     LoginCallback login_callback;
     RegisterCallback register_callback;
     LicenseCallback license_callback;
     ExitCallback exit_callback;
     FilestreamCallback filestream_callback;
+    FilestreamRangeCallback filestream_range_callback;
     AuthModeCallback auth_mode_callback;
 
     // Internal state
@@ -140,46 +292,101 @@ private:
     void render_auth_mode_window();
     static void apply_base_theme();
 
-    void show_banner(banner_kind kind, const std::string& text, float duration = 0.f, bool auto_clear = false);
-    void show_banner_with_follow_up(banner_kind kind,
-        const std::string& text,
-        float duration,
-        bool auto_clear,
-        banner_kind follow_up_kind,
-        const std::string& follow_up_text,
-        float follow_up_duration,
-        bool follow_up_auto_clear);
-    void update_banner();
-    banner_state banner_;
-
     // License redemption feedback
     bool license_redeem_pending_ = false;
     bool license_success_active_ = false;
-    std::chrono::steady_clock::time_point license_success_start_{};
     std::string license_success_message_;
     inline static constexpr float kLicenseBannerDuration = 5.0f;
 
-    // Load animation and completion popup
-    bool load_animation_active_ = false;
-    std::chrono::steady_clock::time_point load_animation_start_{};
-    std::string load_animation_product_;
+    // Completion popup
     bool load_completion_popup_pending_ = false;
     std::string load_completion_message_;
-    bool load_animation_stop_requested_ = false;
-    inline static constexpr float kLoadAnimationDuration = 5.0f;
-    user_subscription* selected_subscription_snapshot_ = nullptr;
 
-    // Pending file launch coordination
+    // Launch without config.queue_launches: the loading animation, then the popup, then
+    // the download is queued once the start delay has run out.
+    bool load_animation_active_ = false;
+    uint64_t load_animation_start_us_ = 0;
+    std::string load_animation_product_;
+    inline static constexpr float kLoadAnimationDuration = 5.0f;
+    inline static constexpr uint64_t kDownloadDelayUs = 5'000'000;
+    uint64_t load_animation_timer_ = 0;
+    uint64_t download_timer_ = 0;
     std::string pending_file_id_;
     std::string pending_product_name_;
     bool download_start_enqueued_ = false;
-    std::chrono::steady_clock::time_point download_delay_until_{};
+    void cancel_pending_launch();
+    void trigger_pending_download();
 
-    // Actual download progress (post-confirmation)
-    bool download_active_ = false;
-    float download_progress_ = 0.f;
+    // Deadlines of the time-driven state below. update() runs what is due; render() hands
+    // the next deadline to the frame pacer so idle frames sleep until then.
+    std::unique_ptr<c_timer_wheel> timers_;
+    uint64_t license_banner_timer_ = 0;
 
-    void trigger_pending_download();
+    // Clocks the time-driven state reads. A replay drives them from the recorded delta
+    // times instead of the steady and wall clocks.
+    uint64_t clock_us() const;
+    int64_t wall_us() const;
+    bool replay_clock_ = false;
+    uint64_t replay_clock_us_ = 0;
+    int64_t replay_wall_us_ = 0;
+
+    // Column store of the profile's subscriptions, rebuilt when the profile arrives. The
+    // product table is clipped, so per-row work only runs for rows in view.
+    std::unique_ptr<c_subscription_store> subscriptions_;
+    std::vector<int> sorted_rows_;          // store rows in table sort order
+    std::vector<int> visible_rows_;         // sorted_rows_ entries matching the search
+    int selected_product_row_ = -1;         // store row, -1 for none
+    bool product_sort_dirty_ = true;
+    bool product_filter_dirty_ = true;
+    char product_filter_[64] = "";
+    std::string applied_filter_;            // lowercase query visible_rows_ was built for
+    float status_column_width_ = 0.f;       // fit to the statuses, 0 before the table exists
+    void sort_product_rows(const ImGuiTableSortSpecs* specs);
+    void filter_product_rows();
+
+    // Subscription deltas queued from any thread and applied together at the start of
+    // update(). Subscriptions they create, and host-owned ones they change, are owned here.
+    struct delta_queue;
+    std::unique_ptr<delta_queue> deltas_;
+    std::vector<std::unique_ptr<user_subscription>> owned_subscriptions_;
+    void queue_delta(subscription_delta&& delta);
+    void apply_subscription_deltas();
+    user_subscription* own_subscription(size_t row);
+
+    // Host media releases, queued by whichever thread dropped the last reference and run
+    // on the UI thread at the start of update() and on destruction.
+    std::shared_ptr<media_release_queue> media_releases_;
+    void run_media_releases();
+    void apply_authenticated(bool auth, user_profile* new_profile);
+
+    // Products drawn from the last session's snapshot until the host's profile arrives.
+    bool products_stale_ = false;
+    void load_profile_snapshot();
+    void save_profile_snapshot() const;
+    void remove_profile_snapshot() const;
+    bool reconcile_stale_rows(const user_profile& fresh);
+    int64_t next_expiry_change_us_ = INT64_MAX;     // wall clock; earliest visible change
+    void rebuild_product_rows();
+
+    // Products queued for launch. Up to config.download_sessions of them run at once, each
+    // through the host's filestream callback, or as resumable chunked sessions when the
+    // host set a range callback.
+    std::unique_ptr<c_callback_transport> download_transport_;
+    std::unique_ptr<c_filestream_transport> filestream_transport_;
+    std::unique_ptr<c_download_scheduler> downloads_;
+    int load_priority_ = 1;                 // index into the High/Normal/Low combo
+    uint64_t error_messages_ = 0;           // set_error_message calls, to spot failed launches
+
+    // Download reports from any thread, applied in order at the start of update().
+    struct download_event;
+    struct download_event_queue;
+    std::unique_ptr<download_event_queue> download_events_;
+    void queue_download_event(download_event&& event);
+    void apply_download_events();
+    void render_downloads();
+    void on_download_finished(const download_item& item);
+    void request_file_ranges(const std::string& file_id, const std::vector<byte_range>& ranges);
+    void retry_file_ranges(const std::string& file_id);
 public:
     c_loader_ui();
     ~c_loader_ui();
@@ -196,6 +403,8 @@ public:
 
     // State management
     void set_authenticated(bool auth, user_profile* user);
+    // Same as above from a C description; image and video bytes are borrowed, not copied.
+    bool set_authenticated(bool auth, const ui_profile_desc& profile);
     void set_status_message(const std::string& message);
     void set_error_message(const std::string& message);
     void set_loading(bool active);
@@ -205,12 +414,22 @@ public:
     void set_local_account_username(const std::string& username);
     void set_license_only_mode(bool enabled);
 
+    // Incremental changes to the current subscriptions, keyed by plan_id, instead of a
+    // full set_authenticated(). Thread-safe; only the affected rows are rebuilt.
+    void upsert_subscription(const user_subscription& subscription);
+    void remove_subscription(const std::string& plan_id);
+    void patch_subscription(const std::string& plan_id, const subscription_patch& patch);
+    void set_subscription_image(const std::string& plan_id, std::vector<unsigned char> image, const std::string& mime, const std::string& updated_at);
+    void set_subscription_video(const std::string& plan_id, std::vector<unsigned char> video, const std::string& mime, const std::string& updated_at, const std::string& path);
+
     // Callback setters
     void set_login_callback(LoginCallback callback);
     void set_register_callback(RegisterCallback callback);
     void set_license_callback(LicenseCallback callback);
     void set_exit_callback(ExitCallback callback);
     void set_filestream_callback(FilestreamCallback callback);
+    // Replaces the filestream callback for launches with chunked, resumable sessions.
+    void set_filestream_range_callback(FilestreamRangeCallback callback);
     void set_auth_mode_callback(AuthModeCallback callback);
 
     void handle_login_request(const std::string& username, const std::string& password);
@@ -221,7 +440,52 @@ public:
 
     // Utility
     void close();
+    // Download reports below, and set_loading, are thread-safe; they take effect at the
+    // start of the next frame.
+    // Applies to the longest-running download.
     void set_loading_progress(float progress);
+    // Progress of one of several concurrent filestream sessions; a zero total keeps the
+    // last one reported. Reaching the total completes the download.
+    void set_download_progress(const std::string& file_id, uint64_t done_bytes, uint64_t total_bytes);
+    void finish_download(const std::string& file_id, bool ok);
+    // Chunked sessions: the host delivered [offset, offset + length) of a file it was asked
+    // for through the range callback, or lost the connection. Thread-safe; applied at the
+    // start of the next frame. After a failure, or once a request was delivered with pieces
+    // still missing, the missing ranges are requested again with backoff.
+    void filestream_chunk(const std::string& file_id, uint64_t offset, uint64_t length, uint64_t total_bytes);
+    void filestream_failed(const std::string& file_id);
+    // Thread-safe: ends an idle sleep so the next frame starts now.
+    void wake();
+
+    // Headless + software rendering only.
+    bool get_framebuffer(const uint32_t** pixels, int* width, int* height) const;
+    bool get_input_latency(input_latency_stats& out) const;
+    void reset_input_latency();
+    // Synthetic input, stamped for input latency like window messages and applied on the
+    // next frame. `key` is an ImGuiKey.
+    void queue_text_input(const char* utf8);
+    void queue_key_input(int key, bool down);
+
+    bool get_stats(ui_stats& out) const;
+
+    // Logs frame timing, every input event ImGui consumes and every state call below
+    // (set_authenticated, set_status_message, ...) to a binary file until stopped.
+    bool start_recording(const std::string& path);
+    void stop_recording();
+    // Drives this instance from a recorded log at full speed. Requires headless mode;
+    // the replay ends signed out. Host callbacks are not called while it runs: the calls
+    // the host made from inside them are replayed in their place, and timers, downloads
+    // and countdowns follow the recorded delta times. Host calls made from other threads
+    // land between frames. Returns false if the log cannot be read.
+    bool run_replay(const std::string& path, replay_result& result);
+    // Frame time, draw and memory counters; also toggled in-app with Ctrl+Shift+F12.
+    void set_perf_overlay_visible(bool visible);
+
+    // The profiler is process-wide; these act on every instance.
+    void set_profiling(bool enabled);
+    // Chrome trace-event JSON of the recent history (chrome://tracing, Perfetto).
+    std::string get_trace() const;
+    void clear_trace();
 };
 
 // C-style exported functions for DLL interface
@@ -229,19 +493,46 @@ extern "C" {
     LOADER_UI_API c_loader_ui* create_loader_ui();
     LOADER_UI_API void destroy_loader_ui(c_loader_ui* ui);
     LOADER_UI_API bool ui_initialize(c_loader_ui* ui, const char* title);
+    LOADER_UI_API bool ui_initialize_headless(c_loader_ui* ui, const char* title);
     LOADER_UI_API void ui_shutdown(c_loader_ui* ui);
     LOADER_UI_API bool ui_should_run(c_loader_ui* ui);
     LOADER_UI_API void ui_update(c_loader_ui* ui);
     LOADER_UI_API void ui_render(c_loader_ui* ui);
     LOADER_UI_API void ui_set_authenticated(c_loader_ui* ui, bool auth, user_profile* new_profile);
+    LOADER_UI_API bool ui_set_authenticated_desc(c_loader_ui* ui, bool auth, const ui_profile_desc* profile);
     LOADER_UI_API void ui_set_status_message(c_loader_ui* ui, const char* message);
     LOADER_UI_API void ui_set_error_message(c_loader_ui* ui, const char* message);
     LOADER_UI_API void ui_set_loading(c_loader_ui* ui, bool loading);
     LOADER_UI_API void ui_set_loading_progress(c_loader_ui* ui, float progress);
+    LOADER_UI_API void ui_set_download_progress(c_loader_ui* ui, const char* file_id, uint64_t done_bytes, uint64_t total_bytes);
+    LOADER_UI_API void ui_finish_download(c_loader_ui* ui, const char* file_id, bool ok);
+    LOADER_UI_API void ui_filestream_chunk(c_loader_ui* ui, const char* file_id, uint64_t offset, uint64_t length, uint64_t total_bytes);
+    LOADER_UI_API void ui_filestream_failed(c_loader_ui* ui, const char* file_id);
     LOADER_UI_API void ui_close(c_loader_ui* ui);
+    LOADER_UI_API void ui_wake(c_loader_ui* ui);
     LOADER_UI_API void ui_set_local_account(c_loader_ui* ui, const char* username);
     LOADER_UI_API void ui_set_license_only_mode(c_loader_ui* ui, bool enabled);
+    LOADER_UI_API void ui_upsert_subscription(c_loader_ui* ui, const user_subscription* subscription);
+    LOADER_UI_API void ui_remove_subscription(c_loader_ui* ui, const char* plan_id);
+    LOADER_UI_API void ui_patch_subscription(c_loader_ui* ui, const char* plan_id, const subscription_patch* patch);
+    LOADER_UI_API void ui_set_subscription_image(c_loader_ui* ui, const char* plan_id, const unsigned char* data, size_t size, const char* mime, const char* updated_at);
+    LOADER_UI_API void ui_set_subscription_video(c_loader_ui* ui, const char* plan_id, const unsigned char* data, size_t size, const char* mime, const char* updated_at, const char* path);
     LOADER_UI_API void ui_set_auth_mode_callback(c_loader_ui* ui, void(*callback)(bool));
+    LOADER_UI_API bool ui_initialize_software(c_loader_ui* ui, const char* title);
+    LOADER_UI_API bool ui_get_framebuffer(c_loader_ui* ui, const uint32_t** rgba, int* width, int* height);
+    LOADER_UI_API bool ui_start_recording(c_loader_ui* ui, const char* path);
+    LOADER_UI_API void ui_stop_recording(c_loader_ui* ui);
+    LOADER_UI_API bool ui_run_replay(c_loader_ui* ui, const char* path, replay_result* result);
+    // stats->struct_size must be set; see ui_stats.
+    LOADER_UI_API bool ui_get_stats(c_loader_ui* ui, ui_stats* stats);
+    LOADER_UI_API void ui_set_perf_overlay(c_loader_ui* ui, bool visible);
+    LOADER_UI_API void ui_set_profiling(c_loader_ui* ui, bool enabled);
+    // Copies the trace with its terminator if it fits and returns the size it needs; pass
+    // a null buffer to query.
+    LOADER_UI_API size_t ui_dump_trace(c_loader_ui* ui, char* buffer, size_t capacity);
+    LOADER_UI_API bool ui_write_trace_file(c_loader_ui* ui, const char* path);
+    LOADER_UI_API void ui_clear_trace(c_loader_ui* ui);
+    LOADER_UI_API bool ui_get_input_latency(c_loader_ui* ui, input_latency_stats* stats);
 
     // C-style callback setters to avoid std::function export issues
     LOADER_UI_API void ui_set_login_callback(c_loader_ui* ui, void(*callback)(const char*, const char*));
@@ -249,6 +540,7 @@ extern "C" {
     LOADER_UI_API void ui_set_license_callback(c_loader_ui* ui, void(*callback)(const char*, const char*));
     LOADER_UI_API void ui_set_exit_callback(c_loader_ui* ui, void(*callback)());
     LOADER_UI_API void ui_set_filestream_callback(c_loader_ui* ui, void(*callback)(const char*));
+    LOADER_UI_API void ui_set_filestream_range_callback(c_loader_ui* ui, void(*callback)(const char*, const filestream_range*, size_t));
 }
 
 #endif // LOADER_UI_HPP
@@ -0,0 +1,172 @@
+#include "perf_overlay.h"
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
+
+void c_metrics_ring::push(const frame_metrics& metrics) {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    entries_[head % kCapacity] = metrics;
+    head_.store(head + 1, std::memory_order_release);
+}
+
+int c_metrics_ring::copy_recent(frame_metrics* out, int max_count) const {
+    if (max_count <= 0)
+        return 0;
+
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const uint64_t available = head < kCapacity ? head : kCapacity;
+    const uint64_t count = available < static_cast<uint64_t>(max_count) ? available : static_cast<uint64_t>(max_count);
+    const uint64_t first = head - count;
+    for (uint64_t i = 0; i < count; i++)
+        out[i] = entries_[(first + i) % kCapacity];
+
+    // Anything the writer reached while we copied may be torn, including the slot of entry
+    // head_after it may be writing right now; keep the untouched tail.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t head_after = head_.load(std::memory_order_relaxed);
+    const uint64_t overwritten = head_after + 1 > kCapacity ? head_after + 1 - kCapacity : 0;
+    if (overwritten <= first)
+        return static_cast<int>(count);
+    const uint64_t drop = overwritten - first < count ? overwritten - first : count;
+    memmove(out, out + drop, static_cast<size_t>(count - drop) * sizeof(frame_metrics));
+    return static_cast<int>(count - drop);
+}
+
+void c_perf_overlay::add_callback_time(const char* name, float ms) {
+    frame_callback_ms_ += ms;
+    last_callback_ms_ = ms;
+    for (callback_timing& timing : callbacks_) {
+        if (timing.name != nullptr && timing.name != name && strcmp(timing.name, name) != 0)
+            continue;
+        timing.name = name;
+        timing.calls++;
+        timing.last_ms = ms;
+        timing.total_ms += ms;
+        if (ms > timing.max_ms)
+            timing.max_ms = ms;
+        return;
+    }
+}
+
+void c_perf_overlay::set_media_counts(int images, int videos, int cached_files) {
+    media_images_ = images;
+    media_videos_ = videos;
+    media_cached_files_ = cached_files;
+}
+
+void c_perf_overlay::record(frame_metrics metrics) {
+    metrics.callback_ms = frame_callback_ms_;
+    metrics.media_images = media_images_;
+    metrics.media_videos = media_videos_;
+    metrics.media_cached_files = media_cached_files_;
+    frame_callback_ms_ = 0.f;
+    ring_.push(metrics);
+}
+
+void c_perf_overlay::draw() {
+    if (ImGui::IsKeyChordPressed(kToggleChord))
+        visible_ = !visible_;
+    if (!visible_)
+        return;
+
+    ImGui::SetNextWindowSize(ImVec2(380, 0), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Performance##perf_overlay", &visible_, ImGuiWindowFlags_NoSavedSettings)) {
+        ImGui::End();
+        return;
+    }
+
+    const int count = ring_.copy_recent(history_, c_metrics_ring::kCapacity);
+    if (count == 0) {
+        ImGui::TextUnformatted("No frames recorded yet.");
+        ImGui::End();
+        return;
+    }
+
+    auto series = [&](auto member) {
+        for (int i = 0; i < count; i++)
+            plot_[i] = static_cast<float>(history_[i].*member);
+        return plot_;
+    };
+    auto summarize = [&](float& avg, float& peak) {
+        avg = 0.f;
+        peak = 0.f;
+        for (int i = 0; i < count; i++) {
+            avg += plot_[i];
+            if (plot_[i] > peak)
+                peak = plot_[i];
+        }
+        avg /= static_cast<float>(count);
+    };
+
+    const frame_metrics& last = history_[count - 1];
+    const float graph_width = ImGui::GetContentRegionAvail().x;
+    char caption[64];
+    float avg = 0.f;
+    float peak = 0.f;
+
+    series(&frame_metrics::frame_ms);
+    summarize(avg, peak);
+    snprintf(caption, sizeof(caption), "frame %.2f ms avg, %.2f max", avg, peak);
+    ImGui::PlotLines("##frame_ms", plot_, count, 0, caption, 0.f, FLT_MAX, ImVec2(graph_width, 60.f));
+
+    series(&frame_metrics::ui_ms);
+    summarize(avg, peak);
+    snprintf(caption, sizeof(caption), "ui %.2f ms avg", avg);
+    ImGui::PlotLines("##ui_ms", plot_, count, 0, caption, 0.f, FLT_MAX, ImVec2(graph_width, 36.f));
+
+    series(&frame_metrics::submit_ms);
+    summarize(avg, peak);
+    snprintf(caption, sizeof(caption), "submit %.2f ms avg", avg);
+    ImGui::PlotLines("##submit_ms", plot_, count, 0, caption, 0.f, FLT_MAX, ImVec2(graph_width, 36.f));
+
+    series(&frame_metrics::present_ms);
+    summarize(avg, peak);
+    snprintf(caption, sizeof(caption), "present %.2f ms avg", avg);
+    ImGui::PlotLines("##present_ms", plot_, count, 0, caption, 0.f, FLT_MAX, ImVec2(graph_width, 36.f));
+
+    ImGui::Text("Last frame: ui %.2f / submit %.2f / present %.2f ms", last.ui_ms, last.submit_ms, last.present_ms);
+    ImGui::Separator();
+
+    series(&frame_metrics::draw_calls);
+    snprintf(caption, sizeof(caption), "%d draw calls", last.draw_calls);
+    ImGui::PlotHistogram("##draw_calls", plot_, count, 0, caption, 0.f, FLT_MAX, ImVec2(graph_width, 36.f));
+    ImGui::Text("Vertices %d, indices %d", last.vertices, last.indices);
+    ImGui::Text("ImGui heap %.1f KiB live, %.1f KiB reserved",
+        last.heap_live_bytes / 1024.0, last.heap_reserved_bytes / 1024.0);
+    ImGui::Text("Font atlas %dx%d (%.1f KiB)", last.atlas_width, last.atlas_height,
+        last.atlas_width * last.atlas_height * 4 / 1024.0);
+    ImGui::Text("Media: %d images, %d videos, %d cached files", last.media_images, last.media_videos, last.media_cached_files);
+    ImGui::Separator();
+
+    series(&frame_metrics::callback_ms);
+    summarize(avg, peak);
+    snprintf(caption, sizeof(caption), "callbacks %.2f ms max", peak);
+    ImGui::PlotHistogram("##callback_ms", plot_, count, 0, caption, 0.f, FLT_MAX, ImVec2(graph_width, 36.f));
+    for (const callback_timing& timing : callbacks_) {
+        if (timing.name == nullptr)
+            break;
+        ImGui::Text("%s: %u calls, last %.2f ms, max %.2f ms", timing.name, timing.calls, timing.last_ms, timing.max_ms);
+    }
+
+    // Plain text so support can paste it into a ticket.
+    if (ImGui::Button("Copy summary")) {
+        ImGuiTextBuffer text;
+        series(&frame_metrics::frame_ms);
+        summarize(avg, peak);
+        text.appendf("frames %d, frame %.2f ms avg / %.2f ms max\n", count, avg, peak);
+        text.appendf("last: ui %.2f, submit %.2f, present %.2f ms\n", last.ui_ms, last.submit_ms, last.present_ms);
+        text.appendf("draw calls %d, vertices %d, indices %d\n", last.draw_calls, last.vertices, last.indices);
+        text.appendf("heap %llu live / %llu reserved bytes, atlas %dx%d\n",
+            static_cast<unsigned long long>(last.heap_live_bytes), static_cast<unsigned long long>(last.heap_reserved_bytes),
+            last.atlas_width, last.atlas_height);
+        text.appendf("media %d images, %d videos, %d cached files\n", last.media_images, last.media_videos, last.media_cached_files);
+        for (const callback_timing& timing : callbacks_) {
+            if (timing.name == nullptr)
+                break;
+            text.appendf("%s: %u calls, last %.2f ms, max %.2f ms\n", timing.name, timing.calls, timing.last_ms, timing.max_ms);
+        }
+        ImGui::SetClipboardText(text.c_str());
+    }
+
+    ImGui::End();
+}
@@ -0,0 +1,87 @@
+#ifndef PERF_OVERLAY_HPP
+#define PERF_OVERLAY_HPP
+
+#include <atomic>
+#include <cstdint>
+#include "../dep/imgui/imgui.h"
+
+struct frame_metrics {
+    float frame_ms = 0.f;       // start of this frame to the start of the previous one
+    float ui_ms = 0.f;          // NewFrame and window building
+    float submit_ms = 0.f;      // ImGui::Render, optimize and draw submission
+    float present_ms = 0.f;     // threaded: the render thread's submit + present
+    int draw_calls = 0;
+    int vertices = 0;
+    int indices = 0;
+    uint64_t heap_live_bytes = 0;
+    uint64_t heap_reserved_bytes = 0;
+    int atlas_width = 0;
+    int atlas_height = 0;
+    int media_images = 0;
+    int media_videos = 0;
+    int media_cached_files = 0;
+    float callback_ms = 0.f;    // time spent in host callbacks during the frame
+};
+
+// Single-producer ring of the last kCapacity frames. The writer publishes with a release
+// store; readers on any thread copy without blocking it and drop entries overwritten
+// while they copied.
+class c_metrics_ring {
+public:
+    static constexpr uint32_t kCapacity = 256;
+
+    void push(const frame_metrics& metrics);
+    // Oldest first; returns the number of entries written to out.
+    int copy_recent(frame_metrics* out, int max_count) const;
+    uint64_t total() const { return head_.load(std::memory_order_acquire); }
+
+private:
+    frame_metrics entries_[kCapacity];
+    std::atomic<uint64_t> head_{ 0 };
+};
+
+// Debug window with frame-time graphs and per-subsystem counters, toggled with
+// Ctrl+Shift+F12. Metrics are recorded every frame whether or not it is shown.
+class c_perf_overlay {
+public:
+    static constexpr ImGuiKeyChord kToggleChord = ImGuiMod_Ctrl | ImGuiMod_Shift | ImGuiKey_F12;
+    static constexpr int kMaxCallbacks = 8;
+
+    struct callback_timing {
+        const char* name = nullptr;     // string literal
+        uint32_t calls = 0;
+        float last_ms = 0.f;
+        float max_ms = 0.f;
+        double total_ms = 0.0;
+    };
+
+    void set_visible(bool visible) { visible_ = visible; }
+    bool visible() const { return visible_; }
+
+    // Fills in the callback and media fields before pushing.
+    void record(frame_metrics metrics);
+    const c_metrics_ring& ring() const { return ring_; }
+
+    // UI thread; summed into the next recorded frame.
+    void add_callback_time(const char* name, float ms);
+    const callback_timing* callbacks() const { return callbacks_; }
+    float last_callback_ms() const { return last_callback_ms_; }
+    void set_media_counts(int images, int videos, int cached_files);
+
+    // Checks the hotkey and draws the window if visible. Call between NewFrame and Render.
+    void draw();
+
+private:
+    c_metrics_ring ring_;
+    bool visible_ = false;
+    float frame_callback_ms_ = 0.f;
+    float last_callback_ms_ = 0.f;
+    int media_images_ = 0;
+    int media_videos_ = 0;
+    int media_cached_files_ = 0;
+    callback_timing callbacks_[kMaxCallbacks];
+    frame_metrics history_[c_metrics_ring::kCapacity];
+    float plot_[c_metrics_ring::kCapacity];
+};
+
+#endif // PERF_OVERLAY_HPP
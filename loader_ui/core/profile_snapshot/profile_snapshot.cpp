@@ -0,0 +1,153 @@
+#include "profile_snapshot.h"
+#include "../loader_ui/loader_ui.h"
+#include <windows.h>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+    constexpr char kMagic[4] = { 'L', 'U', 'P', 'S' };
+}
+
+bool c_profile_snapshot::write(const std::filesystem::path& path, const user_profile& profile) {
+    std::string strings;
+    auto add = [&](const std::string& value) {
+        text_ref ref{ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size()) };
+        strings += value;
+        return ref;
+    };
+
+    header head{};
+    memcpy(head.magic, kMagic, sizeof(kMagic));
+    head.version = kVersion;
+    head.username = add(profile.username);
+
+    std::vector<row> rows;
+    rows.reserve(profile.subscriptions.size());
+    for (const user_subscription* sub : profile.subscriptions) {
+        if (!sub)
+            continue;
+        row entry{};
+        entry.plan = add(sub->plan);
+        entry.expires_at = add(sub->expires_at);
+        entry.status = add(sub->status);
+        entry.plan_id = add(sub->plan_id);
+        entry.default_file_id = add(sub->default_file_id);
+        entry.image_mime = add(sub->product_image_mime);
+        entry.image_updated_at = add(sub->product_image_updated_at);
+        entry.video_mime = add(sub->product_video_mime);
+        entry.video_updated_at = add(sub->product_video_updated_at);
+        entry.video_path = add(sub->product_video_path);
+        entry.frozen = sub->frozen ? 1 : 0;
+        rows.push_back(entry);
+    }
+    head.row_count = static_cast<uint32_t>(rows.size());
+    head.string_bytes = static_cast<uint32_t>(strings.size());
+
+    std::filesystem::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out)
+            return false;
+        out.write(reinterpret_cast<const char*>(&head), sizeof(head));
+        out.write(reinterpret_cast<const char*>(rows.data()), static_cast<std::streamsize>(rows.size() * sizeof(row)));
+        out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+        if (!out)
+            return false;
+    }
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    return !error;
+}
+
+bool c_profile_snapshot::open(const std::filesystem::path& path) {
+    close();
+
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    file_ = file;
+
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(sizeof(header))) {
+        close();
+        return false;
+    }
+    mapping_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) {
+        close();
+        return false;
+    }
+    view_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!view_) {
+        close();
+        return false;
+    }
+
+    // Validate once so reads need no checks.
+    const uint64_t size = static_cast<uint64_t>(file_size.QuadPart);
+    header head;
+    memcpy(&head, view_, sizeof(head));
+    const uint64_t rows_end = sizeof(header) + static_cast<uint64_t>(head.row_count) * sizeof(row);
+    bool valid = memcmp(head.magic, kMagic, sizeof(kMagic)) == 0 && head.version == kVersion &&
+        rows_end + head.string_bytes <= size;
+    auto in_range = [&](const text_ref& ref) {
+        return static_cast<uint64_t>(ref.offset) + ref.length <= head.string_bytes;
+    };
+    valid = valid && in_range(head.username);
+    rows_ = reinterpret_cast<const row*>(view_ + sizeof(header));
+    for (uint32_t i = 0; valid && i < head.row_count; i++) {
+        const row& entry = rows_[i];
+        valid = in_range(entry.plan) && in_range(entry.expires_at) && in_range(entry.status) &&
+            in_range(entry.plan_id) && in_range(entry.default_file_id) && in_range(entry.image_mime) &&
+            in_range(entry.image_updated_at) && in_range(entry.video_mime) &&
+            in_range(entry.video_updated_at) && in_range(entry.video_path);
+    }
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    strings_ = reinterpret_cast<const char*>(view_ + rows_end);
+    row_count_ = head.row_count;
+    return true;
+}
+
+void c_profile_snapshot::close() {
+    if (view_)
+        UnmapViewOfFile(view_);
+    if (mapping_)
+        CloseHandle(static_cast<HANDLE>(mapping_));
+    if (file_)
+        CloseHandle(static_cast<HANDLE>(file_));
+    view_ = nullptr;
+    mapping_ = nullptr;
+    file_ = nullptr;
+    rows_ = nullptr;
+    strings_ = nullptr;
+    row_count_ = 0;
+}
+
+std::string_view c_profile_snapshot::username() const {
+    header head;
+    memcpy(&head, view_, sizeof(head));
+    return text(head.username);
+}
+
+void c_profile_snapshot::read(size_t index, user_subscription& out) const {
+    const row& entry = rows_[index];
+    out.plan = text(entry.plan);
+    out.expires_at = text(entry.expires_at);
+    out.status = text(entry.status);
+    out.plan_id = text(entry.plan_id);
+    out.default_file_id = text(entry.default_file_id);
+    out.product_image_mime = text(entry.image_mime);
+    out.product_image_updated_at = text(entry.image_updated_at);
+    out.product_video_mime = text(entry.video_mime);
+    out.product_video_updated_at = text(entry.video_updated_at);
+    out.product_video_path = text(entry.video_path);
+    out.frozen = entry.frozen != 0;
+}
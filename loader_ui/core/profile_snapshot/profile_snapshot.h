@@ -0,0 +1,78 @@
+#ifndef PROFILE_SNAPSHOT_HPP
+#define PROFILE_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+struct user_profile;
+struct user_subscription;
+
+// Last known product list on disk, so the next launch can draw it before the host's login
+// round-trip completes. Layout: header, fixed-size rows, then one string blob the rows
+// point into. Only display fields and media cache keys are kept, never media bytes.
+//
+// open() maps the file read-only and validates every offset once; reads are then plain
+// loads from the mapping.
+class c_profile_snapshot {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    c_profile_snapshot() = default;
+    c_profile_snapshot(const c_profile_snapshot&) = delete;
+    c_profile_snapshot& operator=(const c_profile_snapshot&) = delete;
+    ~c_profile_snapshot() { close(); }
+
+    // Writes to a temporary file and renames it over `path`.
+    static bool write(const std::filesystem::path& path, const user_profile& profile);
+
+    bool open(const std::filesystem::path& path);
+    void close();
+    bool is_open() const { return view_ != nullptr; }
+
+    size_t size() const { return row_count_; }
+    std::string_view username() const;
+    // Fills the display fields and media keys of row `index`; media bytes stay empty.
+    void read(size_t index, user_subscription& out) const;
+
+private:
+    struct text_ref {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct header {
+        char magic[4];
+        uint32_t version;
+        uint32_t row_count;
+        uint32_t string_bytes;
+        text_ref username;
+    };
+
+    struct row {
+        text_ref plan;
+        text_ref expires_at;
+        text_ref status;
+        text_ref plan_id;
+        text_ref default_file_id;
+        text_ref image_mime;
+        text_ref image_updated_at;
+        text_ref video_mime;
+        text_ref video_updated_at;
+        text_ref video_path;
+        uint8_t frozen;
+        uint8_t reserved[3];
+    };
+
+    std::string_view text(const text_ref& ref) const { return std::string_view(strings_ + ref.offset, ref.length); }
+
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+    const uint8_t* view_ = nullptr;
+    const row* rows_ = nullptr;
+    const char* strings_ = nullptr;
+    size_t row_count_ = 0;
+};
+
+#endif // PROFILE_SNAPSHOT_HPP
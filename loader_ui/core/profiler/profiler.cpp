@@ -0,0 +1,171 @@
+#include "profiler.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> c_profiler::enabled_{ false };
+
+namespace {
+    struct trace_event {
+        const char* name;
+        const char* category;
+        uint64_t begin_us;
+        uint64_t end_us;
+    };
+
+    // Written by its owning thread only. Slots [head - kEventsPerThread, head) are valid,
+    // minus anything before start (moved forward by clear()).
+    struct thread_buffer {
+        uint32_t tid = 0;
+        std::string name;   // guarded by the registry mutex
+        std::unique_ptr<trace_event[]> events{ new trace_event[c_profiler::kEventsPerThread] };
+        std::atomic<uint64_t> head{ 0 };
+        std::atomic<uint64_t> start{ 0 };
+    };
+
+    // Buffers outlive their threads so a trace still shows threads that have exited.
+    struct registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<thread_buffer>> buffers;
+        uint32_t next_tid = 1;
+    };
+
+    registry& get_registry() {
+        static registry instance;
+        return instance;
+    }
+
+    thread_local std::shared_ptr<thread_buffer> t_buffer;
+
+    thread_buffer& local_buffer() {
+        if (!t_buffer) {
+            auto buffer = std::make_shared<thread_buffer>();
+            registry& reg = get_registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            buffer->tid = reg.next_tid++;
+            reg.buffers.push_back(buffer);
+            t_buffer = std::move(buffer);
+        }
+        return *t_buffer;
+    }
+
+    const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+    void append_escaped(std::string& out, const char* text) {
+        for (const char* p = text; *p; p++) {
+            const unsigned char c = static_cast<unsigned char>(*p);
+            if (c == '"' || c == '\\') {
+                out.push_back('\\');
+                out.push_back(static_cast<char>(c));
+            }
+            else if (c < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            }
+            else {
+                out.push_back(static_cast<char>(c));
+            }
+        }
+    }
+
+    // Copies the live part of a ring. Slots the writer may have overwritten during the
+    // copy are dropped afterwards.
+    void snapshot(const thread_buffer& buffer, std::vector<trace_event>& out) {
+        out.clear();
+        const uint64_t head = buffer.head.load(std::memory_order_acquire);
+        const uint64_t start = buffer.start.load(std::memory_order_relaxed);
+        uint64_t first = head > c_profiler::kEventsPerThread ? head - c_profiler::kEventsPerThread : 0;
+        if (first < start)
+            first = start;
+        for (uint64_t i = first; i < head; i++)
+            out.push_back(buffer.events[i % c_profiler::kEventsPerThread]);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // The writer may already be filling slot head_after, which holds event
+        // head_after - kEventsPerThread: events below head_after + 1 - kEventsPerThread are suspect.
+        const uint64_t head_after = buffer.head.load(std::memory_order_relaxed);
+        if (head_after + 1 > c_profiler::kEventsPerThread) {
+            const uint64_t overwritten = head_after + 1 - c_profiler::kEventsPerThread;
+            if (overwritten > first) {
+                const uint64_t drop = overwritten - first < out.size() ? overwritten - first : out.size();
+                out.erase(out.begin(), out.begin() + static_cast<ptrdiff_t>(drop));
+            }
+        }
+    }
+}
+
+void c_profiler::set_enabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t c_profiler::now_us() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - g_epoch).count());
+}
+
+void c_profiler::record(const char* name, const char* category, uint64_t begin_us, uint64_t end_us) {
+    thread_buffer& buffer = local_buffer();
+    const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % kEventsPerThread] = trace_event{ name, category, begin_us, end_us };
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void c_profiler::set_thread_name(const char* name) {
+    thread_buffer& buffer = local_buffer();
+    std::lock_guard<std::mutex> lock(get_registry().mutex);
+    buffer.name = name ? name : "";
+}
+
+std::string c_profiler::write_chrome_trace() {
+    registry& reg = get_registry();
+    std::vector<std::shared_ptr<thread_buffer>> buffers;
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffers = reg.buffers;
+        for (const auto& buffer : buffers)
+            names.push_back(buffer->name);
+    }
+
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    char number[96];
+    std::vector<trace_event> events;
+    for (size_t i = 0; i < buffers.size(); i++) {
+        const thread_buffer& buffer = *buffers[i];
+        if (!names[i].empty()) {
+            out += first ? "" : ",";
+            first = false;
+            snprintf(number, sizeof(number), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", buffer.tid);
+            out += number;
+            append_escaped(out, names[i].c_str());
+            out += "\"}}";
+        }
+
+        snapshot(buffer, events);
+        for (const trace_event& e : events) {
+            out += first ? "{\"name\":\"" : ",{\"name\":\"";
+            first = false;
+            append_escaped(out, e.name);
+            out += "\",\"cat\":\"";
+            append_escaped(out, e.category);
+            snprintf(number, sizeof(number), "\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":%u}",
+                static_cast<unsigned long long>(e.begin_us),
+                static_cast<unsigned long long>(e.end_us - e.begin_us), buffer.tid);
+            out += number;
+        }
+    }
+    out += "],\"displayTimeUnit\":\"ms\"}";
+    return out;
+}
+
+void c_profiler::clear() {
+    registry& reg = get_registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer : reg.buffers)
+        buffer->start.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
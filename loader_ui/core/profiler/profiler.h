@@ -0,0 +1,66 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Chrome trace-event profiler. Every thread records complete events into its own ring
+// of kEventsPerThread entries, published with a release store and read without stopping
+// the writer; the registry lock is only taken the first time a thread records. When a
+// ring wraps, the oldest events are dropped. While disabled a scope costs one relaxed load.
+//
+// Names and categories are stored by pointer and must be string literals.
+class c_profiler {
+public:
+    static constexpr uint32_t kEventsPerThread = 1u << 14;
+
+    static void set_enabled(bool enabled);
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    static uint64_t now_us();
+
+    static void record(const char* name, const char* category, uint64_t begin_us, uint64_t end_us);
+    // Shown as the calling thread's name in the trace viewer; copied.
+    static void set_thread_name(const char* name);
+
+    // JSON object format, loadable by chrome://tracing and Perfetto.
+    static std::string write_chrome_trace();
+    // Drops everything recorded so far.
+    static void clear();
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+class c_profile_scope {
+public:
+    c_profile_scope(const char* name, const char* category)
+        : name_(name), category_(category), active_(c_profiler::enabled()) {
+        if (active_)
+            begin_us_ = c_profiler::now_us();
+    }
+    ~c_profile_scope() {
+        if (active_)
+            c_profiler::record(name_, category_, begin_us_, c_profiler::now_us());
+    }
+
+    c_profile_scope(const c_profile_scope&) = delete;
+    c_profile_scope& operator=(const c_profile_scope&) = delete;
+
+private:
+    const char* name_;
+    const char* category_;
+    bool active_;
+    uint64_t begin_us_ = 0;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifndef LOADER_UI_DISABLE_PROFILER
+#define PROFILE_SCOPE(name, category) c_profile_scope PROFILE_CONCAT(profile_scope_, __LINE__)(name, category)
+#else
+#define PROFILE_SCOPE(name, category) ((void)0)
+#endif
+
+#endif // PROFILER_HPP
@@ -0,0 +1,197 @@
+#include "render_thread.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <d3d11.h>
+#include "../profiler/profiler.h"
+
+namespace {
+    template <typename T>
+    void copy_vector(ImVector<T>& dst, const ImVector<T>& src) {
+        dst.resize(src.Size);
+        if (src.Size > 0)
+            memcpy(dst.Data, src.Data, static_cast<size_t>(src.Size) * sizeof(T));
+    }
+}
+
+c_draw_snapshot::~c_draw_snapshot() {
+    reset();
+    // Lists still alive here belong to a context that is already gone.
+    lists_.clear();
+}
+
+void c_draw_snapshot::reset() {
+    for (ImTextureID texture : textures_)
+        reinterpret_cast<IUnknown*>(texture)->Release();
+    textures_.clear();
+    data_.Valid = false;
+    data_.CmdListsCount = 0;
+    data_.CmdLists.resize(0);
+    data_.TotalVtxCount = 0;
+    data_.TotalIdxCount = 0;
+}
+
+void c_draw_snapshot::release() {
+    reset();
+    for (ImDrawList* list : lists_)
+        IM_DELETE(list);
+    lists_.clear();
+    data_.CmdLists.clear();
+}
+
+void c_draw_snapshot::capture(const ImDrawData* src) {
+    reset();
+    if (!src || !src->Valid)
+        return;
+
+    while (lists_.size() < static_cast<size_t>(src->CmdListsCount))
+        lists_.push_back(IM_NEW(ImDrawList)(nullptr));
+
+    data_.CmdLists.resize(src->CmdListsCount);
+    for (int n = 0; n < src->CmdListsCount; n++) {
+        const ImDrawList* from = src->CmdLists[n];
+        ImDrawList* to = lists_[n];
+        copy_vector(to->CmdBuffer, from->CmdBuffer);
+        copy_vector(to->IdxBuffer, from->IdxBuffer);
+        copy_vector(to->VtxBuffer, from->VtxBuffer);
+        to->Flags = from->Flags;
+        data_.CmdLists[n] = to;
+
+        for (const ImDrawCmd& cmd : from->CmdBuffer) {
+            ImTextureID texture = cmd.GetTexID();
+            if (cmd.UserCallback != nullptr || texture == nullptr)
+                continue;
+            if (std::find(textures_.begin(), textures_.end(), texture) != textures_.end())
+                continue;
+            reinterpret_cast<IUnknown*>(texture)->AddRef();
+            textures_.push_back(texture);
+        }
+    }
+
+    data_.Valid = true;
+    data_.CmdListsCount = src->CmdListsCount;
+    data_.TotalVtxCount = src->TotalVtxCount;
+    data_.TotalIdxCount = src->TotalIdxCount;
+    data_.DisplayPos = src->DisplayPos;
+    data_.DisplaySize = src->DisplaySize;
+    data_.FramebufferScale = src->FramebufferScale;
+    // OwnerViewport is left null: UpdatePlatformWindows may destroy the viewport while the
+    // snapshot is in flight. The main list renders into the main upload rings and secondary
+    // viewports through the renderer data bound by value at publish time.
+}
+
+render_viewport& render_frame::add_viewport() {
+    if (viewport_count == static_cast<int>(viewports.size()))
+        viewports.push_back(std::make_unique<render_viewport>());
+    render_viewport& viewport = *viewports[viewport_count++];
+    viewport.viewport_id = 0;
+    viewport.renderer_user_data = nullptr;
+    viewport.clear = true;
+    viewport.damage_full = true;
+    viewport.damage_count = 0;
+    return viewport;
+}
+
+c_render_thread::~c_render_thread() {
+    stop();
+}
+
+bool c_render_thread::start(submit_fn submit) {
+    if (running())
+        return true;
+
+    submit_ = std::move(submit);
+    stop_requested_ = false;
+    pending_slot_ = -1;
+    write_slot_ = 0;
+    try {
+        thread_ = std::thread(&c_render_thread::run, this);
+    }
+    catch (...) {
+        return false;
+    }
+    return true;
+}
+
+void c_render_thread::stop() {
+    if (!running())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    stop_requested_ = false;
+    pending_slot_ = -1;
+
+    for (render_frame& frame : slots_) {
+        frame.main.release();
+        for (auto& viewport : frame.viewports)
+            viewport->draw.release();
+        frame.viewports.clear();
+        frame.viewport_count = 0;
+    }
+}
+
+render_frame& c_render_thread::acquire() {
+    // The other slot may be in flight; this one finished at the latest when it was last
+    // waited for, so its texture references can go.
+    render_frame& frame = slots_[write_slot_];
+    frame.main.reset();
+    for (int i = 0; i < frame.viewport_count; i++)
+        frame.viewports[i]->draw.reset();
+    frame.viewport_count = 0;
+    frame.input_stamps.clear();
+    return frame;
+}
+
+int c_render_thread::pending_frames() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_slot_ >= 0 ? 1 : 0;
+}
+
+void c_render_thread::wait_idle() {
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return pending_slot_ < 0; });
+    }
+    stats_.last_wait_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    stats_.last_submit_ms = last_submit_ms_.load(std::memory_order_relaxed);
+    stats_.frames_submitted = frames_submitted_.load(std::memory_order_relaxed);
+}
+
+void c_render_thread::publish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        IM_ASSERT(pending_slot_ < 0 && "wait_idle() must run before publish()");
+        pending_slot_ = write_slot_;
+    }
+    write_slot_ ^= 1;
+    cv_.notify_all();
+}
+
+void c_render_thread::run() {
+    c_profiler::set_thread_name("render");
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return stop_requested_ || pending_slot_ >= 0; });
+        if (pending_slot_ < 0)
+            return;
+
+        render_frame& frame = slots_[pending_slot_];
+        lock.unlock();
+
+        const auto start = std::chrono::steady_clock::now();
+        submit_(frame);
+        last_submit_ms_.store(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+        frames_submitted_.fetch_add(1, std::memory_order_relaxed);
+
+        lock.lock();
+        pending_slot_ = -1;
+        lock.unlock();
+        cv_.notify_all();
+    }
+}
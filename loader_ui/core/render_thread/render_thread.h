@@ -0,0 +1,113 @@
+#ifndef RENDER_THREAD_HPP
+#define RENDER_THREAD_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../dep/imgui/imgui.h"
+#include "../damage_tracker/damage_tracker.h"
+
+struct render_thread_stats {
+    uint64_t frames_submitted = 0;
+    double last_submit_ms = 0.0;    // render thread: submission and present of the last frame
+    double last_wait_ms = 0.0;      // UI thread: time blocked on the previous frame in wait_idle()
+};
+
+// Deep copy of one ImDrawData. Vertex/index/command buffers are copied into lists
+// owned by the snapshot, and every texture it references is AddRef'd (texture ids are
+// ID3D11ShaderResourceView*) until the next capture() or release(), so the UI thread
+// may free its own copies while the render thread still draws.
+//
+// Buffers keep their capacity between captures; steady-state frames do not allocate.
+class c_draw_snapshot {
+public:
+    c_draw_snapshot() = default;
+    ~c_draw_snapshot();
+
+    c_draw_snapshot(const c_draw_snapshot&) = delete;
+    c_draw_snapshot& operator=(const c_draw_snapshot&) = delete;
+
+    void capture(const ImDrawData* src);
+    // Drops the texture references; keeps the buffers.
+    void reset();
+    // Frees everything. Must run while the ImGui context that allocated the lists is alive.
+    void release();
+
+    ImDrawData* draw_data() { return &data_; }
+    bool empty() const { return data_.CmdListsCount == 0; }
+
+private:
+    ImDrawData data_;
+    std::vector<ImDrawList*> lists_;
+    std::vector<ImTextureID> textures_;
+};
+
+struct render_viewport {
+    ImGuiID viewport_id = 0;
+    void* renderer_user_data = nullptr;
+    bool clear = true;
+    bool damage_full = true;
+    int damage_count = 0;
+    ImVec4 damage[c_damage_tracker::kMaxRects];
+    c_draw_snapshot draw;
+};
+
+// Everything the render thread needs for one frame, captured on the UI thread.
+struct render_frame {
+    c_draw_snapshot main;
+    std::vector<std::unique_ptr<render_viewport>> viewports;   // first viewport_count entries are in use
+    int viewport_count = 0;
+    std::vector<uint64_t> input_stamps;     // arrival times of the input this frame first reflects
+
+    render_viewport& add_viewport();
+};
+
+// Double-buffered hand-off between the UI thread and one render thread. Per frame the
+// UI thread acquires the free slot and fills it while the render thread may still be
+// submitting the previous one, waits for it in wait_idle() before touching anything the
+// render thread uses (swap chains: UpdatePlatformWindows), then publishes.
+class c_render_thread {
+public:
+    using submit_fn = std::function<void(render_frame&)>;
+
+    c_render_thread() = default;
+    ~c_render_thread();
+
+    c_render_thread(const c_render_thread&) = delete;
+    c_render_thread& operator=(const c_render_thread&) = delete;
+
+    bool start(submit_fn submit);
+    // Finishes the in-flight frame, joins and frees both slots.
+    void stop();
+    bool running() const { return thread_.joinable(); }
+
+    render_frame& acquire();
+    void wait_idle();
+    void publish();
+
+    const render_thread_stats& stats() const { return stats_; }
+    // Published frames the render thread has not finished yet (0 or 1).
+    int pending_frames();
+
+private:
+    void run();
+
+    submit_fn submit_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    render_frame slots_[2];
+    int write_slot_ = 0;
+    int pending_slot_ = -1;     // published, not yet finished by the render thread
+    bool stop_requested_ = false;
+    std::atomic<double> last_submit_ms_{ 0.0 };
+    std::atomic<uint64_t> frames_submitted_{ 0 };
+    render_thread_stats stats_{};
+};
+
+#endif // RENDER_THREAD_HPP
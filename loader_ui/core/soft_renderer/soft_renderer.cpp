@@ -0,0 +1,564 @@
+#include "soft_renderer.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFT_RENDERER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+    inline float unpack_channel(uint32_t color, int shift) {
+        return static_cast<float>((color >> shift) & 0xFF) * (1.0f / 255.0f);
+    }
+
+    inline uint32_t pack_channel(float value, int shift) {
+        value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+        return static_cast<uint32_t>(value * 255.0f + 0.5f) << shift;
+    }
+
+    inline int wrap(int coord, int size) {
+        coord %= size;
+        return coord < 0 ? coord + size : coord;
+    }
+
+    // D3D11_FILTER_MIN_MAG_MIP_LINEAR with D3D11_TEXTURE_ADDRESS_WRAP, as the DX11 backend's sampler.
+    void sample_bilinear(const uint32_t* texels, int width, int height, float u, float v, float out[4]) {
+        const float tu = u * static_cast<float>(width) - 0.5f;
+        const float tv = v * static_cast<float>(height) - 0.5f;
+        const float fu = std::floor(tu);
+        const float fv = std::floor(tv);
+        const float wx = tu - fu;
+        const float wy = tv - fv;
+
+        const int x0 = wrap(static_cast<int>(fu), width);
+        const int y0 = wrap(static_cast<int>(fv), height);
+        const int x1 = x0 + 1 == width ? 0 : x0 + 1;
+        const int y1 = y0 + 1 == height ? 0 : y0 + 1;
+
+        const uint32_t c00 = texels[y0 * width + x0];
+        const uint32_t c10 = texels[y0 * width + x1];
+        const uint32_t c01 = texels[y1 * width + x0];
+        const uint32_t c11 = texels[y1 * width + x1];
+
+        for (int i = 0; i < 4; i++) {
+            const int shift = i * 8;
+            const float top = unpack_channel(c00, shift) + (unpack_channel(c10, shift) - unpack_channel(c00, shift)) * wx;
+            const float bottom = unpack_channel(c01, shift) + (unpack_channel(c11, shift) - unpack_channel(c01, shift)) * wx;
+            out[i] = top + (bottom - top) * wy;
+        }
+    }
+}
+
+c_soft_renderer::c_soft_renderer(int thread_count) {
+    if (thread_count <= 0) {
+        const unsigned int hardware = std::thread::hardware_concurrency();
+        thread_count = hardware > 1 ? static_cast<int>(hardware) - 1 : 0;
+    }
+    requested_threads_ = thread_count;
+}
+
+c_soft_renderer::~c_soft_renderer() {
+    stop_workers();
+}
+
+void c_soft_renderer::start_workers() {
+    if (!workers_.empty() || requested_threads_ <= 0) {
+        return;
+    }
+
+    stopping_ = false;
+    workers_.reserve(requested_threads_);
+    for (int i = 0; i < requested_threads_; i++) {
+        workers_.emplace_back(&c_soft_renderer::worker_main, this);
+    }
+}
+
+void c_soft_renderer::stop_workers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+}
+
+void c_soft_renderer::worker_main() {
+    uint64_t seen_generation = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+
+        drain_tiles();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busy_workers_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+void c_soft_renderer::drain_tiles() {
+    const int tile_count = tiles_x_ * tiles_y_;
+    for (;;) {
+        const int tile = next_tile_.fetch_add(1, std::memory_order_relaxed);
+        if (tile >= tile_count) {
+            return;
+        }
+        raster_tile(tile);
+    }
+}
+
+ImTextureID c_soft_renderer::create_texture(const unsigned char* rgba, int width, int height) {
+    if (!rgba || width <= 0 || height <= 0) {
+        return nullptr;
+    }
+
+    auto tex = std::make_unique<texture>();
+    tex->width = width;
+    tex->height = height;
+    tex->texels.resize(static_cast<size_t>(width) * height);
+    memcpy(tex->texels.data(), rgba, tex->texels.size() * sizeof(uint32_t));
+
+    textures_.push_back(std::move(tex));
+    return static_cast<ImTextureID>(textures_.back().get());
+}
+
+void c_soft_renderer::destroy_texture(ImTextureID id) {
+    textures_.erase(std::remove_if(textures_.begin(), textures_.end(),
+        [id](const std::unique_ptr<texture>& tex) { return tex.get() == id; }), textures_.end());
+}
+
+const c_soft_renderer::texture* c_soft_renderer::find_texture(ImTextureID id) const {
+    // Ids we did not hand out (e.g. D3D views loaded elsewhere) sample as opaque white.
+    for (const auto& tex : textures_) {
+        if (tex.get() == id) {
+            return tex.get();
+        }
+    }
+    return nullptr;
+}
+
+void c_soft_renderer::setup_edges(const float px[3], const float py[3], triangle& tri) {
+    // Edge i runs from vertex i to vertex i + 1 and weights the vertex opposite to it.
+    for (int i = 0; i < 3; i++) {
+        const int j = (i + 1) % 3;
+        const float dx = px[j] - px[i];
+        const float dy = py[j] - py[i];
+        tri.edge_a[i] = -dy;
+        tri.edge_b[i] = dx;
+        tri.edge_c[i] = dy * px[i] - dx * py[i];
+        tri.top_left[i] = (dy < 0.0f || (dy == 0.0f && dx > 0.0f)) ? 0xFFFFFFFFu : 0u;
+    }
+}
+
+void c_soft_renderer::setup_triangle(const ImDrawVert& v0, const ImDrawVert& v1, const ImDrawVert& v2,
+    const ImVec2& offset, const ImVec2& scale, const int scissor[4], const texture* tex) {
+    const ImDrawVert* verts[3] = { &v0, &v1, &v2 };
+    float px[3];
+    float py[3];
+    for (int i = 0; i < 3; i++) {
+        px[i] = (verts[i]->pos.x - offset.x) * scale.x;
+        py[i] = (verts[i]->pos.y - offset.y) * scale.y;
+    }
+
+    float area = (px[1] - px[0]) * (py[2] - py[0]) - (py[1] - py[0]) * (px[2] - px[0]);
+    if (area == 0.0f) {
+        return;
+    }
+    if (area < 0.0f) {
+        // The backend draws with culling off; normalize winding so inside is E >= 0.
+        std::swap(verts[1], verts[2]);
+        std::swap(px[1], px[2]);
+        std::swap(py[1], py[2]);
+        area = -area;
+    }
+
+    const float min_xf = std::min({ px[0], px[1], px[2] });
+    const float max_xf = std::max({ px[0], px[1], px[2] });
+    const float min_yf = std::min({ py[0], py[1], py[2] });
+    const float max_yf = std::max({ py[0], py[1], py[2] });
+
+    triangle tri;
+    tri.min_x = std::max(scissor[0], static_cast<int>(std::ceil(min_xf - 0.5f)));
+    tri.min_y = std::max(scissor[1], static_cast<int>(std::ceil(min_yf - 0.5f)));
+    tri.max_x = std::min(scissor[2], static_cast<int>(std::floor(max_xf - 0.5f)) + 1);
+    tri.max_y = std::min(scissor[3], static_cast<int>(std::floor(max_yf - 0.5f)) + 1);
+    if (tri.min_x >= tri.max_x || tri.min_y >= tri.max_y) {
+        return;
+    }
+
+    setup_edges(px, py, tri);
+
+    float attributes[3][6];
+    for (int i = 0; i < 3; i++) {
+        attributes[i][0] = verts[i]->uv.x;
+        attributes[i][1] = verts[i]->uv.y;
+        for (int c = 0; c < 4; c++) {
+            attributes[i][2 + c] = unpack_channel(verts[i]->col, c * 8);
+        }
+    }
+
+    const float inv_area = 1.0f / area;
+    for (int k = 0; k < 6; k++) {
+        // Vertex 0 is weighted by edge 1, vertex 1 by edge 2, vertex 2 by edge 0.
+        const float a0 = attributes[0][k];
+        const float a1 = attributes[1][k];
+        const float a2 = attributes[2][k];
+        tri.plane[k][0] = (tri.edge_a[1] * a0 + tri.edge_a[2] * a1 + tri.edge_a[0] * a2) * inv_area;
+        tri.plane[k][1] = (tri.edge_b[1] * a0 + tri.edge_b[2] * a1 + tri.edge_b[0] * a2) * inv_area;
+        tri.plane[k][2] = (tri.edge_c[1] * a0 + tri.edge_c[2] * a1 + tri.edge_c[0] * a2) * inv_area;
+    }
+
+    tri.tex = tex;
+    tri.constant_uv = verts[0]->uv.x == verts[1]->uv.x && verts[0]->uv.x == verts[2]->uv.x
+        && verts[0]->uv.y == verts[1]->uv.y && verts[0]->uv.y == verts[2]->uv.y;
+    if (!tex) {
+        tri.constant_uv = true;
+        tri.texel[0] = tri.texel[1] = tri.texel[2] = tri.texel[3] = 1.0f;
+    }
+    else if (tri.constant_uv) {
+        // Solid fills all sample the atlas white pixel; do it once per triangle.
+        sample_bilinear(tex->texels.data(), tex->width, tex->height, verts[0]->uv.x, verts[0]->uv.y, tri.texel);
+    }
+
+    const uint32_t index = static_cast<uint32_t>(triangles_.size());
+    triangles_.push_back(tri);
+    stats_.triangles++;
+
+    const int tile_x0 = tri.min_x / kTileSize;
+    const int tile_y0 = tri.min_y / kTileSize;
+    const int tile_x1 = (tri.max_x - 1) / kTileSize;
+    const int tile_y1 = (tri.max_y - 1) / kTileSize;
+    for (int ty = tile_y0; ty <= tile_y1; ty++) {
+        for (int tx = tile_x0; tx <= tile_x1; tx++) {
+            const damage_rect& dirty = tile_dirty_[ty * tiles_x_ + tx];
+            if (dirty.x0 >= tri.max_x || dirty.x1 <= tri.min_x || dirty.y0 >= tri.max_y || dirty.y1 <= tri.min_y) {
+                continue;
+            }
+            bins_[ty * tiles_x_ + tx].push_back(index);
+            stats_.binned++;
+        }
+    }
+}
+
+void c_soft_renderer::render(const ImDrawData* draw_data, const damage_rect* rects, int rect_count) {
+    const auto start = std::chrono::steady_clock::now();
+    stats_.triangles = 0;
+    stats_.binned = 0;
+    stats_.dirty_tiles = 0;
+    stats_.dirty_pixels = 0;
+
+    const ImVec2 scale = draw_data ? draw_data->FramebufferScale : ImVec2(1.0f, 1.0f);
+    const int width = draw_data ? static_cast<int>(draw_data->DisplaySize.x * scale.x) : 0;
+    const int height = draw_data ? static_cast<int>(draw_data->DisplaySize.y * scale.y) : 0;
+    if (width <= 0 || height <= 0) {
+        width_ = height_ = 0;
+        framebuffer_.clear();
+        stats_.frame_ms = 0.0;
+        return;
+    }
+
+    if (width != width_ || height != height_) {
+        width_ = width;
+        height_ = height;
+        framebuffer_.assign(static_cast<size_t>(width) * height, 0u);
+        tiles_x_ = (width + kTileSize - 1) / kTileSize;
+        tiles_y_ = (height + kTileSize - 1) / kTileSize;
+        bins_.resize(static_cast<size_t>(tiles_x_) * tiles_y_);
+        tile_dirty_.resize(bins_.size());
+        rect_count = -1;    // nothing retained at this size
+    }
+    for (auto& bin : bins_) {
+        bin.clear();
+    }
+    triangles_.clear();
+
+    // Per tile, the bounds of the damage inside it; empty tiles keep last frame's pixels.
+    for (int tile = 0; tile < tiles_x_ * tiles_y_; tile++) {
+        damage_rect& dirty = tile_dirty_[tile];
+        const int tile_x0 = (tile % tiles_x_) * kTileSize;
+        const int tile_y0 = (tile / tiles_x_) * kTileSize;
+        const damage_rect bounds = { tile_x0, tile_y0, std::min(tile_x0 + kTileSize, width), std::min(tile_y0 + kTileSize, height) };
+        if (rect_count < 0 || !rects) {
+            dirty = bounds;
+            continue;
+        }
+
+        dirty = damage_rect{ INT_MAX, INT_MAX, INT_MIN, INT_MIN };
+        for (int i = 0; i < rect_count; i++) {
+            const damage_rect clipped = {
+                std::max(bounds.x0, rects[i].x0), std::max(bounds.y0, rects[i].y0),
+                std::min(bounds.x1, rects[i].x1), std::min(bounds.y1, rects[i].y1)
+            };
+            if (clipped.x0 >= clipped.x1 || clipped.y0 >= clipped.y1) {
+                continue;
+            }
+            dirty.x0 = std::min(dirty.x0, clipped.x0);
+            dirty.y0 = std::min(dirty.y0, clipped.y0);
+            dirty.x1 = std::max(dirty.x1, clipped.x1);
+            dirty.y1 = std::max(dirty.y1, clipped.y1);
+        }
+        if (dirty.x0 >= dirty.x1) {
+            dirty = damage_rect{};
+        }
+    }
+    for (const damage_rect& dirty : tile_dirty_) {
+        if (dirty.x0 < dirty.x1 && dirty.y0 < dirty.y1) {
+            stats_.dirty_tiles++;
+            stats_.dirty_pixels += static_cast<int64_t>(dirty.x1 - dirty.x0) * (dirty.y1 - dirty.y0);
+        }
+    }
+
+    const ImVec2 clip_off = draw_data->DisplayPos;
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        for (const ImDrawCmd& cmd : cmd_list->CmdBuffer) {
+            // Callbacks expect the D3D pipeline; ImDrawCallback_ResetRenderState has nothing to reset here.
+            if (cmd.UserCallback != nullptr) {
+                continue;
+            }
+
+            const ImVec2 clip_min((cmd.ClipRect.x - clip_off.x) * scale.x, (cmd.ClipRect.y - clip_off.y) * scale.y);
+            const ImVec2 clip_max((cmd.ClipRect.z - clip_off.x) * scale.x, (cmd.ClipRect.w - clip_off.y) * scale.y);
+            if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y) {
+                continue;
+            }
+
+            // Same truncation as the backend's D3D11_RECT.
+            const int scissor[4] = {
+                std::max(0, static_cast<int>(clip_min.x)),
+                std::max(0, static_cast<int>(clip_min.y)),
+                std::min(width, static_cast<int>(clip_max.x)),
+                std::min(height, static_cast<int>(clip_max.y))
+            };
+            if (scissor[0] >= scissor[2] || scissor[1] >= scissor[3]) {
+                continue;
+            }
+
+            const texture* tex = find_texture(cmd.GetTexID());
+            const ImDrawIdx* indices = cmd_list->IdxBuffer.Data + cmd.IdxOffset;
+            const ImDrawVert* vertices = cmd_list->VtxBuffer.Data + cmd.VtxOffset;
+            for (unsigned int i = 0; i + 2 < cmd.ElemCount; i += 3) {
+                setup_triangle(vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]],
+                    clip_off, scale, scissor, tex);
+            }
+        }
+    }
+
+    start_workers();
+    next_tile_.store(0, std::memory_order_relaxed);
+    if (!workers_.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_workers_ = static_cast<int>(workers_.size());
+            generation_++;
+        }
+        work_cv_.notify_all();
+    }
+
+    drain_tiles();
+
+    if (!workers_.empty()) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [&] { return busy_workers_ == 0; });
+    }
+
+    stats_.tiles = tiles_x_ * tiles_y_;
+    stats_.threads = static_cast<int>(workers_.size()) + 1;
+    stats_.width = width_;
+    stats_.height = height_;
+    stats_.frame_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Both loops evaluate a * cx + b * cy + c per pixel, in that order, rather than stepping
+// the SSE2 values incrementally: accumulated rounding would move pixels that lie exactly
+// on an edge across the top-left rule.
+template <class Fn>
+void c_soft_renderer::cover_row_scalar(const triangle& tri, int x0, int x1, float cy, Fn&& covered) {
+    float row[3];
+    for (int e = 0; e < 3; e++) {
+        row[e] = tri.edge_b[e] * cy;
+    }
+    for (int x = x0; x < x1; x++) {
+        const float cx = static_cast<float>(x) + 0.5f;
+        bool inside = true;
+        for (int e = 0; e < 3 && inside; e++) {
+            const float value = tri.edge_a[e] * cx + row[e] + tri.edge_c[e];
+            inside = value > 0.0f || (value == 0.0f && tri.top_left[e]);
+        }
+        if (inside) {
+            covered(x);
+        }
+    }
+}
+
+#ifdef SOFT_RENDERER_SSE2
+template <class Fn>
+void c_soft_renderer::cover_row_sse2(const triangle& tri, int x0, int x1, float cy, Fn&& covered) {
+    const __m128i tail_limit = _mm_set1_epi32(x1);
+    const __m128i lane_index = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 half = _mm_set1_ps(0.5f);
+    __m128 edge_a[3];
+    __m128 row[3];
+    __m128 edge_c[3];
+    __m128 top_left[3];
+    for (int e = 0; e < 3; e++) {
+        edge_a[e] = _mm_set1_ps(tri.edge_a[e]);
+        row[e] = _mm_set1_ps(tri.edge_b[e] * cy);
+        edge_c[e] = _mm_set1_ps(tri.edge_c[e]);
+        top_left[e] = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(tri.top_left[e])));
+    }
+
+    for (int x = x0; x < x1; x += 4) {
+        const __m128i lanes = _mm_add_epi32(_mm_set1_epi32(x), lane_index);
+        const __m128 cx = _mm_add_ps(_mm_cvtepi32_ps(lanes), half);
+        __m128 inside = _mm_castsi128_ps(_mm_cmplt_epi32(lanes, tail_limit));
+        for (int e = 0; e < 3; e++) {
+            const __m128 value = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge_a[e], cx), row[e]), edge_c[e]);
+            const __m128 positive = _mm_cmpgt_ps(value, zero);
+            const __m128 on_edge = _mm_and_ps(_mm_cmpeq_ps(value, zero), top_left[e]);
+            inside = _mm_and_ps(inside, _mm_or_ps(positive, on_edge));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        while (mask) {
+            const int lane = mask & 1 ? 0 : (mask & 2 ? 1 : (mask & 4 ? 2 : 3));
+            mask &= mask - 1;
+            covered(x + lane);
+        }
+    }
+}
+#endif
+
+void c_soft_renderer::raster_tile(int tile_index) {
+    const damage_rect& dirty = tile_dirty_[tile_index];
+    if (dirty.x0 >= dirty.x1 || dirty.y0 >= dirty.y1) {
+        return;
+    }
+    const int tile_x0 = dirty.x0;
+    const int tile_y0 = dirty.y0;
+    const int tile_x1 = dirty.x1;
+    const int tile_y1 = dirty.y1;
+
+    for (int y = tile_y0; y < tile_y1; y++) {
+        memset(framebuffer_.data() + static_cast<size_t>(y) * width_ + tile_x0, 0, (tile_x1 - tile_x0) * sizeof(uint32_t));
+    }
+
+    for (uint32_t index : bins_[tile_index]) {
+        const triangle& tri = triangles_[index];
+        const int x0 = std::max(tri.min_x, tile_x0);
+        const int y0 = std::max(tri.min_y, tile_y0);
+        const int x1 = std::min(tri.max_x, tile_x1);
+        const int y1 = std::min(tri.max_y, tile_y1);
+
+        for (int y = y0; y < y1; y++) {
+            uint32_t* row = framebuffer_.data() + static_cast<size_t>(y) * width_;
+            auto shade = [&](int x) { shade_pixel(tri, x, y, row + x); };
+#ifdef SOFT_RENDERER_SSE2
+            cover_row_sse2(tri, x0, x1, static_cast<float>(y) + 0.5f, shade);
+#else
+            cover_row_scalar(tri, x0, x1, static_cast<float>(y) + 0.5f, shade);
+#endif
+        }
+    }
+}
+
+uint64_t c_soft_renderer::coverage_mismatches(int triangles, uint64_t* pixels_tested) {
+    uint64_t mismatches = 0;
+    uint64_t pixels = 0;
+#ifdef SOFT_RENDERER_SSE2
+    constexpr int kExtent = 64;
+    uint32_t state = 0x2545F491u;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    };
+
+    for (int t = 0; t < triangles; t++) {
+        float px[3];
+        float py[3];
+        for (int i = 0; i < 3; i++) {
+            if (t & 1) {
+                px[i] = static_cast<float>(next() % (2 * kExtent + 1)) * 0.5f;
+                py[i] = static_cast<float>(next() % (2 * kExtent + 1)) * 0.5f;
+            }
+            else {
+                px[i] = static_cast<float>(next() % (kExtent * 1000)) / 1000.0f;
+                py[i] = static_cast<float>(next() % (kExtent * 1000)) / 1000.0f;
+            }
+        }
+        const float area = (px[1] - px[0]) * (py[2] - py[0]) - (py[1] - py[0]) * (px[2] - px[0]);
+        if (area == 0.0f) {
+            continue;
+        }
+        if (area < 0.0f) {
+            std::swap(px[1], px[2]);
+            std::swap(py[1], py[2]);
+        }
+
+        triangle tri;
+        setup_edges(px, py, tri);
+        for (int y = 0; y < kExtent; y++) {
+            const float cy = static_cast<float>(y) + 0.5f;
+            uint8_t scalar[kExtent] = {};
+            uint8_t simd[kExtent] = {};
+            cover_row_scalar(tri, 0, kExtent, cy, [&](int x) { scalar[x] = 1; });
+            cover_row_sse2(tri, 0, kExtent, cy, [&](int x) { simd[x] = 1; });
+            for (int x = 0; x < kExtent; x++) {
+                mismatches += scalar[x] != simd[x];
+            }
+            pixels += kExtent;
+        }
+    }
+#else
+    (void)triangles;
+#endif
+    if (pixels_tested) {
+        *pixels_tested = pixels;
+    }
+    return mismatches;
+}
+
+void c_soft_renderer::shade_pixel(const triangle& tri, int x, int y, uint32_t* dst) const {
+    const float cx = static_cast<float>(x) + 0.5f;
+    const float cy = static_cast<float>(y) + 0.5f;
+
+    float texel_storage[4];
+    const float* texel = tri.texel;
+    if (!tri.constant_uv) {
+        const float u = tri.plane[0][0] * cx + tri.plane[0][1] * cy + tri.plane[0][2];
+        const float v = tri.plane[1][0] * cx + tri.plane[1][1] * cy + tri.plane[1][2];
+        sample_bilinear(tri.tex->texels.data(), tri.tex->width, tri.tex->height, u, v, texel_storage);
+        texel = texel_storage;
+    }
+
+    float src[4];
+    for (int c = 0; c < 4; c++) {
+        const float* plane = tri.plane[2 + c];
+        src[c] = (plane[0] * cx + plane[1] * cy + plane[2]) * texel[c];
+    }
+
+    const float src_alpha = src[3] < 0.0f ? 0.0f : (src[3] > 1.0f ? 1.0f : src[3]);
+    const float inv_alpha = 1.0f - src_alpha;
+    const uint32_t dest = *dst;
+    *dst = pack_channel(src[0] * src_alpha + unpack_channel(dest, 0) * inv_alpha, 0)
+        | pack_channel(src[1] * src_alpha + unpack_channel(dest, 8) * inv_alpha, 8)
+        | pack_channel(src[2] * src_alpha + unpack_channel(dest, 16) * inv_alpha, 16)
+        | pack_channel(src_alpha + unpack_channel(dest, 24) * inv_alpha, 24);
+}
@@ -0,0 +1,125 @@
+#ifndef SOFT_RENDERER_HPP
+#define SOFT_RENDERER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../dep/imgui/imgui.h"
+#include "../damage_tracker/damage_tracker.h"
+
+struct soft_renderer_stats {
+    double frame_ms = 0.0;      // wall time of the last render(), setup + raster
+    int triangles = 0;          // triangles that survived clipping and were binned
+    int binned = 0;             // triangle/tile pairs
+    int tiles = 0;
+    int dirty_tiles = 0;        // tiles touched by the damage rects
+    int64_t dirty_pixels = 0;   // pixels cleared and redrawn
+    int threads = 0;            // rasterizing threads including the caller
+    int width = 0;
+    int height = 0;
+};
+
+// CPU renderer for ImDrawData. Produces the same image as the DX11 backend: pixel
+// centers at +0.5 with a top-left fill rule, scissoring by ImDrawCmd::ClipRect,
+// bilinear wrap sampling, color = vertex color * texel, and SRC_ALPHA/INV_SRC_ALPHA
+// blending for color with ONE/INV_SRC_ALPHA for alpha into an RGBA8 target cleared to 0.
+//
+// Triangles are set up and binned into kTileSize tiles on the calling thread, in
+// submission order; tiles are then rasterized in parallel by a persistent worker pool.
+// Coverage is evaluated four pixels at a time with SSE2 edge functions, computed per pixel
+// in the same order as the scalar fallback so both resolve edge ties identically.
+//
+// The framebuffer is retained between frames. Given damage rects, only tiles they
+// touch are visited and only pixels inside them are cleared and redrawn.
+class c_soft_renderer {
+public:
+    static constexpr int kTileSize = 64;
+
+    // thread_count 0 picks hardware_concurrency - 1 workers (the caller also rasterizes).
+    explicit c_soft_renderer(int thread_count = 0);
+    ~c_soft_renderer();
+
+    c_soft_renderer(const c_soft_renderer&) = delete;
+    c_soft_renderer& operator=(const c_soft_renderer&) = delete;
+
+    // rgba is copied. The returned id is what ImDrawCmd::TextureId must carry.
+    ImTextureID create_texture(const unsigned char* rgba, int width, int height);
+    void destroy_texture(ImTextureID texture);
+
+    // rect_count < 0 redraws everything; 0 leaves the previous image untouched.
+    void render(const ImDrawData* draw_data, const damage_rect* rects = nullptr, int rect_count = -1);
+
+    // Row-major RGBA8, width() * height() pixels, valid until the next render().
+    const uint32_t* pixels() const { return framebuffer_.data(); }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    const soft_renderer_stats& stats() const { return stats_; }
+
+    // Rasterizes `triangles` random triangles, half with vertices on the half-pixel grid so
+    // pixel centers fall exactly on edges, with both coverage loops and returns the pixels
+    // they disagree on. Without SSE2 there is only the scalar loop and nothing is tested.
+    static uint64_t coverage_mismatches(int triangles, uint64_t* pixels_tested = nullptr);
+
+private:
+    struct texture {
+        int width = 0;
+        int height = 0;
+        std::vector<uint32_t> texels;
+    };
+
+    struct triangle {
+        float edge_a[3];
+        float edge_b[3];
+        float edge_c[3];
+        uint32_t top_left[3];       // all ones when pixels exactly on the edge are covered
+        float plane[6][3];          // u, v, r, g, b, a as dx * x + dy * y + c
+        int min_x, min_y, max_x, max_y;   // covered pixel range, max exclusive
+        const texture* tex;
+        bool constant_uv;
+        float texel[4];             // pre-sampled texel when constant_uv
+    };
+
+    void start_workers();
+    void stop_workers();
+    void worker_main();
+    void drain_tiles();
+
+    const texture* find_texture(ImTextureID id) const;
+    void setup_triangle(const ImDrawVert& v0, const ImDrawVert& v1, const ImDrawVert& v2,
+        const ImVec2& offset, const ImVec2& scale, const int scissor[4], const texture* tex);
+    static void setup_edges(const float px[3], const float py[3], triangle& tri);
+    // Call covered(x) for every pixel of [x0, x1) on row center cy inside the triangle.
+    template <class Fn> static void cover_row_scalar(const triangle& tri, int x0, int x1, float cy, Fn&& covered);
+    template <class Fn> static void cover_row_sse2(const triangle& tri, int x0, int x1, float cy, Fn&& covered);
+    void raster_tile(int tile_index);
+    void shade_pixel(const triangle& tri, int x, int y, uint32_t* dst) const;
+
+    std::vector<std::unique_ptr<texture>> textures_;
+
+    std::vector<uint32_t> framebuffer_;
+    int width_ = 0;
+    int height_ = 0;
+    int tiles_x_ = 0;
+    int tiles_y_ = 0;
+    std::vector<triangle> triangles_;
+    std::vector<std::vector<uint32_t>> bins_;
+    std::vector<damage_rect> tile_dirty_;
+
+    int requested_threads_ = 0;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_ = 0;
+    int busy_workers_ = 0;
+    bool stopping_ = false;
+    std::atomic<int> next_tile_{ 0 };
+
+    soft_renderer_stats stats_{};
+};
+
+#endif // SOFT_RENDERER_HPP
@@ -0,0 +1,78 @@
+#include "string_table.h"
+#include "../dep/imgui/imgui_internal.h"
+#include <algorithm>
+#include <cctype>
+#include <cfloat>
+
+namespace {
+    ImGuiID hash_text(std::string_view text) {
+        // ImHashStr treats a zero size as "zero-terminated".
+        return text.empty() ? ImHashStr("", 0) : ImHashStr(text.data(), text.size());
+    }
+}
+
+size_t c_string_table::key_hash::operator()(std::string_view text) const {
+    return hash_text(text);
+}
+
+c_string_table::string_id c_string_table::intern(std::string_view text) {
+    auto it = ids_.find(text);
+    if (it != ids_.end())
+        return it->second;
+
+    const string_id id = static_cast<string_id>(entries_.size());
+    entry& added = entries_.emplace_back();
+    added.text.assign(text.data(), text.size());
+    added.lower.reserve(text.size());
+    for (char c : text)
+        added.lower.push_back(static_cast<char>(tolower(static_cast<unsigned char>(c))));
+    added.hash = hash_text(text);
+    ids_.emplace(added.text, id);
+    ranks_dirty_ = true;
+    return id;
+}
+
+c_string_table::string_id c_string_table::lookup(std::string_view text) const {
+    auto it = ids_.find(text);
+    return it != ids_.end() ? it->second : kNone;
+}
+
+void c_string_table::clear() {
+    ids_.clear();
+    entries_.clear();
+    ranks_.clear();
+    ranks_dirty_ = false;
+}
+
+int c_string_table::rank(string_id id) const {
+    if (ranks_dirty_) {
+        std::vector<string_id> order(entries_.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = static_cast<string_id>(i);
+        std::sort(order.begin(), order.end(), [&](string_id a, string_id b) { return entries_[a].text < entries_[b].text; });
+        ranks_.resize(entries_.size());
+        for (size_t i = 0; i < order.size(); i++)
+            ranks_[order[i]] = static_cast<int>(i);
+        ranks_dirty_ = false;
+    }
+    return ranks_[id];
+}
+
+ImVec2 c_string_table::text_size(string_id id) const {
+    const entry& e = entries_[id];
+    ImFont* font = ImGui::GetFont();
+    const float font_size = ImGui::GetFontSize();
+    if (e.size_font != font || e.size_font_size != font_size) {
+        e.size = font->CalcTextSizeA(font_size, FLT_MAX, 0.f, e.text.data(), e.text.data() + e.text.size());
+        e.size.x = IM_TRUNC(e.size.x + 0.99999f);
+        e.size_font = font;
+        e.size_font_size = font_size;
+    }
+    return e.size;
+}
+
+void c_string_table::match(std::string_view lower_query, std::vector<uint8_t>& matches) const {
+    matches.assign(entries_.size(), 0);
+    for (size_t i = 0; i < entries_.size(); i++)
+        matches[i] = entries_[i].lower.find(lower_query) != std::string::npos;
+}
@@ -0,0 +1,59 @@
+#ifndef STRING_TABLE_HPP
+#define STRING_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../dep/imgui/imgui.h"
+
+// Interned strings with stable ids. Each entry keeps its ImHashStr hash, a lowercase copy
+// for search and its text size, so comparing, sorting, matching and measuring repeated
+// values (plans, statuses, MIME types) are integer or cached operations.
+class c_string_table {
+public:
+    using string_id = uint32_t;
+    static constexpr string_id kNone = UINT32_MAX;
+
+    string_id intern(std::string_view text);
+    // kNone if the string was never interned.
+    string_id lookup(std::string_view text) const;
+    // Ids stay valid until clear().
+    void clear();
+    size_t size() const { return entries_.size(); }
+
+    const std::string& text(string_id id) const { return entries_[id].text; }
+    std::string_view lower(string_id id) const { return entries_[id].lower; }
+    ImGuiID hash(string_id id) const { return entries_[id].hash; }
+    // Position in byte order among all interned strings.
+    int rank(string_id id) const;
+    // With the current ImGui font; cached until the font or its size changes.
+    ImVec2 text_size(string_id id) const;
+
+    // Sets matches[id] for every string whose lowercase text contains `lower_query`.
+    void match(std::string_view lower_query, std::vector<uint8_t>& matches) const;
+
+private:
+    struct entry {
+        std::string text;
+        std::string lower;
+        ImGuiID hash = 0;
+        mutable ImVec2 size{ -1.f, -1.f };
+        mutable const ImFont* size_font = nullptr;
+        mutable float size_font_size = 0.f;
+    };
+
+    struct key_hash {
+        size_t operator()(std::string_view text) const;
+    };
+
+    std::deque<entry> entries_;         // stable addresses for the lookup keys
+    std::unordered_map<std::string_view, string_id, key_hash> ids_;
+    mutable std::vector<int> ranks_;
+    mutable bool ranks_dirty_ = false;
+};
+
+#endif // STRING_TABLE_HPP
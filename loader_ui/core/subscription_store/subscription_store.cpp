@@ -0,0 +1,186 @@
+#include "subscription_store.h"
+#include "../dep/imgui/imgui_internal.h"
+#include "../loader_ui/loader_ui.h"
+#include <algorithm>
+
+namespace {
+    ImGuiID hash_plan_id(std::string_view plan_id) {
+        // ImHashStr treats a zero size as "zero-terminated".
+        return plan_id.empty() ? ImHashStr("", 0) : ImHashStr(plan_id.data(), plan_id.size());
+    }
+}
+
+void c_subscription_store::clear() {
+    strings_.clear();
+    status_values_.clear();
+    status_values_dirty_ = false;
+    plan_.clear();
+    status_.clear();
+    plan_id_.clear();
+    plan_id_hash_.clear();
+    image_mime_.clear();
+    video_mime_.clear();
+    expires_us_.clear();
+    flags_.clear();
+    countdowns_.clear();
+    image_.clear();
+    video_.clear();
+    source_.clear();
+    source_index_.clear();
+    source_count_ = 0;
+}
+
+void c_subscription_store::assign(const std::vector<user_subscription*>& subscriptions) {
+    clear();
+    source_count_ = subscriptions.size();
+
+    for (size_t i = 0; i < subscriptions.size(); i++) {
+        if (!subscriptions[i])
+            continue;
+        source_.push_back(subscriptions[i]);
+        source_index_.push_back(static_cast<int>(i));
+    }
+
+    const size_t rows = source_.size();
+    plan_.resize(rows);
+    status_.resize(rows);
+    plan_id_.resize(rows);
+    plan_id_hash_.resize(rows);
+    image_mime_.resize(rows);
+    video_mime_.resize(rows);
+    expires_us_.resize(rows);
+    flags_.resize(rows);
+    countdowns_.resize(rows);
+    image_.resize(rows);
+    video_.resize(rows);
+    for (size_t row = 0; row < rows; row++)
+        update(row);
+}
+
+void c_subscription_store::update(size_t row) {
+    const user_subscription* sub = source_[row];
+    plan_[row] = strings_.intern(sub->plan);
+    status_[row] = strings_.intern(sub->status);
+    plan_id_[row] = sub->plan_id;
+    plan_id_hash_[row] = hash_plan_id(plan_id_[row]);
+    image_mime_[row] = strings_.intern(sub->product_image_mime);
+    video_mime_[row] = strings_.intern(sub->product_video_mime);
+    countdowns_[row].set(sub->expires_at);
+    expires_us_[row] = countdowns_[row].valid() ? countdowns_[row].expires_us() : INT64_MAX;
+
+    if (!image_[row].owner)
+        image_[row] = media_ref{ sub->product_image.data(), sub->product_image.size(), nullptr };
+    if (!video_[row].owner)
+        video_[row] = media_ref{ sub->product_video.data(), sub->product_video.size(), nullptr };
+
+    uint8_t row_flags = 0;
+    if (sub->frozen)
+        row_flags |= flag_frozen;
+    if (image_[row].size)
+        row_flags |= flag_has_image;
+    if (video_[row].size || !sub->product_video_path.empty())
+        row_flags |= flag_has_video;
+    flags_[row] = row_flags;
+    status_values_dirty_ = true;
+}
+
+void c_subscription_store::append(user_subscription* subscription, int source_index) {
+    source_.push_back(subscription);
+    source_index_.push_back(source_index);
+    source_count_++;
+    plan_.emplace_back();
+    status_.emplace_back();
+    plan_id_.emplace_back();
+    plan_id_hash_.emplace_back();
+    image_mime_.emplace_back();
+    video_mime_.emplace_back();
+    expires_us_.emplace_back();
+    flags_.emplace_back();
+    countdowns_.emplace_back();
+    image_.emplace_back();
+    video_.emplace_back();
+    update(size() - 1);
+}
+
+void c_subscription_store::erase(size_t row) {
+    const int removed = source_index_[row];
+    plan_.erase(plan_.begin() + row);
+    status_.erase(status_.begin() + row);
+    plan_id_.erase(plan_id_.begin() + row);
+    plan_id_hash_.erase(plan_id_hash_.begin() + row);
+    image_mime_.erase(image_mime_.begin() + row);
+    video_mime_.erase(video_mime_.begin() + row);
+    expires_us_.erase(expires_us_.begin() + row);
+    flags_.erase(flags_.begin() + row);
+    countdowns_.erase(countdowns_.begin() + row);
+    image_.erase(image_.begin() + row);
+    video_.erase(video_.begin() + row);
+    source_.erase(source_.begin() + row);
+    source_index_.erase(source_index_.begin() + row);
+    for (int& index : source_index_) {
+        if (index > removed)
+            index--;
+    }
+    source_count_--;
+    status_values_dirty_ = true;
+}
+
+void c_subscription_store::reset(size_t row) {
+    image_[row] = media_ref{};
+    video_[row] = media_ref{};
+    update(row);
+}
+
+void c_subscription_store::set_image(size_t row, media_ref ref) {
+    image_[row] = std::move(ref);
+    update(row);
+}
+
+void c_subscription_store::set_video(size_t row, media_ref ref) {
+    video_[row] = std::move(ref);
+    update(row);
+}
+
+int c_subscription_store::find_plan_id(std::string_view plan_id) const {
+    const ImGuiID hash = hash_plan_id(plan_id);
+    for (size_t row = 0; row < plan_id_hash_.size(); row++) {
+        if (plan_id_hash_[row] == hash && plan_id_[row] == plan_id)
+            return static_cast<int>(row);
+    }
+    return -1;
+}
+
+bool c_subscription_store::compact_strings() {
+    // At most four strings per row are live; compact once at least half are dead.
+    if (strings_.size() <= 8 * size() + 64)
+        return false;
+
+    c_string_table live;
+    for (size_t row = 0; row < size(); row++) {
+        plan_[row] = live.intern(strings_.text(plan_[row]));
+        status_[row] = live.intern(strings_.text(status_[row]));
+        image_mime_[row] = live.intern(strings_.text(image_mime_[row]));
+        video_mime_[row] = live.intern(strings_.text(video_mime_[row]));
+    }
+    strings_ = std::move(live);
+    status_values_dirty_ = true;
+    return true;
+}
+
+const std::vector<c_subscription_store::string_id>& c_subscription_store::status_values() const {
+    if (status_values_dirty_) {
+        status_values_ = status_;
+        std::sort(status_values_.begin(), status_values_.end());
+        status_values_.erase(std::unique(status_values_.begin(), status_values_.end()), status_values_.end());
+        status_values_dirty_ = false;
+    }
+    return status_values_;
+}
+
+void c_subscription_store::filter(std::string_view lower_query, std::vector<int>& rows) const {
+    // Few distinct strings: match each once, then test rows by id.
+    strings_.match(lower_query, matches_);
+    rows.erase(std::remove_if(rows.begin(), rows.end(), [&](int row) {
+        return !matches_[plan_[row]] && !matches_[status_[row]];
+    }), rows.end());
+}
@@ -0,0 +1,113 @@
+#ifndef SUBSCRIPTION_STORE_HPP
+#define SUBSCRIPTION_STORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../expiry/expiry.h"
+#include "../string_table/string_table.h"
+
+struct user_subscription;
+
+// The current profile's subscriptions as columns, one row per non-null subscription.
+// Hot columns hold what the product table reads every frame, packed per field: interned
+// plan, status and MIME types, parsed expiry, flags. Plan ids are unique per row, so they
+// are kept with their hash instead of in the searchable string table. The host's
+// user_subscription with its image and video payloads is only reached through the cold
+// source handle, on selection or launch.
+class c_subscription_store {
+public:
+    using string_id = c_string_table::string_id;
+
+    // Image or video bytes of a row. Without an owner they point into the source
+    // subscription's vector; with one they borrow host memory that the owner releases once
+    // the last reference is dropped.
+    struct media_ref {
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+        std::shared_ptr<void> owner;
+    };
+
+    enum flags : uint8_t {
+        flag_frozen = 1 << 0,
+        flag_has_image = 1 << 1,
+        flag_has_video = 1 << 2,
+    };
+
+    // Rebuilds every column from the host's list; the pointers must outlive the store.
+    void assign(const std::vector<user_subscription*>& subscriptions);
+    void clear();
+
+    // Row edits for subscription deltas. update() re-reads every column of `row` from its
+    // source, after the source changed or was replaced with set_source().
+    void update(size_t row);
+    void set_source(size_t row, user_subscription* subscription) { source_[row] = subscription; }
+    // update() for a source replaced wholesale: borrowed media refs are dropped as well.
+    void reset(size_t row);
+    // Appends a row for a subscription appended to the source list at `source_index`.
+    void append(user_subscription* subscription, int source_index);
+    // Removes `row` and shifts later source indices down, matching an erase from the list.
+    void erase(size_t row);
+    // First row with this plan id, or -1.
+    int find_plan_id(std::string_view plan_id) const;
+    // Re-interns only the strings rows still use, once edits have left most of the table
+    // unused. Invalidates string ids; true if it compacted.
+    bool compact_strings();
+
+    size_t size() const { return plan_.size(); }
+    bool empty() const { return plan_.empty(); }
+    // Length of the list last assigned, null entries included.
+    size_t source_count() const { return source_count_; }
+
+    // Hot.
+    string_id plan(size_t row) const { return plan_[row]; }
+    string_id status(size_t row) const { return status_[row]; }
+    const std::string& plan_id(size_t row) const { return plan_id_[row]; }
+    string_id image_mime(size_t row) const { return image_mime_[row]; }
+    string_id video_mime(size_t row) const { return video_mime_[row]; }
+    int64_t expires_us(size_t row) const { return expires_us_[row]; }     // INT64_MAX if unknown
+    uint8_t flags(size_t row) const { return flags_[row]; }
+    c_expiry_countdown& countdown(size_t row) { return countdowns_[row]; }
+
+    const c_string_table& strings() const { return strings_; }
+    const std::string& text(string_id id) const { return strings_.text(id); }
+    // Distinct statuses of the current rows.
+    const std::vector<string_id>& status_values() const;
+    // Rows whose plan or status contains `lower_query`, in the order given.
+    void filter(std::string_view lower_query, std::vector<int>& rows) const;
+
+    // Cold.
+    const media_ref& image(size_t row) const { return image_[row]; }
+    const media_ref& video(size_t row) const { return video_[row]; }
+    // An empty ref goes back to the source subscription's bytes.
+    void set_image(size_t row, media_ref ref);
+    void set_video(size_t row, media_ref ref);
+    user_subscription* source(size_t row) const { return source_[row]; }
+    int source_index(size_t row) const { return source_index_[row]; }
+
+private:
+    c_string_table strings_;
+    mutable std::vector<string_id> status_values_;
+    mutable bool status_values_dirty_ = false;
+    mutable std::vector<uint8_t> matches_;
+
+    std::vector<string_id> plan_;
+    std::vector<string_id> status_;
+    std::vector<std::string> plan_id_;
+    std::vector<ImGuiID> plan_id_hash_;
+    std::vector<string_id> image_mime_;
+    std::vector<string_id> video_mime_;
+    std::vector<int64_t> expires_us_;
+    std::vector<uint8_t> flags_;
+    std::vector<c_expiry_countdown> countdowns_;
+
+    std::vector<media_ref> image_;
+    std::vector<media_ref> video_;
+    std::vector<user_subscription*> source_;
+    std::vector<int> source_index_;
+    size_t source_count_ = 0;
+};
+
+#endif // SUBSCRIPTION_STORE_HPP
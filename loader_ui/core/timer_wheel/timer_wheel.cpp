@@ -0,0 +1,138 @@
+#include "timer_wheel.h"
+#include <algorithm>
+#include <chrono>
+
+static_assert(c_timer_wheel::kSlots == 256, "timer ids carry the slot in their low 8 bits");
+
+uint64_t c_timer_wheel::now_us() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void c_timer_wheel::start(uint64_t now_us) {
+    if (started_)
+        return;
+    processed_tick_ = now_us / kTickUs;
+    started_ = true;
+}
+
+c_timer_wheel::timer_id c_timer_wheel::schedule_at(uint64_t deadline_us, callback fn) {
+    start(now_us());
+
+    // Deadlines already in the past go into the next slot to be swept.
+    const uint64_t tick = (std::max)(deadline_us / kTickUs, processed_tick_);
+    const size_t slot = static_cast<size_t>(tick % kSlots);
+    const timer_id id = (next_serial_++ << 8) | slot;
+    slots_[slot].push_back(timer{ id, deadline_us, std::move(fn) });
+    count_++;
+
+    if (!next_deadline_dirty_ && deadline_us < next_deadline_)
+        next_deadline_ = deadline_us;
+    return id;
+}
+
+void c_timer_wheel::reschedule(timer_id& id, uint64_t deadline_us, callback fn) {
+    cancel(id);
+    id = schedule_at(deadline_us, std::move(fn));
+}
+
+bool c_timer_wheel::cancel(timer_id id) {
+    if (id == 0)
+        return false;
+
+    std::vector<timer>& slot = slots_[id & 0xff];
+    for (size_t i = 0; i < slot.size(); i++) {
+        if (slot[i].id != id)
+            continue;
+        slot[i] = std::move(slot.back());
+        slot.pop_back();
+        count_--;
+        next_deadline_dirty_ = true;
+        return true;
+    }
+
+    // Due in the advance() currently running but not fired yet.
+    for (timer& t : due_) {
+        if (t.id == id && t.fn) {
+            t.fn = nullptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+void c_timer_wheel::clear() {
+    for (std::vector<timer>& slot : slots_)
+        slot.clear();
+    for (timer& t : due_)
+        t.fn = nullptr;
+    count_ = 0;
+    next_deadline_ = kNever;
+    next_deadline_dirty_ = false;
+}
+
+int c_timer_wheel::advance(uint64_t now_us) {
+    start(now_us);
+    const uint64_t end_tick = now_us / kTickUs;
+    if (count_ == 0 || end_tick < processed_tick_) {
+        processed_tick_ = (std::max)(processed_tick_, end_tick);
+        return 0;
+    }
+
+    auto sweep = [&](std::vector<timer>& slot) {
+        for (size_t i = 0; i < slot.size();) {
+            if (slot[i].deadline_us > now_us) {
+                i++;
+                continue;
+            }
+            due_.push_back(std::move(slot[i]));
+            slot[i] = std::move(slot.back());
+            slot.pop_back();
+            count_--;
+        }
+    };
+
+    due_.clear();
+    if (end_tick - processed_tick_ >= kSlots) {
+        for (std::vector<timer>& slot : slots_)
+            sweep(slot);
+    }
+    else {
+        for (uint64_t tick = processed_tick_; tick <= end_tick; tick++)
+            sweep(slots_[tick % kSlots]);
+    }
+    // The current tick stays open: timers later in it are swept on the next call.
+    processed_tick_ = end_tick;
+    if (due_.empty())
+        return 0;
+    next_deadline_dirty_ = true;
+
+    std::sort(due_.begin(), due_.end(), [](const timer& a, const timer& b) {
+        return a.deadline_us != b.deadline_us ? a.deadline_us < b.deadline_us : a.id < b.id;
+    });
+
+    // Callbacks may schedule into slots_ or cancel entries of due_; index, don't iterate.
+    int fired = 0;
+    for (size_t i = 0; i < due_.size(); i++) {
+        callback fn = std::move(due_[i].fn);
+        due_[i].fn = nullptr;
+        if (!fn)
+            continue;
+        fn();
+        fired++;
+    }
+    due_.clear();
+    return fired;
+}
+
+uint64_t c_timer_wheel::next_deadline_us() const {
+    if (next_deadline_dirty_) {
+        next_deadline_ = kNever;
+        for (const std::vector<timer>& slot : slots_) {
+            for (const timer& t : slot)
+                next_deadline_ = (std::min)(next_deadline_, t.deadline_us);
+        }
+        next_deadline_dirty_ = false;
+    }
+    return next_deadline_;
+}
@@ -0,0 +1,55 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Hashed timer wheel on the steady clock, in microseconds. Timers are bucketed by
+// kTickUs into kSlots slots (longer delays wait for their round), so scheduling and
+// cancelling are O(1) and advance() only visits the slots that elapsed. Timers fire at
+// their exact deadline, not at the end of their tick. Single-threaded.
+class c_timer_wheel {
+public:
+    using timer_id = uint64_t;          // serial << 8 | slot; 0 is never a valid id
+    using callback = std::function<void()>;
+
+    static constexpr uint64_t kTickUs = 4000;
+    static constexpr size_t kSlots = 256;     // must match the 8 slot bits of timer_id
+    static constexpr uint64_t kNever = UINT64_MAX;
+
+    static uint64_t now_us();
+
+    timer_id schedule_at(uint64_t deadline_us, callback fn);
+    timer_id schedule_after(uint64_t delay_us, callback fn) { return schedule_at(now_us() + delay_us, std::move(fn)); }
+    // Cancels id (if pending) and schedules a replacement, storing its id back.
+    void reschedule(timer_id& id, uint64_t deadline_us, callback fn);
+    bool cancel(timer_id id);
+    void clear();
+
+    // Runs every timer due at now_us in deadline order; callbacks may schedule or cancel.
+    int advance(uint64_t now_us);
+    uint64_t next_deadline_us() const;
+    size_t size() const { return count_; }
+
+private:
+    struct timer {
+        timer_id id;
+        uint64_t deadline_us;
+        callback fn;
+    };
+
+    void start(uint64_t now_us);
+
+    std::vector<timer> slots_[kSlots];
+    std::vector<timer> due_;
+    uint64_t processed_tick_ = 0;       // every slot for ticks below this has been swept
+    bool started_ = false;
+    size_t count_ = 0;
+    uint64_t next_serial_ = 1;
+    mutable uint64_t next_deadline_ = kNever;
+    mutable bool next_deadline_dirty_ = false;
+};
+
+#endif // TIMER_WHEEL_HPP
@@ -0,0 +1,80 @@
+#include "upload_ring.h"
+#include <algorithm>
+
+c_upload_ring::c_upload_ring(size_t initial_capacity)
+    : capacity_(std::max(initial_capacity, kMinCapacity)) {
+    stats_.capacity = capacity_;
+}
+
+void c_upload_ring::begin_frame() {
+    stats_.frame_peak = frame_usage_;
+
+    if (capacity_ > kMinCapacity && frame_usage_ * 4 < capacity_) {
+        low_usage_peak_ = std::max(low_usage_peak_, frame_usage_);
+        if (++low_usage_frames_ >= kShrinkFrames) {
+            pending_shrink_ = true;
+        }
+    }
+    else {
+        low_usage_frames_ = 0;
+        low_usage_peak_ = 0;
+    }
+
+    frame_usage_ = 0;
+}
+
+upload_reservation c_upload_ring::reserve(size_t count) {
+    upload_reservation reservation;
+    stats_.reservations++;
+    frame_usage_ += count;
+
+    if (pending_shrink_) {
+        capacity_ = std::max(kMinCapacity, low_usage_peak_ * 2);
+        pending_shrink_ = false;
+        low_usage_frames_ = 0;
+        low_usage_peak_ = 0;
+        reservation.reallocate = true;
+        needs_discard_ = true;
+        stats_.shrinks++;
+    }
+
+    if (count > capacity_) {
+        capacity_ = grown_capacity(count);
+        reservation.reallocate = true;
+        needs_discard_ = true;
+        stats_.grows++;
+    }
+    stats_.capacity = capacity_;
+
+    if (!needs_discard_ && head_ + count <= capacity_) {
+        reservation.offset = head_;
+        reservation.mode = upload_map_mode::no_overwrite;
+        head_ += count;
+        stats_.appends++;
+        return reservation;
+    }
+
+    if (!needs_discard_) {
+        stats_.wraps++;
+    }
+
+    reservation.offset = 0;
+    reservation.mode = upload_map_mode::discard;
+    head_ = count;
+    needs_discard_ = false;
+    return reservation;
+}
+
+void c_upload_ring::invalidate() {
+    needs_discard_ = true;
+    head_ = 0;
+}
+
+size_t c_upload_ring::grown_capacity(size_t count) const {
+    size_t capacity = std::max(capacity_, kMinCapacity);
+    const size_t target = count + count / 2;
+    while (capacity < target) {
+        capacity = capacity * kGrowthNumerator / kGrowthDenominator + 1;
+    }
+    return capacity;
+}
@@ -0,0 +1,73 @@
+#ifndef UPLOAD_RING_HPP
+#define UPLOAD_RING_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// How the backend must map the buffer for a reservation.
+enum class upload_map_mode {
+    no_overwrite,   // append after data the GPU may still be reading
+    discard         // orphan the buffer and start again at offset 0
+};
+
+struct upload_reservation {
+    size_t offset = 0;              // first element of the reserved range
+    upload_map_mode mode = upload_map_mode::discard;
+    bool reallocate = false;        // backend must recreate the buffer with capacity() elements first
+};
+
+struct upload_ring_stats {
+    uint64_t reservations = 0;
+    uint64_t appends = 0;
+    uint64_t wraps = 0;
+    uint64_t grows = 0;
+    uint64_t shrinks = 0;
+    size_t capacity = 0;
+    size_t frame_peak = 0;
+};
+
+// Backend-agnostic placement policy for streaming vertex/index uploads into one
+// persistently allocated dynamic buffer. It tracks element counts only; the backend
+// owns the actual GPU resource and follows the returned reservation:
+//  - ranges are appended behind the previous one with no_overwrite while they fit,
+//  - when the tail is reached the ring wraps with a discard (the driver renames the
+//    buffer, so in-flight draws keep their data),
+//  - a request larger than the buffer grows it geometrically,
+//  - the buffer only shrinks after kShrinkFrames consecutive frames used less than
+//    a quarter of it, so a list that briefly expands does not thrash allocations.
+class c_upload_ring {
+public:
+    static constexpr size_t kMinCapacity = 4096;
+    static constexpr size_t kShrinkFrames = 600;
+    static constexpr size_t kGrowthNumerator = 3;
+    static constexpr size_t kGrowthDenominator = 2;
+
+    explicit c_upload_ring(size_t initial_capacity = kMinCapacity);
+
+    // Marks a frame boundary; evaluates the shrink hysteresis for the frame that ended.
+    void begin_frame();
+
+    // Places count elements. The returned range is valid until the next reserve().
+    upload_reservation reserve(size_t count);
+
+    // Forces the next reservation to discard, e.g. after the backend lost its buffer.
+    void invalidate();
+
+    size_t capacity() const { return capacity_; }
+    size_t head() const { return head_; }
+    const upload_ring_stats& stats() const { return stats_; }
+
+private:
+    size_t grown_capacity(size_t count) const;
+
+    size_t capacity_;
+    size_t head_ = 0;
+    size_t frame_usage_ = 0;
+    size_t low_usage_frames_ = 0;
+    size_t low_usage_peak_ = 0;
+    bool pending_shrink_ = false;
+    bool needs_discard_ = true;
+    upload_ring_stats stats_{};
+};
+
+#endif // UPLOAD_RING_HPP
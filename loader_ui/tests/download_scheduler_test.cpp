@@ -0,0 +1,179 @@
+#include "test.h"
+#include "../core/download_scheduler/download_scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    constexpr uint64_t kTickUs = 16667;
+
+    struct schedule_result {
+        int completed = 0;
+        uint64_t ticks = 0;
+        uint64_t total_bytes = 0;
+        double fairness = 0.0;          // mean Jain index of the sessions' per-tick shares; 1 is equal
+        int priority_inversions = 0;    // items started while a higher-priority one waited
+        double tick_us = 0.0;           // scheduler cost over all ticks
+        std::vector<std::string> started;
+    };
+
+    // Downloads `items` files of 1-4 MiB at priorities -1, 0 and 1 over `sessions` sessions of
+    // the local stand-in transport sharing `bandwidth` bytes per second, on a 60 Hz clock.
+    schedule_result run_schedule(int items, int sessions, uint64_t bandwidth) {
+        // Each link could take the whole budget alone, so the shares are the scheduler's doing.
+        c_local_transport transport(0, bandwidth);
+        c_download_scheduler scheduler(&transport, sessions);
+        scheduler.set_bandwidth(bandwidth);
+
+        schedule_result result;
+        scheduler.set_finished_callback([&](const download_item& item) {
+            if (item.state == download_state::done)
+                result.completed++;
+        });
+
+        for (int i = 0; i < items; i++) {
+            const std::string file_id = "file-" + std::to_string(i);
+            const uint64_t bytes = (1 + i % 4) * (1ull << 20);
+            transport.set_file_bytes(file_id, bytes);
+            result.total_bytes += bytes;
+            scheduler.enqueue(file_id, file_id, i % 3 - 1);
+        }
+
+        const uint64_t max_ticks = result.total_bytes / (std::max)(bandwidth * kTickUs / 1000000, uint64_t{ 1 }) * 4 + 1000;
+        std::unordered_map<uint64_t, uint64_t> last_done;      // running items after the previous tick
+        std::unordered_map<uint64_t, uint64_t> next_done;
+        double fairness_sum = 0.0;
+        int fairness_ticks = 0;
+        uint64_t now_us = 1;
+        while (!scheduler.empty() && result.ticks < max_ticks) {
+            const auto tick_start = std::chrono::steady_clock::now();
+            scheduler.tick(now_us);
+            result.tick_us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - tick_start).count();
+            result.ticks++;
+            now_us += kTickUs;
+
+            int best_queued = INT_MIN;
+            for (const download_item& item : scheduler.items()) {
+                if (item.state == download_state::queued)
+                    best_queued = (std::max)(best_queued, item.priority);
+            }
+
+            // Jain's index over sessions that ran for the whole tick.
+            double sum = 0.0, sum_squares = 0.0;
+            int shares = 0;
+            next_done.clear();
+            for (const download_item& item : scheduler.items()) {
+                if (item.state != download_state::running)
+                    continue;
+                next_done[item.id] = item.done_bytes;
+                auto it = last_done.find(item.id);
+                if (it == last_done.end()) {
+                    result.started.push_back(item.file_id);
+                    if (item.priority < best_queued)
+                        result.priority_inversions++;
+                    continue;
+                }
+                const double share = static_cast<double>(item.done_bytes - it->second);
+                sum += share;
+                sum_squares += share * share;
+                shares++;
+            }
+            if (shares >= 2 && sum_squares > 0.0) {
+                fairness_sum += sum * sum / (shares * sum_squares);
+                fairness_ticks++;
+            }
+            last_done.swap(next_done);
+        }
+        result.fairness = fairness_ticks ? fairness_sum / fairness_ticks : 1.0;
+        return result;
+    }
+
+    // Transport that never finishes anything, to look at admission alone.
+    class c_idle_transport : public c_download_transport {
+    public:
+        void start(download_item& item) override { started.push_back(item.file_id); }
+        uint64_t pump(download_item&, uint64_t) override { return 0; }
+        void stop(const download_item& item) override { stopped.push_back(item.file_id); }
+
+        std::vector<std::string> started;
+        std::vector<std::string> stopped;
+    };
+}
+
+TEST(download_scheduler_admits_by_priority_then_fifo) {
+    c_idle_transport transport;
+    c_download_scheduler scheduler(&transport, 1);
+    scheduler.enqueue("low", "low", -1);
+    scheduler.enqueue("a", "a", 0);
+    scheduler.enqueue("high", "high", 1);
+    scheduler.enqueue("b", "b", 0);
+    CHECK(scheduler.enqueue("a", "a", 5) == 0);
+    CHECK(scheduler.enqueue("", "", 0) == 0);
+
+    std::vector<std::string> order;
+    for (int i = 0; i < 4; i++) {
+        scheduler.tick(1 + i * kTickUs);
+        CHECK(scheduler.running() == 1);
+        const download_item* running = scheduler.oldest_running();
+        CHECK(running != nullptr);
+        if (!running)
+            return;
+        order.push_back(running->file_id);
+        CHECK(scheduler.finish(running->file_id, true));
+    }
+    CHECK((order == std::vector<std::string>{ "high", "a", "b", "low" }));
+}
+
+TEST(download_scheduler_respects_the_session_limit) {
+    c_idle_transport transport;
+    c_download_scheduler scheduler(&transport, 2);
+    for (int i = 0; i < 5; i++)
+        scheduler.enqueue("file-" + std::to_string(i), "file", 0);
+    scheduler.tick(1);
+    CHECK(scheduler.running() == 2);
+    CHECK(transport.started.size() == 2);
+
+    scheduler.set_max_sessions(3);
+    scheduler.tick(1 + kTickUs);
+    CHECK(scheduler.running() == 3);
+
+    CHECK(scheduler.cancel(scheduler.items().front().id));
+    CHECK(transport.stopped.size() == 1);
+    scheduler.tick(1 + 2 * kTickUs);
+    CHECK(scheduler.running() == 3);
+    CHECK(scheduler.items().size() == 4);
+
+    scheduler.clear();
+    CHECK(scheduler.empty());
+    CHECK(transport.stopped.size() == 4);
+}
+
+TEST(download_scheduler_drains_without_inversions) {
+    for (int sessions : { 1, 2, 4 }) {
+        const schedule_result result = run_schedule(12, sessions, 8ull << 20);
+        CHECK(result.completed == 12);
+        CHECK(result.priority_inversions == 0);
+        CHECK(result.started.size() == 12);
+        if (sessions > 1)
+            CHECK(result.fairness > 0.95);
+    }
+}
+
+BENCH(download_scheduler_bench) {
+    for (int sessions : { 1, 2, 4, 8 }) {
+        for (uint64_t bandwidth : { 4ull << 20, 32ull << 20 }) {
+            const schedule_result result = run_schedule(64, sessions, bandwidth);
+            const double simulated_s = static_cast<double>(result.ticks * kTickUs) / 1e6;
+            const double utilization = simulated_s > 0.0
+                ? static_cast<double>(result.total_bytes) / (static_cast<double>(bandwidth) * simulated_s) : 0.0;
+            std::printf("  %d sessions, %3llu MiB/s: %d/64 done in %.1f s, utilization %.3f, fairness %.3f, %d inversions, %.2f us/tick\n",
+                sessions, static_cast<unsigned long long>(bandwidth >> 20), result.completed, simulated_s, utilization,
+                result.fairness, result.priority_inversions, result.ticks ? result.tick_us / static_cast<double>(result.ticks) : 0.0);
+        }
+    }
+}
@@ -0,0 +1,172 @@
+#include "test.h"
+#include "../core/expiry/expiry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    constexpr int64_t kSecond = 1000000;
+
+    // parse_expiry_us, or INT64_MIN if it refused the text.
+    int64_t parse(std::string_view text) {
+        int64_t us = 0;
+        return parse_expiry_us(text, us) ? us : INT64_MIN;
+    }
+
+    std::string countdown(int64_t remaining_seconds) {
+        char text[kMaxCountdownChars];
+        return std::string(text, format_countdown(remaining_seconds, text));
+    }
+}
+
+TEST(parse_expiry_known_instants) {
+    CHECK(parse("1970-01-01 00:00:00") == 0);
+    CHECK(parse("1969-12-31 23:59:59") == -kSecond);
+    CHECK(parse("2026-10-19 08:30:15") == 1792398615 * kSecond);
+}
+
+TEST(parse_expiry_leap_days) {
+    CHECK(parse("2024-02-29 00:00:00") == 1709164800 * kSecond);
+    CHECK(parse("2000-02-29 12:00:00") == 951825600 * kSecond);
+    CHECK(parse("2023-02-29 00:00:00") == INT64_MIN);
+    CHECK(parse("1900-02-29 00:00:00") == INT64_MIN);
+    CHECK(parse("2024-02-30 00:00:00") == INT64_MIN);
+    CHECK(parse("2024-03-01 00:00:00") - parse("2024-02-28 00:00:00") == 2 * 86400 * kSecond);
+}
+
+TEST(parse_expiry_separators_and_fractions) {
+    const int64_t base = 1792398615 * kSecond;
+    CHECK(parse("2026-10-19T08:30:15") == base);
+    CHECK(parse("2026-10-19 08:30:15Z") == base);
+    CHECK(parse("2026-10-19T08:30:15Z") == base);
+    CHECK(parse("2026-10-19 08:30:15.5") == base + 500000);
+    CHECK(parse("2026-10-19 08:30:15.000001") == base + 1);
+    CHECK(parse("2026-10-19T08:30:15.123456Z") == base + 123456);
+    // Digits past the microsecond are truncated, not rounded.
+    CHECK(parse("2026-10-19 08:30:15.9999999") == base + 999999);
+
+    CHECK(parse("2026-10-19 08:30:15.") == INT64_MIN);
+    CHECK(parse("2026-10-19 08:30:15.5x") == INT64_MIN);
+    CHECK(parse("2026-10-19 08:30:15ZZ") == INT64_MIN);
+    CHECK(parse("2026-10-19X08:30:15") == INT64_MIN);
+    CHECK(parse("2026-10-19 08:30") == INT64_MIN);
+    CHECK(parse("2026-1a-19 08:30:15") == INT64_MIN);
+    CHECK(parse("") == INT64_MIN);
+}
+
+TEST(parse_expiry_field_ranges) {
+    // A leap second is the same instant as the next minute's first.
+    CHECK(parse("2016-12-31 23:59:60") == 1483228800 * kSecond);
+    CHECK(parse("2016-12-31 23:59:61") == INT64_MIN);
+    CHECK(parse("2026-10-19 24:00:00") == INT64_MIN);
+    CHECK(parse("2026-10-19 23:60:00") == INT64_MIN);
+    CHECK(parse("2026-13-01 00:00:00") == INT64_MIN);
+    CHECK(parse("2026-00-01 00:00:00") == INT64_MIN);
+    CHECK(parse("2026-04-31 00:00:00") == INT64_MIN);
+    CHECK(parse("2026-10-00 00:00:00") == INT64_MIN);
+}
+
+TEST(format_countdown_fields) {
+    CHECK(countdown(0) == "0d 00h 00m 00s");
+    CHECK(countdown(59) == "0d 00h 00m 59s");
+    CHECK(countdown(60) == "0d 00h 01m 00s");
+    CHECK(countdown(86399) == "0d 23h 59m 59s");
+    CHECK(countdown(86400) == "1d 00h 00m 00s");
+    CHECK(countdown(400 * 86400 + 3 * 3600 + 4 * 60 + 5) == "400d 03h 04m 05s");
+    CHECK(countdown(INT64_MAX).size() <= kMaxCountdownChars);
+}
+
+TEST(expiry_countdown_text_states) {
+    c_expiry_countdown countdown;
+    CHECK(std::string_view(countdown.text(0)) == "-");
+    CHECK(countdown.next_change_us(0) == c_expiry_countdown::kNever);
+
+    countdown.set("not a date");
+    CHECK(!countdown.valid());
+    CHECK(std::string_view(countdown.text(0)) == "not a date");
+    CHECK(countdown.next_change_us(0) == c_expiry_countdown::kNever);
+
+    countdown.set("1970-01-02 00:00:00");
+    CHECK(countdown.valid());
+    CHECK(std::string_view(countdown.text(0)) == "1d 00h 00m 00s");
+    CHECK(std::string_view(countdown.text(1)) == "0d 23h 59m 59s");
+    CHECK(std::string_view(countdown.text(86400 * kSecond)) == "Expired");
+    CHECK(countdown.next_change_us(86400 * kSecond) == c_expiry_countdown::kNever);
+
+    countdown.set("");
+    CHECK(std::string_view(countdown.text(0)) == "-");
+}
+
+// The text only changes at next_change_us, one microsecond past each whole second left,
+// and the last second runs to the deadline itself.
+TEST(expiry_countdown_next_change_at_the_second_boundary) {
+    c_expiry_countdown countdown;
+    countdown.set("1970-01-01 00:00:10.250000");
+    const int64_t expires = countdown.expires_us();
+    CHECK(expires == 10 * kSecond + 250000);
+
+    CHECK(countdown.next_change_us(0) == 250001);
+    CHECK(countdown.next_change_us(250000) == 250001);
+    CHECK(countdown.next_change_us(250001) == kSecond + 250001);
+    CHECK(countdown.next_change_us(expires - kSecond) == expires - kSecond + 1);
+    CHECK(countdown.next_change_us(expires - kSecond + 1) == expires);
+    CHECK(countdown.next_change_us(expires - 1) == expires);
+    CHECK(countdown.next_change_us(expires) == c_expiry_countdown::kNever);
+
+    // Walking the clock change by change shows every second exactly once.
+    std::vector<std::string> shown;
+    for (int64_t now = 0; now != c_expiry_countdown::kNever;) {
+        shown.push_back(countdown.text(now));
+        const int64_t next = countdown.next_change_us(now);
+        if (next != c_expiry_countdown::kNever)
+            CHECK(shown.back() == countdown.text(next - 1));
+        now = next;
+    }
+    CHECK(shown.size() == 12);
+    CHECK(shown.front() == "0d 00h 00m 10s");
+    CHECK(shown[10] == "0d 00h 00m 00s");
+    CHECK(shown.back() == "Expired");
+}
+
+// Cost of the countdowns: every text once per frame of a simulated 60 Hz clock.
+BENCH(expiry_countdown_bench) {
+    for (int subscriptions : { 100, 10000 }) {
+        // Spread over 2026-2027 so some have expired and some count down for months.
+        std::vector<std::string> timestamps(subscriptions);
+        for (int i = 0; i < subscriptions; i++) {
+            char text[32];
+            std::snprintf(text, sizeof(text), "%04d-%02d-%02d %02d:%02d:%02d.%06d",
+                2026 + i % 2, 1 + i % 12, 1 + i % 28, i % 24, i * 7 % 60, i * 13 % 60, i * 7919 % 1000000);
+            timestamps[i] = text;
+        }
+
+        std::vector<c_expiry_countdown> countdowns(subscriptions);
+        const auto parse_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < subscriptions; i++)
+            countdowns[i].set(timestamps[i]);
+        const double parse_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - parse_start).count() / subscriptions;
+
+        constexpr int kFrames = 600;
+        int64_t now_us = wall_clock_us();
+        size_t checksum = 0;
+        double total_us = 0.0, max_us = 0.0;
+        for (int frame = 0; frame < kFrames; frame++, now_us += 16667) {
+            const auto frame_start = std::chrono::steady_clock::now();
+            for (c_expiry_countdown& countdown : countdowns)
+                checksum += static_cast<unsigned char>(countdown.text(now_us)[0]);
+            const double frame_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - frame_start).count();
+            total_us += frame_us;
+            max_us = (std::max)(max_us, frame_us);
+        }
+        uint64_t renders = 0;
+        for (const c_expiry_countdown& countdown : countdowns)
+            renders += countdown.renders();
+        CHECK(checksum != 0);
+        std::printf("  %5d subscriptions: parse %.1f ns each, frame %.2f us avg / %.2f us max, %llu renders over %d frames\n",
+            subscriptions, parse_ns, total_us / kFrames, max_us, static_cast<unsigned long long>(renders), kFrames);
+    }
+}
@@ -0,0 +1,339 @@
+#include "test.h"
+#include "../core/filestream_session/filestream_session.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <system_error>
+
+namespace {
+    // Serves the ranges of its latest request in order, `piece_bytes` at a time, and drops
+    // the connection before a piece with probability `failure_rate`, discarding the rest of
+    // the request.
+    class c_fake_filestream_host {
+    public:
+        enum class event {
+            idle,
+            piece,
+            dropped
+        };
+
+        c_fake_filestream_host(uint64_t file_bytes, uint64_t piece_bytes, float failure_rate, uint32_t seed)
+            : file_bytes_(file_bytes), piece_bytes_(piece_bytes ? piece_bytes : 1), failure_rate_(failure_rate), state_(seed ? seed : 1) {}
+
+        void request(const std::vector<byte_range>& ranges) {
+            ranges_.clear();
+            for (const byte_range& range : ranges) {
+                if (range.offset >= file_bytes_)
+                    continue;
+                const uint64_t available = file_bytes_ - range.offset;
+                ranges_.push_back({ range.offset, range.length && range.length < available ? range.length : available });
+            }
+            next_ = 0;
+            sent_ = 0;
+        }
+
+        event step(byte_range& piece) {
+            if (next_ >= ranges_.size())
+                return event::idle;
+            if (random() < failure_rate_) {
+                ranges_.clear();
+                next_ = 0;
+                sent_ = 0;
+                return event::dropped;
+            }
+
+            const byte_range& range = ranges_[next_];
+            piece.offset = range.offset + sent_;
+            piece.length = (std::min)(piece_bytes_, range.length - sent_);
+            sent_ += piece.length;
+            if (sent_ == range.length) {
+                next_++;
+                sent_ = 0;
+            }
+            return event::piece;
+        }
+
+    private:
+        float random() {
+            // xorshift32
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 17;
+            state_ ^= state_ << 5;
+            return static_cast<float>(state_ >> 8) / static_cast<float>(1 << 24);
+        }
+
+        uint64_t file_bytes_;
+        uint64_t piece_bytes_;
+        float failure_rate_;
+        uint32_t state_;
+        std::vector<byte_range> ranges_;
+        size_t next_ = 0;
+        uint64_t sent_ = 0;                 // of ranges_[next_]
+    };
+
+    std::filesystem::path test_directory(const char* name) {
+        std::error_code error;
+        const std::filesystem::path directory = std::filesystem::temp_directory_path(error) / name;
+        std::filesystem::remove_all(directory, error);
+        return directory;
+    }
+
+    struct resume_result {
+        uint64_t pieces = 0;
+        uint64_t requested_bytes = 0;
+        // First request after each relaunch against the last saved checkpoint.
+        uint64_t redundant_bytes = 0;       // requested although the saved checkpoint held them
+        uint64_t unrequested_bytes = 0;     // missing from the saved checkpoint but not requested
+        int failures = 0;
+        int drains = 0;
+        int relaunches = 0;
+        int abandoned = 0;                  // sessions that ran out of retries and were started again
+        bool complete = false;
+        bool verified = false;              // the host's copy matches the source and the checkpoint is gone
+    };
+
+    // Downloads one file through a chunked session from the fake host, which drops
+    // `failure_rate` of its pieces' connections. Every `relaunch_every` pieces (0: never) the
+    // transport is dropped without stop(), as in a crash, and resumed from what was saved.
+    resume_result run_resume(uint64_t file_bytes, uint32_t chunk_bytes, float failure_rate, int relaunch_every) {
+        const std::filesystem::path directory = test_directory("loader_ui_resume_test");
+        resume_result result;
+
+        const std::string file_id = "resume-test";
+        auto source_byte = [](uint64_t offset) { return static_cast<uint8_t>((offset * 2654435761ull) >> 24); };
+        // The host's copy of the file; it survives relaunches like a partial file on disk.
+        std::vector<uint8_t> received(static_cast<size_t>(file_bytes), 0);
+        c_fake_filestream_host host(file_bytes, (std::max)(chunk_bytes / 4, 1u), failure_rate, 0x9e3779b9u);
+
+        std::unique_ptr<c_filestream_transport> transport;
+        std::unique_ptr<c_download_scheduler> scheduler;
+        download_state outcome = download_state::queued;
+        uint64_t now_us = 1;
+        // What the last save put on disk, recorded as it was written. The first request after
+        // a relaunch must ask for exactly the chunks this lacks.
+        c_chunk_checkpoint durable;
+        bool relaunched = false;
+
+        auto on_request = [&](const std::string&, const std::vector<byte_range>& ranges) {
+            std::vector<bool> requested;
+            if (relaunched && durable.known())
+                requested.assign(durable.chunk_count(), false);
+            for (const byte_range& range : ranges) {
+                const uint64_t end = range.length ? range.offset + range.length : file_bytes;
+                result.requested_bytes += end - range.offset;
+                for (uint64_t chunk = range.offset / chunk_bytes; chunk < requested.size() && chunk * chunk_bytes < end; chunk++) {
+                    requested[static_cast<size_t>(chunk)] = true;
+                    if (durable.has(static_cast<size_t>(chunk)))
+                        result.redundant_bytes += (std::min)(end, (chunk + 1) * chunk_bytes) - (std::max)(range.offset, chunk * chunk_bytes);
+                }
+            }
+            for (size_t chunk = 0; chunk < requested.size(); chunk++) {
+                if (!requested[chunk] && !durable.has(chunk))
+                    result.unrequested_bytes += (std::min)(file_bytes, (chunk + 1) * uint64_t{ chunk_bytes }) - chunk * uint64_t{ chunk_bytes };
+            }
+            relaunched = false;
+            host.request(ranges);
+        };
+
+        // A request the host finished with pieces still missing counts like a dropped connection.
+        auto retry = [&] {
+            if (transport->on_failure(file_id) > c_filestream_transport::kMaxRetries)
+                scheduler->finish(file_id, false);
+            else
+                transport->resume(file_id);
+        };
+
+        auto launch = [&] {
+            scheduler.reset();
+            transport = std::make_unique<c_filestream_transport>(on_request, chunk_bytes);
+            transport->set_directory(directory);
+            transport->set_saved_callback([&](const std::string&, const c_chunk_checkpoint& checkpoint) { durable = checkpoint; });
+            scheduler = std::make_unique<c_download_scheduler>(transport.get());
+            scheduler->set_finished_callback([&](const download_item& item) { outcome = item.state; });
+            scheduler->enqueue(file_id, file_id, 0);
+            scheduler->tick(now_us++);
+        };
+
+        launch();
+        const uint64_t max_steps = (file_bytes / (std::max)(chunk_bytes / 4, 1u) + 1) * 64 + 10000;
+        int since_relaunch = 0;
+        for (uint64_t step = 0; step < max_steps && outcome != download_state::done; step++) {
+            byte_range piece{};
+            const c_fake_filestream_host::event event = host.step(piece);
+            if (event == c_fake_filestream_host::event::piece) {
+                for (uint64_t offset = piece.offset; offset < piece.offset + piece.length; offset++)
+                    received[static_cast<size_t>(offset)] = source_byte(offset);
+                result.pieces++;
+                if (const c_chunk_checkpoint* checkpoint = transport->on_chunk(file_id, piece.offset, piece.length, file_bytes))
+                    scheduler->report(file_id, checkpoint->done_bytes(), checkpoint->file_bytes());
+                if (transport->drained(file_id)) {
+                    result.drains++;
+                    retry();
+                }
+            }
+            else if (event == c_fake_filestream_host::event::dropped) {
+                result.failures++;
+                retry();
+            }
+
+            scheduler->tick(now_us++);
+            if (outcome == download_state::done)
+                break;
+            if (outcome == download_state::failed) {
+                result.abandoned++;
+                outcome = download_state::queued;
+                scheduler->enqueue(file_id, file_id, 0);
+                scheduler->tick(now_us++);
+            }
+            else if (event == c_fake_filestream_host::event::idle) {
+                break;      // served every request without completing the file
+            }
+            if (relaunch_every && ++since_relaunch >= relaunch_every) {
+                since_relaunch = 0;
+                result.relaunches++;
+                relaunched = true;
+                launch();
+            }
+        }
+
+        std::error_code error;
+        result.complete = outcome == download_state::done;
+        result.verified = result.complete && !std::filesystem::exists(transport->checkpoint_path(file_id), error);
+        for (uint64_t offset = 0; result.verified && offset < file_bytes; offset++)
+            result.verified = received[static_cast<size_t>(offset)] == source_byte(offset);
+
+        scheduler.reset();
+        transport.reset();
+        std::filesystem::remove_all(directory, error);
+        return result;
+    }
+}
+
+// Pieces split across chunk borders, shuffled and repeated, still add up to the file.
+TEST(chunk_checkpoint_marks_pieces_in_any_order) {
+    std::mt19937 rng(1);
+    for (int iteration = 0; iteration < 500; iteration++) {
+        const uint64_t file_bytes = 1 + rng() % 5000;
+        const uint32_t chunk_bytes = 1 + rng() % 700;
+        c_chunk_checkpoint checkpoint;
+        checkpoint.reset(file_bytes, chunk_bytes);
+
+        std::vector<byte_range> pieces;
+        for (uint64_t offset = 0; offset < file_bytes;) {
+            const uint64_t length = (std::min)(uint64_t{ 1 + rng() % 300 }, file_bytes - offset);
+            pieces.push_back({ offset, length });
+            offset += length;
+        }
+        std::shuffle(pieces.begin(), pieces.end(), rng);
+        for (int i = 0; i < 5; i++)
+            pieces.push_back(pieces[rng() % pieces.size()]);
+
+        uint64_t previous = 0;
+        for (const byte_range& piece : pieces) {
+            checkpoint.mark(piece.offset, piece.length);
+            CHECK(checkpoint.done_bytes() >= previous && checkpoint.done_bytes() <= file_bytes);
+            previous = checkpoint.done_bytes();
+        }
+        CHECK(checkpoint.complete());
+        CHECK(checkpoint.done_bytes() == file_bytes);
+    }
+}
+
+TEST(chunk_checkpoint_round_trip) {
+    const std::filesystem::path directory = test_directory("loader_ui_checkpoint_test");
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path path = directory / "file.ckpt";
+
+    c_chunk_checkpoint saved;
+    saved.reset(1050, 100);
+    saved.mark(0, 300);
+    saved.mark(500, 100);
+    saved.mark(1000, 50);
+    CHECK(saved.save(path, "file"));
+
+    c_chunk_checkpoint loaded;
+    CHECK(!loaded.load(path, "other"));
+    CHECK(loaded.load(path, "file"));
+    CHECK(loaded.file_bytes() == 1050 && loaded.chunk_bytes() == 100);
+    for (size_t chunk = 0; chunk < saved.chunk_count(); chunk++)
+        CHECK(loaded.has(chunk) == saved.has(chunk));
+
+    std::vector<byte_range> missing;
+    loaded.missing(missing);
+    CHECK(missing.size() == 2);
+    CHECK(missing[0].offset == 300 && missing[0].length == 200);
+    CHECK(missing[1].offset == 600 && missing[1].length == 400);
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+}
+
+// A request the host finished with a piece lost on the way is reported, and the retry asks
+// for just the gap.
+TEST(filestream_drained_request_asks_again) {
+    std::vector<std::vector<byte_range>> requests;
+    c_filestream_transport transport([&](const std::string&, const std::vector<byte_range>& ranges) { requests.push_back(ranges); }, 100);
+    download_item item;
+    item.file_id = "file";
+    transport.start(item);
+    CHECK(requests.size() == 1);
+
+    transport.on_chunk("file", 0, 50, 1000);
+    CHECK(!transport.drained("file"));
+    transport.on_chunk("file", 100, 900, 1000);
+    CHECK(transport.drained("file"));
+
+    CHECK(transport.on_failure("file") == 1);
+    CHECK(!transport.drained("file"));
+    CHECK(transport.resume("file"));
+    CHECK(requests.back().size() == 1);
+    CHECK(requests.back()[0].offset == 50 && requests.back()[0].length == 50);
+
+    const c_chunk_checkpoint* checkpoint = transport.on_chunk("file", 50, 50, 1000);
+    CHECK(checkpoint && checkpoint->complete());
+    CHECK(!transport.drained("file"));
+}
+
+// Crashes between saves lose only unsaved progress: every resume asks for exactly what the
+// last save lacked, and the file arrives intact.
+TEST(filestream_resumes_after_crashes) {
+    struct scenario {
+        uint64_t file_bytes;
+        uint32_t chunk_bytes;
+        float failure_rate;
+        int relaunch_every;
+    };
+    static constexpr scenario kScenarios[] = {
+        { 200137, 1000, 0.f, 0 },
+        { 200137, 4096, 0.f, 0 },
+        { 200137, 1000, 0.f, 300 },
+        { 200137, 1000, 0.05f, 7 },
+        { 200137, 4096, 0.05f, 40 },
+        { 200137, 1000, 0.2f, 200 },
+        { 200137, 4096, 0.2f, 7 },
+        { 200137, 1000, 0.5f, 40 },
+        { 1, 1, 0.2f, 0 },
+    };
+    for (const scenario& s : kScenarios) {
+        const resume_result result = run_resume(s.file_bytes, s.chunk_bytes, s.failure_rate, s.relaunch_every);
+        CHECK(result.complete);
+        CHECK(result.verified);
+        CHECK(result.redundant_bytes == 0);
+        CHECK(result.unrequested_bytes == 0);
+        if (s.relaunch_every)
+            CHECK(result.relaunches > 0);
+    }
+}
+
+BENCH(filestream_resume_bench) {
+    for (float failure_rate : { 0.05f, 0.2f, 0.5f }) {
+        for (int relaunch_every : { 0, 40, 200 }) {
+            const resume_result result = run_resume(16ull << 20, 256 * 1024, failure_rate, relaunch_every);
+            std::printf("  failure %.2f relaunch %3d: %llu pieces, %llu bytes requested, %d drops, %d relaunches, %d abandoned%s\n",
+                failure_rate, relaunch_every, static_cast<unsigned long long>(result.pieces),
+                static_cast<unsigned long long>(result.requested_bytes), result.failures, result.relaunches, result.abandoned,
+                result.verified ? "" : ", INCOMPLETE");
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#include "headless_ui.h"
+#include "../core/dep/imgui/imgui_internal.h"
+#include <string>
+
+ui_config c_headless_ui::default_config() {
+    ui_config config;
+    config.headless = true;
+    config.software_render = true;
+    return config;
+}
+
+c_headless_ui::c_headless_ui(const ui_config& config) {
+    ready_ = ui_.initialize(config);
+}
+
+c_headless_ui::~c_headless_ui() {
+    ui_.shutdown();
+}
+
+void c_headless_ui::sign_in(int products) {
+    subscriptions_.clear();
+    profile_ = user_profile{};
+    profile_.username = "test";
+    for (int i = 0; i < products; i++) {
+        auto subscription = std::make_unique<user_subscription>();
+        subscription->plan = "Product " + std::to_string(i);
+        subscription->plan_id = "plan-" + std::to_string(i);
+        subscription->default_file_id = "file-" + std::to_string(i);
+        subscription->status = i % 3 ? "Active" : "Expiring";
+        subscription->expires_at = "2030-01-01 00:00:00";
+        profile_.subscriptions.push_back(subscription.get());
+        subscriptions_.push_back(std::move(subscription));
+    }
+    ui_.set_authenticated(true, &profile_);
+}
+
+void c_headless_ui::frame(int count) {
+    for (int i = 0; i < count; i++) {
+        ui_.update();
+        ui_.render();
+    }
+}
+
+void c_headless_ui::press(ImGuiKey key) {
+    ui_.queue_key_input(key, true);
+    frame();
+    ui_.queue_key_input(key, false);
+    frame();
+}
+
+void c_headless_ui::type(const char* utf8) {
+    ui_.queue_text_input(utf8);
+    frame();
+}
+
+// Item ids as the render functions push them: the window, then for product rows the
+// "product_list" table and the row's source index, for login items the "##body" child.
+void c_headless_ui::click_main_button(const char* label) {
+    const ImGuiID window = ImHashStr(ui_.config.application_name);
+    ImGui::ActivateItemByID(ImGui::GetIDWithSeed(label, nullptr, window));
+}
+
+void c_headless_ui::select_product(int index) {
+    const ImGuiID window = ImHashStr(ui_.config.application_name);
+    const ImGuiID table = ImGui::GetIDWithSeed("product_list", nullptr, window);
+    const std::string plan = "Product " + std::to_string(index);
+    ImGui::ActivateItemByID(ImGui::GetIDWithSeed(plan.c_str(), nullptr, ImGui::GetIDWithSeed(index, table)));
+}
+
+void c_headless_ui::click_login_item(const char* label) {
+    static constexpr const char* kLoginWindow = "Bootstrapper##login window";
+    char body[128];
+    ImFormatString(body, sizeof(body), "%s/%s_%08X", kLoginWindow, "##body", ImGui::GetIDWithSeed("##body", nullptr, ImHashStr(kLoginWindow)));
+    ImGui::ActivateItemByID(ImGui::GetIDWithSeed(label, nullptr, ImHashStr(body)));
+}
@@ -0,0 +1,49 @@
+#ifndef LOADER_UI_TEST_HEADLESS_UI_HPP
+#define LOADER_UI_TEST_HEADLESS_UI_HPP
+
+#include "../core/loader_ui/loader_ui.h"
+#include "../core/dep/imgui/imgui.h"
+#include <memory>
+#include <vector>
+
+// A headless c_loader_ui of its own for tests that drive the whole UI. The library keeps
+// one ImGui context per process, so only one may exist at a time; it is shut down with
+// the harness. Frames run back to back: there is no idle wait in headless mode.
+class c_headless_ui {
+public:
+    // Software rendering, every frame rasterized.
+    static ui_config default_config();
+
+    explicit c_headless_ui(const ui_config& config = default_config());
+    ~c_headless_ui();
+
+    c_headless_ui(const c_headless_ui&) = delete;
+    c_headless_ui& operator=(const c_headless_ui&) = delete;
+
+    bool ready() const { return ready_; }
+    c_loader_ui& ui() { return ui_; }
+
+    // Signs in with `products` subscriptions named "Product 0", "Product 1", ...
+    void sign_in(int products);
+    void frame(int count = 1);
+    // Key down in one frame, up in the next. Input goes through c_loader_ui's queue, so it
+    // counts for input latency.
+    void press(ImGuiKey key);
+    // One frame with the text typed.
+    void type(const char* utf8);
+    // Clicks the main window's button `label`, or the row of product `index`, on the next
+    // frame the main window is drawn.
+    void click_main_button(const char* label);
+    void select_product(int index);
+    // Clicks the login window's field or button `label` on the next frame. A field takes
+    // keyboard focus with its whole text selected.
+    void click_login_item(const char* label);
+
+private:
+    c_loader_ui ui_;
+    bool ready_ = false;
+    user_profile profile_;
+    std::vector<std::unique_ptr<user_subscription>> subscriptions_;
+};
+
+#endif // LOADER_UI_TEST_HEADLESS_UI_HPP
@@ -0,0 +1,196 @@
+#include "test.h"
+#include "headless_ui.h"
+#include "../core/allocator/allocator.h"
+#include "../core/dep/imgui/imgui_internal.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace {
+    constexpr int kWarmupFrames = 10;
+
+    // Mean update() + render() of `frames` frames after a warm-up, in milliseconds.
+    double measure_ms(c_headless_ui& harness, int frames) {
+        harness.frame(kWarmupFrames);
+        const auto start = std::chrono::steady_clock::now();
+        harness.frame(frames);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+    }
+
+    // Heap allocations of `frames` steady frames of the current screen: ImGui requests the
+    // allocator had to pass to the general heap and, in tracking builds, operator new calls.
+    uint64_t steady_heap_allocations(c_headless_ui& harness, int frames) {
+        harness.frame(kWarmupFrames);
+        uint64_t allocations = 0;
+        ui_stats stats;
+        for (int i = 0; i < frames; i++) {
+            harness.frame();
+            if (harness.ui().get_stats(stats))
+                allocations += stats.heap_allocations_per_frame;
+        }
+        // get_stats allocates, so operator new is counted over frames of their own.
+        const uint64_t operator_new_before = c_allocation_tracker::allocation_count();
+        harness.frame(frames);
+        return allocations + c_allocation_tracker::allocation_count() - operator_new_before;
+    }
+
+    // Selects the first product and presses Load; with queue_launches the download
+    // finishes as soon as it starts, which raises the completion popup.
+    void launch_first_product(c_headless_ui& harness) {
+        harness.frame();
+        harness.select_product(0);
+        harness.frame();
+        harness.click_main_button("Load");
+        harness.frame(3);
+    }
+
+    // Clicks a login field and deletes its text, leaving it focused for typing. The key
+    // press also keeps the cached body live on the frame the click lands. The buffers are
+    // static, so tests clear what they typed.
+    void clear_login_field(c_headless_ui& harness, const char* label) {
+        harness.click_login_item(label);
+        harness.press(ImGuiKey_Delete);
+    }
+}
+
+TEST(headless_software_frame_has_pixels) {
+    c_headless_ui harness;
+    CHECK(harness.ready());
+    harness.frame(2);
+
+    const uint32_t* pixels = nullptr;
+    int width = 0, height = 0;
+    CHECK(harness.ui().get_framebuffer(&pixels, &width, &height));
+    CHECK(pixels != nullptr && width > 0 && height > 0);
+    if (!pixels || width <= 0 || height <= 0)
+        return;
+    bool drawn = false;
+    for (int i = 1; i < width * height && !drawn; i++)
+        drawn = pixels[i] != pixels[0];
+    CHECK(drawn);
+}
+
+TEST(headless_display_size_comes_from_the_config) {
+    ui_config config = c_headless_ui::default_config();
+    config.display_width = 640;
+    config.display_height = 480;
+    c_headless_ui harness(config);
+    CHECK(harness.ready());
+    harness.frame();
+
+    int width = 0, height = 0;
+    CHECK(harness.ui().get_framebuffer(nullptr, &width, &height));
+    CHECK(width == 640 && height == 480);
+}
+
+TEST(queued_launch_raises_the_completion_popup) {
+    ui_config config = c_headless_ui::default_config();
+    config.queue_launches = true;
+    c_headless_ui harness(config);
+    CHECK(harness.ready());
+    harness.sign_in(4);
+    CHECK(ImGui::GetTopMostPopupModal() == nullptr);
+
+    launch_first_product(harness);
+    CHECK(harness.ui().state.error_message.empty());
+    CHECK(ImGui::GetTopMostPopupModal() != nullptr);
+}
+
+TEST(login_fields_take_typed_input) {
+    c_headless_ui harness;
+    CHECK(harness.ready());
+    std::string username, password;
+    harness.ui().set_login_callback([&](const std::string& user, const std::string& pass) {
+        username = user;
+        password = pass;
+    });
+    harness.ui().show_login();
+    harness.frame(3);
+
+    clear_login_field(harness, "##username");
+    harness.type("ab");
+    clear_login_field(harness, "##password");
+    harness.type("cd");
+    // The password field stays active, which keeps the body live for the button.
+    harness.click_login_item("Login");
+    harness.frame(2);
+    CHECK(username == "ab");
+    CHECK(password == "cd");
+
+    clear_login_field(harness, "##username");
+    clear_login_field(harness, "##password");
+}
+
+// Once warm, no screen reaches the general heap. The download screen has one running
+// item with progress and one queued behind it.
+TEST(steady_frames_stay_off_the_heap) {
+    constexpr int kFrames = 120;
+    ui_config config = c_headless_ui::default_config();
+    config.queue_launches = true;
+    config.report_downloads = true;
+    c_headless_ui harness(config);
+    CHECK(harness.ready());
+    if (!harness.ready())
+        return;
+
+    harness.ui().show_login();
+    CHECK(steady_heap_allocations(harness, kFrames) == 0);
+    harness.ui().show_register();
+    CHECK(steady_heap_allocations(harness, kFrames) == 0);
+    harness.sign_in(8);
+    CHECK(steady_heap_allocations(harness, kFrames) == 0);
+
+    for (int product = 0; product < 2; product++) {
+        harness.select_product(product);
+        harness.frame();
+        harness.click_main_button("Load");
+        harness.frame();
+    }
+    harness.ui().set_download_progress("file-0", 512 * 1024, 1024 * 1024);
+    CHECK(steady_heap_allocations(harness, kFrames) == 0);
+}
+
+// CPU cost of whole frames of the login, main and popup screens through the software renderer.
+BENCH(render_screens_bench) {
+    constexpr int kFrames = 200;
+    ui_config config = c_headless_ui::default_config();
+    config.queue_launches = true;
+    c_headless_ui harness(config);
+    CHECK(harness.ready());
+    if (!harness.ready())
+        return;
+
+    harness.ui().show_login();
+    const double login_ms = measure_ms(harness, kFrames);
+    harness.sign_in(32);
+    const double main_ms = measure_ms(harness, kFrames);
+    launch_first_product(harness);
+    CHECK(ImGui::GetTopMostPopupModal() != nullptr);
+    const double popup_ms = measure_ms(harness, kFrames);
+
+    std::printf("  login %.3f ms, main %.3f ms, popup %.3f ms per frame over %d frames\n", login_ms, main_ms, popup_ms, kFrames);
+}
+
+// Key-to-present latency of characters typed into the focused username field.
+BENCH(input_latency_bench) {
+    constexpr int kKeys = 200;
+    c_headless_ui harness;
+    CHECK(harness.ready());
+    if (!harness.ready())
+        return;
+
+    harness.ui().show_login();
+    harness.frame(3);
+    clear_login_field(harness, "##username");
+    harness.ui().reset_input_latency();
+    for (int i = 0; i < kKeys; i++)
+        harness.type("a");
+
+    input_latency_stats stats;
+    CHECK(harness.ui().get_input_latency(stats));
+    CHECK(stats.samples >= kKeys);
+    std::printf("  %llu samples: mean %.3f ms, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+        static_cast<unsigned long long>(stats.samples), stats.mean_ms, stats.p50_ms, stats.p90_ms, stats.p99_ms, stats.max_ms);
+    clear_login_field(harness, "##username");
+}
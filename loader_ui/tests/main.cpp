@@ -0,0 +1,62 @@
+#include "test.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+    struct test_case {
+        const char* name;
+        test_fn fn;
+        bool bench;
+    };
+
+    std::vector<test_case>& registry() {
+        static std::vector<test_case> tests;
+        return tests;
+    }
+
+    int failures = 0;
+}
+
+bool register_test(const char* name, test_fn fn, bool bench) {
+    registry().push_back({ name, fn, bench });
+    return true;
+}
+
+void report_failure(const char* file, int line, const char* expression) {
+    std::fprintf(stderr, "%s(%d): CHECK(%s) failed\n", file, line, expression);
+    failures++;
+}
+
+// loader_ui_tests [--bench] [name...]: runs the tests, and the benchmarks with --bench,
+// whose name contains one of the arguments, or all of them.
+int main(int argc, char** argv) {
+    bool benches = false;
+    std::vector<const char*> filters;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--bench") == 0)
+            benches = true;
+        else
+            filters.push_back(argv[i]);
+    }
+
+    int ran = 0;
+    for (const test_case& test : registry()) {
+        if (test.bench && !benches)
+            continue;
+        bool selected = filters.empty();
+        for (const char* filter : filters)
+            selected = selected || std::strstr(test.name, filter) != nullptr;
+        if (!selected)
+            continue;
+
+        const int before = failures;
+        std::printf("[ RUN  ] %s\n", test.name);
+        test.fn();
+        std::printf("[ %s ] %s\n", failures == before ? " OK " : "FAIL", test.name);
+        ran++;
+    }
+
+    std::printf("%d run, %d failed checks\n", ran, failures);
+    return failures ? 1 : 0;
+}
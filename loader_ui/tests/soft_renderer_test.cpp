@@ -0,0 +1,12 @@
+#include "test.h"
+#include "../core/soft_renderer/soft_renderer.h"
+#include <cstdint>
+
+// The SSE2 coverage loop must cover exactly the pixels the scalar one does, edges included.
+TEST(soft_renderer_sse2_coverage_matches_scalar) {
+    uint64_t pixels = 0;
+    CHECK(c_soft_renderer::coverage_mismatches(20000, &pixels) == 0);
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    CHECK(pixels > 0);
+#endif
+}
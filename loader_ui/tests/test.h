@@ -0,0 +1,28 @@
+#ifndef LOADER_UI_TEST_HPP
+#define LOADER_UI_TEST_HPP
+
+// Self-registering tests and benchmarks for loader_ui_tests. Every TEST runs by default;
+// BENCH bodies only run with --bench and print their figures. CHECK records a failure
+// and carries on so one run reports every broken expectation.
+using test_fn = void (*)();
+
+bool register_test(const char* name, test_fn fn, bool bench);
+void report_failure(const char* file, int line, const char* expression);
+
+#define TEST(name)                                                                  \
+    static void name();                                                             \
+    static const bool name##_registered = register_test(#name, name, false);        \
+    static void name()
+
+#define BENCH(name)                                                                 \
+    static void name();                                                             \
+    static const bool name##_registered = register_test(#name, name, true);         \
+    static void name()
+
+#define CHECK(expression)                                                           \
+    do {                                                                            \
+        if (!(expression))                                                          \
+            report_failure(__FILE__, __LINE__, #expression);                        \
+    } while (0)
+
+#endif // LOADER_UI_TEST_HPP
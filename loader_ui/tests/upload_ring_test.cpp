@@ -0,0 +1,91 @@
+#include "test.h"
+#include "../core/upload_ring/upload_ring.h"
+#include <cstdint>
+
+namespace {
+    // Reserves `count` elements and checks the placement rules every reservation follows.
+    upload_reservation place(c_upload_ring& ring, size_t count) {
+        const size_t capacity = ring.capacity();
+        const size_t head = ring.head();
+        const upload_reservation reservation = ring.reserve(count);
+        CHECK(reservation.offset + count <= ring.capacity());
+        if (reservation.mode == upload_map_mode::no_overwrite)
+            CHECK(reservation.offset == head && !reservation.reallocate);
+        else
+            CHECK(reservation.offset == 0);
+        if (count > capacity)
+            CHECK(reservation.reallocate && ring.capacity() >= count + count / 2);
+        return reservation;
+    }
+}
+
+// Mostly small draw lists with the occasional very large one.
+TEST(upload_ring_random_placements) {
+    c_upload_ring ring;
+    uint32_t state = 0x9E3779B9u;
+    auto next = [&] {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    };
+    for (int frame = 0; frame < 10000; frame++) {
+        ring.begin_frame();
+        const uint32_t lists = 1 + next() % 8;
+        for (uint32_t i = 0; i < lists; i++)
+            place(ring, next() % 64 == 0 ? 20000 + next() % 60000 : 1 + next() % 3000);
+    }
+    CHECK(ring.stats().wraps > 0);
+    CHECK(ring.stats().grows > 0);
+}
+
+TEST(upload_ring_appends_until_the_tail) {
+    c_upload_ring ring;
+    ring.begin_frame();
+    CHECK(place(ring, 1000).mode == upload_map_mode::discard);
+    const upload_reservation second = place(ring, 1000);
+    CHECK(second.mode == upload_map_mode::no_overwrite && second.offset == 1000);
+    const upload_reservation wrapped = place(ring, c_upload_ring::kMinCapacity - 1000);
+    CHECK(wrapped.mode == upload_map_mode::discard && !wrapped.reallocate);
+    CHECK(ring.stats().wraps == 1);
+}
+
+// The same frame over and over reallocates only while warming up.
+TEST(upload_ring_steady_workload_never_reallocates) {
+    static constexpr size_t kLists[] = { 3000, 1200, 5000 };
+    c_upload_ring ring;
+    for (int frame = 0; frame < 1000; frame++) {
+        ring.begin_frame();
+        for (size_t count : kLists) {
+            if (place(ring, count).reallocate)
+                CHECK(frame == 0);
+        }
+    }
+    CHECK(ring.stats().shrinks == 0);
+}
+
+// After a spike the buffer shrinks on the first reservation after kShrinkFrames light
+// frames, not before, and keeps room for twice the light frames' peak.
+TEST(upload_ring_shrinks_after_hysteresis) {
+    c_upload_ring ring;
+    ring.begin_frame();
+    place(ring, 200000);
+    for (size_t frame = 0; frame <= c_upload_ring::kShrinkFrames; frame++) {
+        ring.begin_frame();
+        place(ring, 1000);
+        if (frame < c_upload_ring::kShrinkFrames)
+            CHECK(ring.stats().shrinks == 0);
+    }
+    CHECK(ring.stats().shrinks == 1);
+    CHECK(ring.capacity() >= 2000);
+}
+
+TEST(upload_ring_invalidate_discards) {
+    c_upload_ring ring;
+    ring.begin_frame();
+    place(ring, 100);
+    place(ring, 100);
+    ring.invalidate();
+    const upload_reservation reservation = place(ring, 100);
+    CHECK(reservation.mode == upload_map_mode::discard && reservation.offset == 0);
+}